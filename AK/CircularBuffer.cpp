@@ -255,6 +255,37 @@ ErrorOr<size_t> CircularBuffer::copy_from_seekback(size_t distance, size_t lengt
     if (distance > m_seekback_limit)
         return Error::from_string_literal("Tried a seekback copy beyond the seekback limit");
 
+    // Short copies (like the back-references of LZ-style decompressors) are dominated by the overhead of the span juggling below.
+    // If neither the source nor the destination wrap around, copy them in place instead.
+    static constexpr size_t max_in_place_copy_length = 1 * KiB;
+    auto write_offset = (m_reading_head + m_used_space) % capacity();
+    auto read_offset = (capacity() + write_offset - distance) % capacity();
+    if (length <= max_in_place_copy_length && length <= empty_space() && read_offset < write_offset && write_offset + length <= capacity()) {
+        auto* destination = m_buffer.data() + write_offset;
+        auto const* source = destination - distance;
+
+        // The source and destination overlap whenever the distance is shorter than the length. The data then repeats every
+        // `distance` bytes, so once enough of it has been written we can copy whole words from a multiple of the distance back.
+        auto stride = distance;
+        while (stride < sizeof(u64))
+            stride *= 2;
+
+        size_t i = 0;
+        for (; i < stride - distance && i < length; ++i)
+            destination[i] = source[i];
+        for (; i + sizeof(u64) <= length; i += sizeof(u64)) {
+            u64 word;
+            __builtin_memcpy(&word, destination + i - stride, sizeof(word));
+            __builtin_memcpy(destination + i, &word, sizeof(word));
+        }
+        for (; i < length; ++i)
+            destination[i] = source[i];
+
+        m_used_space += length;
+        m_seekback_limit = min(m_seekback_limit + length, capacity());
+        return length;
+    }
+
     auto remaining_length = length;
     while (remaining_length > 0) {
         if (empty_space() == 0)
@@ -210,6 +210,16 @@ bool CommandLine::is_nvme_polling_enabled() const
     return contains("nvme_poll"sv);
 }
 
+UNMAP_AFTER_INIT u16 CommandLine::nvme_interrupt_coalescing_threshold() const
+{
+    auto const value = lookup("nvme_interrupt_coalescing"sv).value_or("0"sv);
+    auto threshold = value.to_number<u16>();
+    // The controller can wait for up to 256 completions before raising an interrupt.
+    if (threshold.has_value() && threshold.value() <= 256)
+        return threshold.value();
+    PANIC("Invalid NVMe interrupt coalescing threshold: {}", value);
+}
+
 UNMAP_AFTER_INIT AcpiFeatureLevel CommandLine::acpi_feature_level() const
 {
     auto value = kernel_command_line().lookup("acpi"sv).value_or("limited"sv);
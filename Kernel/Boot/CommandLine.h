@@ -101,6 +101,7 @@ public:
     [[nodiscard]] Vector<NonnullOwnPtr<KString>> userspace_init_args() const;
     [[nodiscard]] StringView root_device() const;
     [[nodiscard]] bool is_nvme_polling_enabled() const;
+    [[nodiscard]] u16 nvme_interrupt_coalescing_threshold() const;
     [[nodiscard]] size_t switch_to_tty() const;
 
 private:
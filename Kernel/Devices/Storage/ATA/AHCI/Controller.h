@@ -35,6 +35,7 @@ public:
     virtual ErrorOr<void> shutdown() override;
     virtual size_t devices_count() const override;
     virtual void start_request(ATADevice const&, AsyncBlockDeviceRequest&) override;
+    virtual size_t max_transfer_size() const override { return AHCI::max_transfer_pages * PAGE_SIZE; }
     virtual void complete_current_request(AsyncDeviceRequest::RequestResult) override;
 
     void handle_interrupt_for_port(Badge<AHCIInterruptHandler>, u32 port_index) const;
@@ -127,6 +127,9 @@ struct [[gnu::packed]] DMASetup {
 
 namespace Kernel::AHCI {
 
+// Every port has this many pages to DMA into, each described by one entry in the command table.
+static constexpr size_t max_transfer_pages = 32;
+
 class MaskedBitField {
 
 public:
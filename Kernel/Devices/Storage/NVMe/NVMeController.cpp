@@ -64,15 +64,62 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", IO_QUEUE_SIZE);
 
     TRY(identify_and_init_controller());
-    // Create an IO queue per core
+    // Create an IO queue per core, if the controller lets us have that many
+    nr_of_queues = request_io_queue_count(nr_of_queues);
     for (u32 cpuid = 0; cpuid < nr_of_queues; ++cpuid) {
         // qid is zero is used for admin queue
         TRY(create_io_queue(cpuid + 1, queue_type));
     }
+    if (queue_type == QueueType::IRQ)
+        configure_interrupt_coalescing();
     TRY(identify_and_init_namespaces());
     return {};
 }
 
+ErrorOr<u32> NVMeController::set_feature(FeatureIdentifier feature, u32 value)
+{
+    NVMeSubmission sub {};
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.generic.cdw10 = AK::convert_between_host_and_little_endian(static_cast<u32>(feature));
+    sub.generic.cdw11 = AK::convert_between_host_and_little_endian(value);
+    u32 result = 0;
+    if (auto status = m_admin_queue->submit_sync_sqe(sub, &result); status != 0) {
+        dbgln_if(NVME_DEBUG, "NVMe: Setting feature {:#x} to {:#x} failed with status {:#x}", static_cast<u32>(feature), value, status);
+        return EIO;
+    }
+    return result;
+}
+
+UNMAP_AFTER_INIT u32 NVMeController::request_io_queue_count(u32 count)
+{
+    // Both counts are 0 based, and the controller may allocate fewer queues than we ask for.
+    auto result = set_feature(FEATURE_NUMBER_OF_QUEUES, (count - 1) | ((count - 1) << 16));
+    if (result.is_error()) {
+        dmesgln_pci(*this, "Failed to request {} IO queues, assuming they are available", count);
+        return count;
+    }
+    u32 submission_queue_count = (result.value() & 0xffff) + 1;
+    u32 completion_queue_count = (result.value() >> 16) + 1;
+    auto io_queue_count = min(count, min(submission_queue_count, completion_queue_count));
+    dbgln_if(NVME_DEBUG, "NVMe: Using {} IO queues for {} processors", io_queue_count, count);
+    return io_queue_count;
+}
+
+UNMAP_AFTER_INIT void NVMeController::configure_interrupt_coalescing()
+{
+    auto threshold = kernel_command_line().nvme_interrupt_coalescing_threshold();
+    if (threshold <= 1)
+        return;
+    // The threshold is 0 based. Wait at most 100us for more completions to show up before raising the interrupt anyway,
+    // so a lone request doesn't take much longer.
+    u32 value = (threshold - 1) | (1 << INTERRUPT_COALESCING_TIME_SHIFT);
+    if (set_feature(FEATURE_INTERRUPT_COALESCING, value).is_error()) {
+        dmesgln_pci(*this, "Failed to enable interrupt coalescing");
+        return;
+    }
+    dmesgln_pci(*this, "Raising an interrupt for every {} completions", threshold);
+}
+
 bool NVMeController::wait_for_ready(bool expected_ready_bit_value)
 {
     constexpr size_t one_ms_io_delay = 1000;
@@ -181,6 +228,16 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
             return EFAULT;
         }
     }
+    // Namespaces share the IO queues, so they have to share the buffers of the queues as well.
+    // If there are more namespaces than buffers, requests wait in the queues until a buffer is free.
+    size_t namespace_count = 0;
+    for (auto nsid : active_namespace_list) {
+        if (nsid == 0)
+            break;
+        ++namespace_count;
+    }
+    size_t max_requests_in_flight = max<size_t>(m_queues.size() * IO_QUEUE_MAX_REQUESTS_IN_FLIGHT / max<size_t>(namespace_count, 1), 1);
+
     // Get the NAMESPACE attributes
     {
         NVMeSubmission sub {};
@@ -210,7 +267,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size)));
+            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size, max_requests_in_flight)));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
@@ -246,6 +303,12 @@ ErrorOr<void> NVMeController::identify_and_init_controller()
         }
     }
 
+    // NOTE: We always use the minimum memory page size of 4 KiB, and a MDTS of 0 means there is no limit.
+    m_max_transfer_size = IO_MAX_TRANSFER_PAGES * PAGE_SIZE;
+    if (ctrl.mdts != 0 && ctrl.mdts < 16)
+        m_max_transfer_size = min(m_max_transfer_size, static_cast<size_t>(PAGE_SIZE) << ctrl.mdts);
+    dbgln_if(NVME_DEBUG, "NVMe: Maximum transfer size is {} bytes", m_max_transfer_size);
+
     if (ctrl.oacs & ID_CTRL_SHADOW_DBBUF_MASK) {
         OwnPtr<Memory::Region> dbbuf_dma_region;
         OwnPtr<Memory::Region> eventidx_dma_region;
@@ -359,7 +422,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_admin_queue(QueueType queu
         return maybe_error;
     }
     set_admin_queue_ready_flag();
-    m_admin_queue = TRY(NVMeQueue::try_create(*this, 0, irq, qdepth, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type));
+    m_admin_queue = TRY(NVMeQueue::try_create(*this, 0, irq, qdepth, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type, PAGE_SIZE, 1));
 
     dbgln_if(NVME_DEBUG, "NVMe: Admin queue created");
     return {};
@@ -433,7 +496,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType
 
     auto irq = TRY(allocate_irq(qid));
 
-    m_queues.append(TRY(NVMeQueue::try_create(*this, qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type)));
+    m_queues.append(TRY(NVMeQueue::try_create(*this, qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type, m_max_transfer_size, IO_QUEUE_MAX_REQUESTS_IN_FLIGHT)));
     dbgln_if(NVME_DEBUG, "NVMe: Created IO Queue with QID{}", m_queues.size());
     return {};
 }
@@ -40,6 +40,7 @@ public:
     ErrorOr<void> reset_controller();
     ErrorOr<void> start_controller();
     u32 get_admin_q_dept();
+    size_t max_transfer_size() const { return m_max_transfer_size; }
 
     u16 submit_admin_command(NVMeSubmission& sub, bool sync = false)
     {
@@ -62,6 +63,9 @@ private:
     Tuple<u64, u8> get_ns_features(IdentifyNamespace& identify_data_struct);
     ErrorOr<void> create_admin_queue(QueueType queue_type);
     ErrorOr<void> create_io_queue(u8 qid, QueueType queue_type);
+    ErrorOr<u32> set_feature(FeatureIdentifier, u32 value);
+    u32 request_io_queue_count(u32 count);
+    void configure_interrupt_coalescing();
     void calculate_doorbell_stride()
     {
         m_dbl_stride = (m_controller_regs->cap >> CAP_DBL_SHIFT) & CAP_DBL_MASK;
@@ -80,6 +84,7 @@ private:
     AK::Duration m_ready_timeout;
     PhysicalAddress m_bar { 0 };
     u8 m_dbl_stride { 0 };
+    size_t m_max_transfer_size { PAGE_SIZE };
     PCI::InterruptType m_irq_type;
     QueueType m_queue_type { QueueType::IRQ };
     static Atomic<u8> s_controller_id;
@@ -34,11 +34,13 @@ struct IdentifyNamespace {
     u64 rsvd3[488];
 };
 
-// FIXME: For now only one value is used. Once we start using
+// FIXME: For now only a few values are used. Once we start using
 // more values from id_ctrl command, use separate member variables
 // instead of using rsd array.
 struct IdentifyController {
-    u8 rsdv1[256];
+    u8 rsdv1[77];
+    u8 mdts; // Maximum data transfer size, as a power of two in units of the minimum memory page size
+    u8 rsdv1_1[178];
     u16 oacs;
     u8 rsdv2[3838];
 };
@@ -107,6 +109,10 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 }
 
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// Transfers larger than two pages need a PRP list, which has to fit into a single page.
+static constexpr size_t IO_MAX_TRANSFER_PAGES = 32;
+// Every IO queue has this many DMA buffers, so this is how many requests it can work on at once.
+static constexpr size_t IO_QUEUE_MAX_REQUESTS_IN_FLIGHT = 8;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
@@ -124,9 +130,18 @@ enum AdminCommandOpCode {
     OP_ADMIN_CREATE_COMPLETION_QUEUE = 0x5,
     OP_ADMIN_CREATE_SUBMISSION_QUEUE = 0x1,
     OP_ADMIN_IDENTIFY = 0x6,
+    OP_ADMIN_SET_FEATURES = 0x9,
     OP_ADMIN_DBBUF_CONFIG = 0x7C,
 };
 
+// SET FEATURES
+enum FeatureIdentifier {
+    FEATURE_NUMBER_OF_QUEUES = 0x7,
+    FEATURE_INTERRUPT_COALESCING = 0x8,
+};
+// The aggregation time is given in 100 microsecond increments.
+static constexpr u32 INTERRUPT_COALESCING_TIME_SHIFT = 8;
+
 // IO opcodes
 enum IOCommandOpcode {
     OP_NVME_WRITE = 0x1,
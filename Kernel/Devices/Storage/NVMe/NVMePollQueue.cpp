@@ -8,25 +8,57 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeDefinitions.h>
 #include <Kernel/Devices/Storage/NVMe/NVMePollQueue.h>
+#include <Kernel/Tasks/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
-ErrorOr<NonnullLockRefPtr<NVMePollQueue>> NVMePollQueue::try_create(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalPage> rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+ErrorOr<NonnullLockRefPtr<NVMePollQueue>> NVMePollQueue::try_create(Vector<NVMeIOBuffer> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
 {
-    return TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    return TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(io_buffers), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
 }
 
-UNMAP_AFTER_INIT NVMePollQueue::NVMePollQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalPage> rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
+UNMAP_AFTER_INIT NVMePollQueue::NVMePollQueue(Vector<NVMeIOBuffer> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : NVMeQueue(move(io_buffers), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
 {
 }
 
 void NVMePollQueue::submit_sqe(NVMeSubmission& sub)
 {
     NVMeQueue::submit_sqe(sub);
-    SpinlockLocker lock_cq(m_cq_lock);
-    while (!process_cq()) {
-        microseconds_delay(1);
+
+    // NOTE: Completing a command may submit the next one, which then finds us still polling and returns right away.
+    while (!m_polling.exchange(true, AK::memory_order_acquire)) {
+        poll_until_idle();
+        m_polling.store(false, AK::memory_order_release);
+        // Someone may have submitted a command after our last look, and left it to us since we were still polling.
+        if (requests_in_flight() == 0)
+            break;
+    }
+}
+
+void NVMePollQueue::poll_until_idle()
+{
+    auto poll_start = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+
+    // Hybrid polling: If the device is slow enough that we can sleep through half of the time it usually
+    // takes, give the processor to someone else for that long instead of spinning.
+    auto tick_in_nanoseconds = 1'000'000'000 / TimeManagement::the().ticks_per_second();
+    auto sleep_time_in_nanoseconds = m_average_completion_time_in_nanoseconds / 2;
+    if (sleep_time_in_nanoseconds >= tick_in_nanoseconds && !Processor::in_critical() && !Processor::current_in_irq())
+        (void)Thread::current()->sleep(Duration::from_nanoseconds(sleep_time_in_nanoseconds));
+
+    bool saw_first_completion = false;
+    while (requests_in_flight() > 0) {
+        if (process_cq() == 0) {
+            microseconds_delay(1);
+            continue;
+        }
+        if (!saw_first_completion) {
+            saw_first_completion = true;
+            auto completion_time = (TimeManagement::the().monotonic_time(TimePrecision::Precise) - poll_start).to_nanoseconds();
+            m_average_completion_time_in_nanoseconds = (7 * m_average_completion_time_in_nanoseconds + completion_time) / 8;
+        }
     }
 }
 
@@ -12,34 +12,39 @@
 #include <Kernel/Library/StdLib.h>
 
 namespace Kernel {
-ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
+ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type, size_t max_transfer_size, size_t io_buffer_count)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
-
-    if (rw_dma_page.is_null())
-        return ENOMEM;
+    // Note: Allocate DMA regions for RW operations, one for each request that may be in flight at the same time.
+    // The storage device splits requests so they never exceed max_transfer_size, and there's an extra page at the end for the PRP list.
+    VERIFY(max_transfer_size % PAGE_SIZE == 0);
+    VERIFY(max_transfer_size / PAGE_SIZE <= IO_MAX_TRANSFER_PAGES);
+    VERIFY(io_buffer_count > 0 && io_buffer_count < 32 && io_buffer_count < q_depth);
+    Vector<NVMeIOBuffer> io_buffers;
+    TRY(io_buffers.try_ensure_capacity(io_buffer_count));
+    for (size_t i = 0; i < io_buffer_count; ++i) {
+        Vector<NonnullRefPtr<Memory::PhysicalPage>> pages;
+        auto region = TRY(MM.allocate_dma_buffer_pages(max_transfer_size + PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, pages));
+        io_buffers.unchecked_append({ move(region), move(pages) });
+    }
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(io_buffers), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(io_buffers), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : m_rw_dma_region(move(rw_dma_region))
-    , m_qid(qid)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(Vector<NVMeIOBuffer> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : m_qid(qid)
     , m_admin_queue(qid == 0)
     , m_qdepth(q_depth)
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
-
+    , m_io_buffers(move(io_buffers))
+    , m_free_io_buffers((1u << m_io_buffers.size()) - 1)
 {
     m_requests.with([q_depth](auto& requests) {
         requests.try_ensure_capacity(q_depth).release_value_but_fixme_should_propagate_errors();
@@ -48,6 +53,54 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     m_cqe_array = { reinterpret_cast<NVMeCompletion*>(m_cq_dma_region->vaddr().as_ptr()), m_qdepth };
 }
 
+Optional<size_t> NVMeQueue::try_reserve_io_buffer()
+{
+    u32 free_io_buffers = m_free_io_buffers.load(AK::memory_order_acquire);
+    while (free_io_buffers != 0) {
+        size_t index = count_trailing_zeroes(free_io_buffers);
+        if (m_free_io_buffers.compare_exchange_strong(free_io_buffers, free_io_buffers & ~(1u << index), AK::memory_order_acq_rel))
+            return index;
+    }
+    return {};
+}
+
+void NVMeQueue::release_io_buffer(size_t index)
+{
+    VERIFY(index < m_io_buffers.size());
+    m_free_io_buffers.fetch_or(1u << index, AK::memory_order_release);
+}
+
+u16 NVMeQueue::register_request(NVMeIO io)
+{
+    return m_requests.with([&](auto& requests) {
+        // Requests can complete in any order, so the next command identifier might still be in use.
+        u16 cid = get_request_cid();
+        while (requests.contains(cid))
+            cid = get_request_cid();
+        requests.set(cid, move(io));
+        return cid;
+    });
+}
+
+void NVMeQueue::fill_data_pointer(DataPtr& data_ptr, NVMeIOBuffer const& io_buffer, size_t transfer_size)
+{
+    auto& pages = io_buffer.pages;
+    size_t page_count = ceil_div(transfer_size, static_cast<size_t>(PAGE_SIZE));
+    VERIFY(page_count > 0 && page_count < pages.size());
+
+    data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[0]->paddr().as_ptr()));
+    if (page_count == 2) {
+        data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[1]->paddr().as_ptr()));
+    } else if (page_count > 2) {
+        // PRP2 points to a list with the addresses of all the pages after the first one.
+        size_t prp_list_offset = (pages.size() - 1) * PAGE_SIZE;
+        auto* prp_list = reinterpret_cast<u64*>(io_buffer.region->vaddr().offset(prp_list_offset).as_ptr());
+        for (size_t i = 1; i < page_count; ++i)
+            prp_list[i - 1] = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[i]->paddr().as_ptr()));
+        data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages.last()->paddr().as_ptr()));
+    }
+}
+
 bool NVMeQueue::cqe_available()
 {
     return PHASE_TAG(m_cqe_array[m_cq_head].status) == m_cq_valid_phase;
@@ -77,10 +130,12 @@ u32 NVMeQueue::process_cq()
             cmdid = m_cqe_array[m_cq_head].command_id;
             dbgln_if(NVME_DEBUG, "NVMe: Completion with status {:x} and command identifier {}. CQ_HEAD: {}", status, cmdid, m_cq_head);
 
-            if (!requests.contains(cmdid)) {
+            auto request = requests.get(cmdid);
+            if (!request.has_value()) {
                 dmesgln("Bogus cmd id: {}", cmdid);
                 VERIFY_NOT_REACHED();
             }
+            request->result = m_cqe_array[m_cq_head].cmd_spec;
             complete_current_request(cmdid, status);
             update_cqe_head();
         }
@@ -115,12 +170,15 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
         auto current_request = request_pdu.request;
         AsyncDeviceRequest::RequestResult req_result = AsyncDeviceRequest::Success;
 
-        ScopeGuard guard = [&req_result, status, &request_pdu] {
+        ScopeGuard guard = [this, &requests, cmdid, &req_result, status, &request_pdu] {
+            // Give the buffer back first, completing the request might start the next one right away.
+            if (request_pdu.io_buffer_index.has_value())
+                release_io_buffer(*request_pdu.io_buffer_index);
             if (request_pdu.request)
                 request_pdu.request->complete(req_result);
             if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
-            request_pdu.clear();
+                request_pdu.end_io_handler(status, request_pdu.result);
+            requests.remove(cmdid);
         };
 
         // There can be submission without any request associated with it such as with
@@ -134,24 +192,27 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
         }
 
         if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-            if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
+            auto& io_buffer = m_io_buffers[*request_pdu.io_buffer_index];
+            if (auto result = current_request->write_to_buffer(current_request->buffer(), io_buffer.region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
                 req_result = AsyncBlockDeviceRequest::MemoryFault;
                 return;
             }
         }
     });
+    submit_requests_waiting_for_io_buffer();
 }
 
-u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
+u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub, u32* result)
 {
-    // For now let's use sq tail as a unique command id.
     u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    });
+    NVMeIO io;
+    io.end_io_handler = [this, &cmd_status, result](u16 status, u32 command_result) mutable {
+        cmd_status = status;
+        if (result)
+            *result = command_result;
+        m_sync_wait_queue.wake_all();
+    };
+    sub.cmdid = register_request(move(io));
     submit_sqe(sub);
 
     // FIXME: Only sync submissions (usually used for admin commands) use a WaitQueue based IO. Eventually we need to
@@ -160,44 +221,80 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return cmd_status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+ErrorOr<void> NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
 {
-    NVMeSubmission sub {};
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
+    VERIFY(request.request_type() == AsyncBlockDeviceRequest::Read);
+    auto io_buffer_index = try_reserve_io_buffer();
+    if (!io_buffer_index.has_value())
+        return EBUSY;
+    submit_io(request, nsid, index, count, *io_buffer_index);
+    return {};
+}
+
+ErrorOr<void> NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+{
+    VERIFY(request.request_type() == AsyncBlockDeviceRequest::Write);
+    auto io_buffer_index = try_reserve_io_buffer();
+    if (!io_buffer_index.has_value())
+        return EBUSY;
+    submit_io(request, nsid, index, count, *io_buffer_index);
+    return {};
+}
 
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
+void NVMeQueue::submit_when_io_buffer_is_free(AsyncBlockDeviceRequest& request, u16 nsid)
+{
+    Optional<size_t> io_buffer_index;
+    bool out_of_memory = false;
+    m_requests_waiting_for_io_buffer.with([&](auto& waiting_requests) {
+        io_buffer_index = try_reserve_io_buffer();
+        if (!io_buffer_index.has_value())
+            out_of_memory = waiting_requests.try_append({ request, nsid }).is_error();
     });
 
-    full_memory_barrier();
-    submit_sqe(sub);
+    if (out_of_memory) {
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+    if (io_buffer_index.has_value())
+        submit_io(request, nsid, request.block_index(), request.block_count(), *io_buffer_index);
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_requests_waiting_for_io_buffer()
 {
-    NVMeSubmission sub {};
+    for (;;) {
+        Optional<NVMeIOWaitingForBuffer> waiting_request;
+        Optional<size_t> io_buffer_index;
+        m_requests_waiting_for_io_buffer.with([&](auto& waiting_requests) {
+            if (waiting_requests.is_empty())
+                return;
+            io_buffer_index = try_reserve_io_buffer();
+            if (io_buffer_index.has_value())
+                waiting_request = waiting_requests.take_first();
+        });
+        if (!waiting_request.has_value())
+            return;
+        auto& request = *waiting_request->request;
+        submit_io(request, waiting_request->nsid, request.block_index(), request.block_count(), *io_buffer_index);
+    }
+}
 
-    sub.op = OP_NVME_WRITE;
+void NVMeQueue::submit_io(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count, size_t io_buffer_index)
+{
+    NVMeSubmission sub {};
+    sub.op = request.request_type() == AsyncBlockDeviceRequest::Read ? OP_NVME_READ : OP_NVME_WRITE;
     sub.rw.nsid = nsid;
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
+    auto& io_buffer = m_io_buffers[io_buffer_index];
+    fill_data_pointer(sub.rw.data_ptr, io_buffer, request.buffer_size());
+    sub.cmdid = register_request({ .request = request, .io_buffer_index = io_buffer_index });
 
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
-
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
-        return;
+    if (request.request_type() == AsyncBlockDeviceRequest::Write) {
+        if (auto result = request.read_from_buffer(request.buffer(), io_buffer.region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
+            complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
+            return;
+        }
     }
 
     full_memory_barrier();
@@ -40,23 +40,30 @@ enum class QueueType {
 class AsyncBlockDeviceRequest;
 
 struct NVMeIO {
-    void clear()
-    {
-        request = nullptr;
-        end_io_handler = nullptr;
-    }
     RefPtr<AsyncBlockDeviceRequest> request;
-    Function<void(u16 status)> end_io_handler;
+    Function<void(u16 status, u32 result)> end_io_handler;
+    Optional<size_t> io_buffer_index;
+    // The command specific dword of the completion queue entry.
+    u32 result { 0 };
+};
+
+struct NVMeIOBuffer {
+    NonnullOwnPtr<Memory::Region> region;
+    // NOTE: The last page doesn't hold data, it holds the PRP list for transfers spanning more than two pages.
+    Vector<NonnullRefPtr<Memory::PhysicalPage>> pages;
 };
 
 class NVMeController;
 class NVMeQueue : public AtomicRefCounted<NVMeQueue> {
 public:
-    static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
+    static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type, size_t max_transfer_size, size_t io_buffer_count);
     bool is_admin_queue() { return m_admin_queue; }
-    u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    u16 submit_sync_sqe(NVMeSubmission&, u32* result = nullptr);
+    // These fail with EBUSY if all the DMA buffers of this queue are in use.
+    ErrorOr<void> read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    ErrorOr<void> write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    // Submits the request as soon as one of the DMA buffers of this queue is free, which may be right away.
+    void submit_when_io_buffer_is_free(AsyncBlockDeviceRequest&, u16 nsid);
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
@@ -83,7 +90,7 @@ protected:
             m_db_regs.mmio_reg->sq_tail = m_sq_tail;
     }
 
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeQueue(Vector<NVMeIOBuffer> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
     [[nodiscard]] u32 get_request_cid()
     {
@@ -100,8 +107,21 @@ protected:
 
     virtual void complete_current_request(u16 cmdid, u16 status);
 
+    size_t requests_in_flight() const
+    {
+        return m_requests.with([](auto& requests) { return requests.size(); });
+    }
+
+    void release_io_buffer(size_t index);
+    // Must be called after releasing a buffer, without holding the m_requests lock.
+    void submit_requests_waiting_for_io_buffer();
+
 private:
     bool cqe_available();
+    u16 register_request(NVMeIO);
+    Optional<size_t> try_reserve_io_buffer();
+    void submit_io(AsyncBlockDeviceRequest&, u16 nsid, u64 index, u32 count, size_t io_buffer_index);
+    void fill_data_pointer(DataPtr&, NVMeIOBuffer const&, size_t transfer_size);
     void update_cqe_head();
     void update_cq_doorbell()
     {
@@ -113,7 +133,6 @@ private:
 
 protected:
     SpinlockProtected<HashMap<u16, NVMeIO>, LockRank::None> m_requests;
-    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
 
 private:
     u16 m_qid {};
@@ -130,6 +149,16 @@ private:
     Span<NVMeCompletion> m_cqe_array;
     WaitQueue m_sync_wait_queue;
     Doorbell m_db_regs;
-    NonnullRefPtr<Memory::PhysicalPage const> const m_rw_dma_page;
+    Vector<NVMeIOBuffer> const m_io_buffers;
+    // One bit per entry in m_io_buffers, set while that buffer is free.
+    Atomic<u32> m_free_io_buffers { 0 };
+
+    struct NVMeIOWaitingForBuffer {
+        NonnullRefPtr<AsyncBlockDeviceRequest> request;
+        u16 nsid { 0 };
+    };
+    // NOTE: A request is only added here after checking for a free buffer with this lock held,
+    //       and buffers are freed before the list is looked at, so no request can be forgotten.
+    SpinlockProtected<Vector<NVMeIOWaitingForBuffer>, LockRank::None> m_requests_waiting_for_io_buffer {};
 };
 }
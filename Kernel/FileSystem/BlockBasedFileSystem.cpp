@@ -4,145 +4,146 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/SyncTask.h>
 
 namespace Kernel {
 
-struct CacheEntry {
-    IntrusiveListNode<CacheEntry> list_node;
-    BlockBasedFileSystem::BlockIndex block_index { 0 };
-    u8* data { nullptr };
-    bool has_data { false };
-};
-
-class DiskCache {
-public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
-    {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
-    }
-
-    ~DiskCache() = default;
-
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
+    : FileBackedFileSystem(file_description)
+{
+    VERIFY(file_description.file().is_seekable());
+}
 
-    void mark_all_clean()
-    {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-    }
+BlockBasedFileSystem::~BlockBasedFileSystem() = default;
 
-    void mark_dirty(CacheEntry& entry)
-    {
-        m_dirty_list.prepend(entry);
-    }
+void BlockBasedFileSystem::remove_cached_pages_before_last_unmount()
+{
+    VERIFY(m_lock.is_locked());
+    if (auto result = flush_writes_impl(); result.is_error())
+        dmesgln("{}: Failed to write back cached pages before unmounting: {}", class_name(), result.error());
+    PageCache::the().remove_all_from(m_cached_pages, 0);
+}
 
-    void mark_clean(CacheEntry& entry)
-    {
-        m_clean_list.prepend(entry);
-    }
+ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(!is_initialized_while_locked());
+    VERIFY(logical_block_size() != 0);
+    return {};
+}
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
-    {
-        auto it = m_hash.find(block_index);
-        if (it == m_hash.end())
-            return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
-        }
-        return &entry;
+template<typename Callback>
+ErrorOr<void> BlockBasedFileSystem::for_each_page_in_block(BlockIndex index, u64 offset, size_t count, Callback callback) const
+{
+    // NOTE: Blocks may be smaller or larger than a page, so a range within a block may cover several pages.
+    u64 device_offset = index.value() * logical_block_size() + offset;
+    size_t offset_in_range = 0;
+    while (offset_in_range < count) {
+        u64 page_index = device_offset / PAGE_SIZE;
+        size_t offset_in_page = device_offset % PAGE_SIZE;
+        size_t chunk_size = min(count - offset_in_range, PAGE_SIZE - offset_in_page);
+        TRY(callback(page_index, offset_in_page, chunk_size, offset_in_range));
+        device_offset += chunk_size;
+        offset_in_range += chunk_size;
     }
+    return {};
+}
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
-    {
-        if (auto* entry = get(block_index))
-            return entry;
-
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
-        }
-
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
-
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+ErrorOr<Optional<CachedPageReference>> BlockBasedFileSystem::cached_device_page(u64 page_index) const
+{
+    if (auto page = PageCache::the().find(m_cached_pages, page_index); page.has_value())
+        return page.release_value();
+
+    auto page_buffer = TRY(ByteBuffer::create_uninitialized(PAGE_SIZE));
+    auto page_data_buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer.data());
+    auto nread_or_error = file_description().read(page_data_buffer, page_index * PAGE_SIZE, PAGE_SIZE);
+    // NOTE: The last page of the device may be cut short. Blocks in there are simply read and written without caching.
+    if (nread_or_error.is_error() || nread_or_error.value() != PAGE_SIZE)
+        return Optional<CachedPageReference> {};
+    return TRY(PageCache::the().add(m_cached_pages, page_index, page_buffer.bytes()));
+}
 
-        return &new_entry;
+ErrorOr<void> BlockBasedFileSystem::read_device_pages_into_cache(u64 first_page_index, size_t page_count, Bytes buffer) const
+{
+    VERIFY(m_cache_lock.is_locked());
+    VERIFY(buffer.size() >= page_count * PAGE_SIZE);
+    size_t length = page_count * PAGE_SIZE;
+    size_t nread = 0;
+    while (nread < length) {
+        auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.offset_pointer(nread));
+        auto nread_now = TRY(file_description().read(chunk_buffer, first_page_index * PAGE_SIZE + nread, length - nread));
+        if (nread_now == 0)
+            break;
+        nread += nread_now;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // NOTE: Like in cached_device_page(), a page cut short by the end of the device isn't cached.
+    for (size_t i = 0; i < nread / PAGE_SIZE; ++i)
+        TRY(PageCache::the().add(m_cached_pages, first_page_index + i, buffer.slice(i * PAGE_SIZE, PAGE_SIZE)));
+    return {};
+}
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
-    {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+ErrorOr<void> BlockBasedFileSystem::read_uncached_pages_locked(BlockIndex index, size_t count, Bytes buffer) const
+{
+    VERIFY(m_cache_lock.is_locked());
+    u64 first_page_index = index.value() * logical_block_size() / PAGE_SIZE;
+    u64 end_page_index = ceil_div((index.value() + count) * logical_block_size(), static_cast<u64>(PAGE_SIZE));
+    size_t max_pages_per_run = buffer.size() / PAGE_SIZE;
+    VERIFY(max_pages_per_run > 0);
+
+    u64 page_index = first_page_index;
+    while (page_index < end_page_index) {
+        if (PageCache::the().contains(m_cached_pages, page_index)) {
+            ++page_index;
+            continue;
+        }
+        u64 run_end = page_index + 1;
+        while (run_end < end_page_index && run_end - page_index < max_pages_per_run && !PageCache::the().contains(m_cached_pages, run_end))
+            ++run_end;
+        TRY(read_device_pages_into_cache(page_index, run_end - page_index, buffer));
+        page_index = run_end;
     }
+    return {};
+}
 
-private:
-    mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
-};
-
-BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
-    : FileBackedFileSystem(file_description)
+ErrorOr<void> BlockBasedFileSystem::read_device_range(u64 offset, UserOrKernelBuffer& buffer, size_t length) const
 {
-    VERIFY(file_description.file().is_seekable());
+    // NOTE: The device may split large requests, so we may have to ask several times.
+    size_t nread = 0;
+    while (nread < length) {
+        auto chunk_buffer = buffer.offset(nread);
+        auto nread_now = TRY(file_description().read(chunk_buffer, offset + nread, length - nread));
+        if (nread_now == 0)
+            return EIO;
+        nread += nread_now;
+    }
+    return {};
 }
 
-BlockBasedFileSystem::~BlockBasedFileSystem() = default;
-
-void BlockBasedFileSystem::remove_disk_cache_before_last_unmount()
+ErrorOr<void> BlockBasedFileSystem::write_device_range(u64 offset, UserOrKernelBuffer const& buffer, size_t length)
 {
-    VERIFY(m_lock.is_locked());
-    m_cache.with_exclusive([&](auto& cache) {
-        cache.clear();
-    });
+    size_t nwritten = 0;
+    while (nwritten < length) {
+        auto nwritten_now = TRY(file_description().write(offset + nwritten, buffer.offset(nwritten), length - nwritten));
+        if (nwritten_now == 0)
+            return EIO;
+        nwritten += nwritten_now;
+    }
+    return {};
 }
 
-ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
+ErrorOr<void> BlockBasedFileSystem::write_back_cached_page(CachedPageReference const& page, Bytes page_buffer)
 {
-    VERIFY(m_lock.is_locked());
-    VERIFY(!is_initialized_while_locked());
-    VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
-
-    m_cache.with_exclusive([&](auto& cache) {
-        cache = move(disk_cache);
-    });
+    VERIFY(m_cache_lock.is_exclusively_locked_by_current_thread());
+    VERIFY(page_buffer.size() == PAGE_SIZE);
+    auto page_data_buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer.data());
+    TRY(page.read(0, page_data_buffer, PAGE_SIZE));
+    TRY(write_device_range(page.page_index * PAGE_SIZE, page_data_buffer, PAGE_SIZE));
+    PageCache::the().mark_clean(m_cached_pages, page.page_index);
     return {};
 }
 
@@ -159,26 +160,50 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * logical_block_size() + offset;
-            auto nwritten = TRY(file_description().write(base_offset, data, count));
-            VERIFY(nwritten == count);
+    MutexLocker locker(m_cache_lock);
+    return write_locked(index, offset, buffered_data.bytes(), allow_cache);
+}
+
+ErrorOr<void> BlockBasedFileSystem::write_locked(BlockIndex index, u64 offset, ReadonlyBytes data, bool allow_cache)
+{
+    VERIFY(m_cache_lock.is_exclusively_locked_by_current_thread());
+    if (!allow_cache) {
+        TRY(flush_specific_blocks_if_needed(index, ceil_div(offset + data.size(), logical_block_size())));
+        u64 base_offset = index.value() * logical_block_size() + offset;
+        TRY(write_device_range(base_offset, UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data.data())), data.size()));
+        // Keep any cached copy of these blocks up to date.
+        return for_each_page_in_block(index, offset, data.size(), [&](u64 page_index, size_t offset_in_page, size_t chunk_size, size_t offset_in_range) -> ErrorOr<void> {
+            PageCache::the().write(m_cached_pages, page_index, offset_in_page, data.slice(offset_in_range, chunk_size), PageCache::MarkDirty::No);
             return {};
-        }
+        });
+    }
 
-        auto entry = TRY(cache->ensure(index));
-        if (count < logical_block_size()) {
-            // Fill the cache first.
-            TRY(read_block(index, nullptr, logical_block_size()));
+    TRY(for_each_page_in_block(index, offset, data.size(), [&](u64 page_index, size_t offset_in_page, size_t chunk_size, size_t offset_in_range) -> ErrorOr<void> {
+        auto chunk = data.slice(offset_in_range, chunk_size);
+        if (PageCache::the().write(m_cached_pages, page_index, offset_in_page, chunk, PageCache::MarkDirty::Yes))
+            return {};
+
+        if (chunk_size == PAGE_SIZE) {
+            // There is no need to read a page from the disk that we're about to overwrite completely.
+            TRY(PageCache::the().add(m_cached_pages, page_index, chunk, PageCache::MarkDirty::Yes));
+            return {};
         }
-        memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
-        entry->has_data = true;
+        auto page = TRY(cached_device_page(page_index));
+        if (!page.has_value())
+            return write_device_range(page_index * PAGE_SIZE + offset_in_page, UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(chunk.data())), chunk_size);
+        PageCache::the().write(m_cached_pages, page_index, offset_in_page, chunk, PageCache::MarkDirty::Yes);
         return {};
-    });
+    }));
+
+    auto dirty_page_count = m_cached_pages.dirty_page_count();
+    if (dirty_page_count >= max_dirty_pages) {
+        // This write made it into the cache, so a failure to write back (older) pages is reported to the next fsync instead.
+        (void)flush_writes_impl();
+    }
+    else if (dirty_page_count >= write_behind_threshold)
+        SyncTask::wake();
+    return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
@@ -199,32 +224,26 @@ ErrorOr<void> BlockBasedFileSystem::raw_write(BlockIndex index, UserOrKernelBuff
 
 ErrorOr<void> BlockBasedFileSystem::raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_read(BlockIndex { block }, current));
-        current = current.offset(device_block_size());
-    }
-    return {};
+    return read_device_range(index.value() * device_block_size(), buffer, count * device_block_size());
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_write(block, current));
-        current = current.offset(device_block_size());
-    }
-    return {};
+    return write_device_range(index.value() * device_block_size(), buffer, count * device_block_size());
 }
 
 ErrorOr<void> BlockBasedFileSystem::write_blocks(BlockIndex index, unsigned count, UserOrKernelBuffer const& data, bool allow_cache)
 {
     VERIFY(m_device_block_size);
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::write_blocks {}, count={}", index, count);
-    for (unsigned i = 0; i < count; ++i) {
-        TRY(write_block(BlockIndex { index.value() + i }, data.offset(i * logical_block_size()), logical_block_size(), 0, allow_cache));
-    }
-    return {};
+    if (count == 1)
+        return write_block(index, data, logical_block_size(), 0, allow_cache);
+
+    auto buffered_data = TRY(ByteBuffer::create_uninitialized(count * logical_block_size()));
+    TRY(data.read(buffered_data.bytes()));
+
+    MutexLocker locker(m_cache_lock);
+    return write_locked(index, 0, buffered_data.bytes(), allow_cache);
 }
 
 ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuffer* buffer, size_t count, u64 offset, bool allow_cache) const
@@ -233,26 +252,35 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * logical_block_size() + offset;
-            auto nread = TRY(file_description().read(*buffer, base_offset, count));
-            VERIFY(nread == count);
-            return {};
+    if (!allow_cache) {
+        {
+            MutexLocker locker(m_cache_lock);
+            TRY(const_cast<BlockBasedFileSystem*>(this)->flush_specific_blocks_if_needed(index, 1));
         }
+        u64 base_offset = index.value() * logical_block_size() + offset;
+        auto nread = TRY(file_description().read(*buffer, base_offset, count));
+        VERIFY(nread == count);
+        return {};
+    }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
-            VERIFY(nread == logical_block_size());
-            entry->has_data = true;
+    MutexLocker locker(m_cache_lock, Mutex::Mode::Shared);
+    return read_through_cache_locked(index, offset, count, buffer);
+}
+
+ErrorOr<void> BlockBasedFileSystem::read_through_cache_locked(BlockIndex index, u64 offset, size_t count, UserOrKernelBuffer* buffer) const
+{
+    VERIFY(m_cache_lock.is_locked());
+    return for_each_page_in_block(index, offset, count, [&](u64 page_index, size_t offset_in_page, size_t chunk_size, size_t offset_in_range) -> ErrorOr<void> {
+        auto page = TRY(cached_device_page(page_index));
+        if (!buffer)
+            return {};
+        auto chunk_buffer = buffer->offset(offset_in_range);
+        if (!page.has_value()) {
+            auto nread = TRY(file_description().read(chunk_buffer, page_index * PAGE_SIZE + offset_in_page, chunk_size));
+            VERIFY(nread == chunk_size);
+            return {};
         }
-        if (buffer)
-            TRY(buffer->write(entry->data + offset, count));
-        return {};
+        return page->read(offset_in_page, chunk_buffer, chunk_size);
     });
 }
 
@@ -263,52 +291,96 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, logical_block_size(), 0, allow_cache);
-    auto out = buffer;
-    for (unsigned i = 0; i < count; ++i) {
-        TRY(read_block(BlockIndex { index.value() + i }, &out, logical_block_size(), 0, allow_cache));
-        out = out.offset(logical_block_size());
+
+    size_t length = count * logical_block_size();
+    if (!allow_cache) {
+        // NOTE: Don't hold the lock while we wait for the device, so uncached reads can be in flight at the same time.
+        {
+            MutexLocker locker(m_cache_lock);
+            TRY(const_cast<BlockBasedFileSystem*>(this)->flush_specific_blocks_if_needed(index, count));
+        }
+        return read_device_range(index.value() * logical_block_size(), buffer, length);
     }
 
-    return {};
+    // Bring in everything that isn't cached yet with a few large requests, instead of one request per page.
+    auto run_buffer = TRY(ByteBuffer::create_uninitialized(min(ceil_div(length, static_cast<size_t>(PAGE_SIZE)) + 1, max_pages_per_request) * PAGE_SIZE));
+    MutexLocker locker(m_cache_lock, Mutex::Mode::Shared);
+    TRY(read_uncached_pages_locked(index, count, run_buffer.bytes()));
+    return read_through_cache_locked(index, 0, length, &buffer);
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+ErrorOr<void> BlockBasedFileSystem::flush_specific_blocks_if_needed(BlockIndex index, size_t count)
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
-            return;
-        size_t base_offset = entry->block_index.value() * logical_block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+    VERIFY(m_cache_lock.is_exclusively_locked_by_current_thread());
+    if (m_cached_pages.dirty_page_count() == 0)
+        return {};
+    u8 page_buffer[PAGE_SIZE];
+    return for_each_page_in_block(index, 0, count * logical_block_size(), [&](u64 page_index, size_t, size_t, size_t) -> ErrorOr<void> {
+        if (!PageCache::the().is_dirty(m_cached_pages, page_index))
+            return {};
+        if (auto page = PageCache::the().find(m_cached_pages, page_index); page.has_value())
+            TRY(write_back_cached_page(*page, { page_buffer, PAGE_SIZE }));
+        return {};
     });
 }
 
-void BlockBasedFileSystem::flush_writes_impl()
+ErrorOr<void> BlockBasedFileSystem::flush_writes_impl()
 {
-    size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
-    });
+    MutexLocker locker(m_cache_lock);
+    if (m_cached_pages.dirty_page_count() == 0)
+        return {};
+
+    Vector<CachedPageReference> dirty_pages;
+    TRY(dirty_pages.try_ensure_capacity(m_cached_pages.dirty_page_count()));
+    auto run_buffer = TRY(ByteBuffer::create_uninitialized(max_pages_per_request * PAGE_SIZE));
+
+    // Write the pages back in disk order, coalescing neighbours into large requests.
+    PageCache::the().collect_dirty_pages(m_cached_pages, dirty_pages);
+    quick_sort(dirty_pages, [](auto& a, auto& b) { return a.page_index < b.page_index; });
+
+    // Pages that fail to be written back stay dirty. We still try the remaining runs, and report the first error.
+    Optional<Error> first_error;
+    size_t written_page_count = 0;
+    size_t run_count = 0;
+    for (size_t run_start = 0; run_start < dirty_pages.size();) {
+        size_t run_length = 1;
+        while (run_start + run_length < dirty_pages.size()
+            && run_length < max_pages_per_request
+            && dirty_pages[run_start + run_length].page_index == dirty_pages[run_start].page_index + run_length)
+            ++run_length;
+
+        auto first_page_index = dirty_pages[run_start].page_index;
+        auto result = [&]() -> ErrorOr<void> {
+            for (size_t i = 0; i < run_length; ++i) {
+                auto page_buffer = UserOrKernelBuffer::for_kernel_buffer(run_buffer.offset_pointer(i * PAGE_SIZE));
+                TRY(dirty_pages[run_start + i].read(0, page_buffer, PAGE_SIZE));
+            }
+            return write_device_range(first_page_index * PAGE_SIZE, UserOrKernelBuffer::for_kernel_buffer(run_buffer.data()), run_length * PAGE_SIZE);
+        }();
+        if (result.is_error()) {
+            dmesgln("{}: Failed to write back {} pages at page {}: {}", class_name(), run_length, first_page_index, result.error());
+            if (!first_error.has_value())
+                first_error = result.release_error();
+        } else {
+            for (size_t i = 0; i < run_length; ++i)
+                PageCache::the().mark_clean(m_cached_pages, first_page_index + i);
+            written_page_count += run_length;
+        }
+
+        run_start += run_length;
+        ++run_count;
+    }
+    PageCache::the().did_write_back_pages(written_page_count);
+    dbgln("{}: Flushed {} of {} pages to disk in {} requests", class_name(), written_page_count, dirty_pages.size(), run_count);
+
+    if (first_error.has_value())
+        return first_error.release_value();
+    return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
 {
-    flush_writes_impl();
-    return {};
+    return flush_writes_impl();
 }
 
 }
@@ -7,7 +7,8 @@
 #pragma once
 
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
-#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/FileSystem/PageCache.h>
+#include <Kernel/Locking/Mutex.h>
 
 namespace Kernel {
 
@@ -19,8 +20,10 @@ public:
 
     u64 device_block_size() const { return m_device_block_size; }
 
+    virtual bool supports_page_cache() const override { return true; }
+
     virtual ErrorOr<void> flush_writes() override;
-    void flush_writes_impl();
+    ErrorOr<void> flush_writes_impl();
 
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
@@ -41,12 +44,35 @@ protected:
 
     u64 m_device_block_size { 512 };
 
-    void remove_disk_cache_before_last_unmount();
+    void remove_cached_pages_before_last_unmount();
 
 private:
-    void flush_specific_block_if_needed(BlockIndex index);
-
-    mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    // Once this many pages are dirty, the SyncTask is woken up to write them back in the background.
+    static constexpr size_t write_behind_threshold = 256;
+    // Once this many pages are dirty, writing another block flushes all of them.
+    static constexpr size_t max_dirty_pages = 2048;
+    // Runs of contiguous pages are read and written with requests of up to this many pages.
+    static constexpr size_t max_pages_per_request = 32;
+
+    ErrorOr<Optional<CachedPageReference>> cached_device_page(u64 page_index) const;
+    ErrorOr<void> read_device_pages_into_cache(u64 first_page_index, size_t page_count, Bytes buffer) const;
+    ErrorOr<void> read_uncached_pages_locked(BlockIndex, size_t count, Bytes buffer) const;
+    ErrorOr<void> read_through_cache_locked(BlockIndex, u64 offset, size_t count, UserOrKernelBuffer*) const;
+    ErrorOr<void> write_locked(BlockIndex, u64 offset, ReadonlyBytes, bool allow_cache);
+    // Pages that couldn't be written back stay dirty, so a later flush tries again.
+    ErrorOr<void> write_back_cached_page(CachedPageReference const&, Bytes page_buffer);
+    ErrorOr<void> flush_specific_blocks_if_needed(BlockIndex, size_t count);
+
+    // These loop until the whole range is transferred, since the device may split large requests.
+    ErrorOr<void> read_device_range(u64 offset, UserOrKernelBuffer&, size_t length) const;
+    ErrorOr<void> write_device_range(u64 offset, UserOrKernelBuffer const&, size_t length);
+
+    template<typename Callback>
+    ErrorOr<void> for_each_page_in_block(BlockIndex, u64 offset, size_t count, Callback) const;
+
+    // NOTE: Reading blocks only needs this lock in shared mode, anything that dirties or cleans pages needs it exclusively.
+    mutable Mutex m_cache_lock { "BlockBasedFileSystem"sv };
+    mutable CachedPageSet m_cached_pages;
 };
 
 }
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::None;
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 events_for_unblocked_flags(BlockFlags unblocked_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    else if (has_flag(unblocked_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    return events;
+}
+
+ErrorOr<NonnullRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    (void)close();
+}
+
+EventPoll::Interest::Interest(EventPoll& event_poll, int fd, OpenFileDescription& description, LockWeakPtr<OpenFileDescription> weak_description, epoll_event const& event)
+    : m_event_poll(event_poll)
+    , m_fd(fd)
+    , m_description(move(weak_description))
+    , m_file(description.file())
+    , m_blocker_set(description.blocker_set())
+{
+    set_event(event);
+    m_blocker_set.add_readiness_observer(*this);
+}
+
+EventPoll::Interest::~Interest()
+{
+    m_blocker_set.remove_readiness_observer(*this);
+    m_event_poll.remove_from_ready_list(*this);
+}
+
+void EventPoll::Interest::set_event(epoll_event const& event)
+{
+    m_events = event.events;
+    m_data = event.data.u64;
+    m_disabled = false;
+}
+
+void EventPoll::Interest::file_readiness_may_have_changed()
+{
+    if (m_disabled)
+        return;
+    m_event_poll.enqueue_ready(*this);
+}
+
+RefPtr<EventPoll> EventPoll::Interest::event_poll_watching(OpenFileDescription const& description)
+{
+    if (!refers_to(description))
+        return nullptr;
+    // If the EventPoll is being destroyed, it is about to drop this interest anyway.
+    if (!m_event_poll.try_ref())
+        return nullptr;
+    return adopt_ref(m_event_poll);
+}
+
+void EventPoll::enqueue_ready(Interest& interest)
+{
+    bool was_empty = m_ready_list.with([&](auto& list) {
+        bool was_empty = list.is_empty();
+        if (!interest.m_ready_list_node.is_in_list())
+            list.append(interest);
+        return was_empty;
+    });
+    if (was_empty)
+        evaluate_block_conditions();
+}
+
+void EventPoll::remove_from_ready_list(Interest& interest)
+{
+    m_ready_list.with([&](auto& list) {
+        if (interest.m_ready_list_node.is_in_list())
+            list.remove(interest);
+    });
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_ready_list.with([](auto& list) { return !list.is_empty(); });
+}
+
+ErrorOr<void> EventPoll::close()
+{
+    m_interests.with_exclusive([](auto& interests) { interests.clear(); });
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create("epoll"sv);
+}
+
+void EventPoll::remove_closed_interests(HashMap<int, NonnullOwnPtr<Interest>>& interests)
+{
+    interests.remove_all_matching([](int, auto& interest) { return !interest->description(); });
+}
+
+void EventPoll::remove_interests_in(OpenFileDescription const& description)
+{
+    m_interests.with_exclusive([&](auto& interests) {
+        interests.remove_all_matching([&](int, auto& interest) { return interest->refers_to(description); });
+    });
+}
+
+ErrorOr<void> EventPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // Watching another EventPoll would let two of them call into each other while holding their locks.
+    if (description.is_event_poll())
+        return EINVAL;
+
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        // Descriptions normally remove themselves when they are closed, but not if they ran out of memory while doing so.
+        remove_closed_interests(interests);
+
+        if (auto it = interests.find(fd); it != interests.end()) {
+            // The fd may have been closed and reused since it was added, in which case the old interest is stale.
+            if (it->value->refers_to(description))
+                return EEXIST;
+            interests.remove(it);
+        }
+
+        auto weak_description = TRY(description.try_make_weak_ptr<OpenFileDescription>());
+        auto interest = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Interest(*this, fd, description, move(weak_description), event)));
+        auto& interest_ref = *interest;
+        TRY(interests.try_set(fd, move(interest)));
+        // Let the next wait find out whether the file is ready already.
+        enqueue_ready(interest_ref);
+        return {};
+    });
+}
+
+ErrorOr<void> EventPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        remove_closed_interests(interests);
+        auto it = interests.find(fd);
+        if (it == interests.end() || !it->value->refers_to(description))
+            return ENOENT;
+        auto& interest = *it->value;
+        interest.set_event(event);
+        enqueue_ready(interest);
+        return {};
+    });
+}
+
+ErrorOr<void> EventPoll::remove_interest(int fd, OpenFileDescription& description)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        remove_closed_interests(interests);
+        auto it = interests.find(fd);
+        if (it == interests.end() || !it->value->refers_to(description))
+            return ENOENT;
+        interests.remove(it);
+        return {};
+    });
+}
+
+ErrorOr<void> EventPoll::collect_ready_events(Vector<epoll_event>& events, size_t max_events)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        // Level-triggered entries are put back at the end of the list, so only look at what is there right now.
+        size_t entries_to_check = m_ready_list.with([](auto& list) { return list.size_slow(); });
+
+        for (size_t i = 0; i < entries_to_check && events.size() < max_events; ++i) {
+            auto* interest = m_ready_list.with([](auto& list) { return list.take_first(); });
+            if (!interest)
+                break;
+
+            auto description = interest->description();
+            if (!description) {
+                // The description was closed, so there is nothing left to report for it.
+                interests.remove(interest->fd());
+                continue;
+            }
+            if (interest->is_disabled())
+                continue;
+
+            // The observer is only told that something may have changed, so check the actual state now.
+            auto unblocked_flags = description->should_unblock(block_flags_for_events(interest->events()));
+            if (unblocked_flags == BlockFlags::None)
+                continue;
+
+            epoll_event event {};
+            event.events = events_for_unblocked_flags(unblocked_flags);
+            event.data.u64 = interest->data();
+            TRY(events.try_append(event));
+
+            if (interest->events() & EPOLLONESHOT)
+                interest->set_disabled(true);
+            else if (!(interest->events() & EPOLLET))
+                enqueue_ready(*interest);
+        }
+        return {};
+    });
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// An EventPoll keeps a persistent set of file descriptors and the events userspace is interested in.
+// Instead of scanning every descriptor on each wait like poll() does, each interest observes the
+// blocker set of its file and puts itself on a ready list when the file's state may have changed.
+// epoll_wait() then only has to look at the entries on that list.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual bool is_event_poll() const override { return true; }
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd, OpenFileDescription&);
+    // Called when the last reference to the description goes away, since our interests would keep its file alive.
+    void remove_interests_in(OpenFileDescription const&);
+
+    // Fills `events` with up to `max_events` ready entries, without blocking.
+    ErrorOr<void> collect_ready_events(Vector<epoll_event>& events, size_t max_events);
+
+private:
+    EventPoll() = default;
+
+    class Interest final : public FileReadinessObserver {
+    public:
+        Interest(EventPoll&, int fd, OpenFileDescription&, LockWeakPtr<OpenFileDescription>, epoll_event const&);
+        ~Interest();
+
+        virtual void file_readiness_may_have_changed() override;
+        virtual RefPtr<EventPoll> event_poll_watching(OpenFileDescription const&) override;
+
+        int fd() const { return m_fd; }
+        LockRefPtr<OpenFileDescription> description() const { return m_description.strong_ref(); }
+        bool refers_to(OpenFileDescription const& description) const { return m_description.unsafe_ptr() == &description; }
+
+        void set_event(epoll_event const&);
+        u32 events() const { return m_events; }
+        u64 data() const { return m_data; }
+
+        bool is_disabled() const { return m_disabled; }
+        void set_disabled(bool disabled) { m_disabled = disabled; }
+
+        IntrusiveListNode<Interest> m_ready_list_node;
+
+    private:
+        EventPoll& m_event_poll;
+        int const m_fd { -1 };
+        LockWeakPtr<OpenFileDescription> m_description;
+        NonnullRefPtr<File> const m_file;
+        FileBlockerSet& m_blocker_set;
+        u32 m_events { 0 };
+        u64 m_data { 0 };
+        bool m_disabled { false };
+    };
+
+    using ReadyList = IntrusiveList<&Interest::m_ready_list_node>;
+
+    void enqueue_ready(Interest&);
+    void remove_from_ready_list(Interest&);
+    static void remove_closed_interests(HashMap<int, NonnullOwnPtr<Interest>>&);
+
+    MutexProtected<HashMap<int, NonnullOwnPtr<Interest>>> m_interests;
+    SpinlockProtected<ReadyList, LockRank::None> m_ready_list {};
+};
+
+}
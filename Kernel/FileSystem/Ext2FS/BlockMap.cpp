@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/Ext2FS/BlockMap.h>
+
+namespace Kernel {
+
+BlockBasedFileSystem::BlockIndex Ext2FSBlockMap::Extent::block_at(u64 logical_block) const
+{
+    VERIFY(logical_block >= first_logical_block && logical_block < end());
+    if (is_hole())
+        return 0;
+    return first_block.value() + (logical_block - first_logical_block);
+}
+
+size_t Ext2FSBlockMap::index_of_first_extent_ending_after(u64 logical_block) const
+{
+    size_t low = 0;
+    size_t high = m_extents.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (m_extents[middle].end() <= logical_block)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+Ext2FSBlockMap::Extent const* Ext2FSBlockMap::find(u64 logical_block) const
+{
+    auto index = index_of_first_extent_ending_after(logical_block);
+    if (index == m_extents.size() || m_extents[index].first_logical_block > logical_block)
+        return nullptr;
+    return &m_extents[index];
+}
+
+ErrorOr<void> Ext2FSBlockMap::add(u64 first_logical_block, BlockBasedFileSystem::BlockIndex first_block, u64 block_count)
+{
+    VERIFY(block_count > 0);
+    Extent extent { first_logical_block, block_count, first_block };
+
+    auto index = index_of_first_extent_ending_after(first_logical_block);
+    VERIFY(index == m_extents.size() || m_extents[index].first_logical_block >= extent.end());
+
+    auto is_continued_by = [](Extent const& extent, Extent const& next_extent) {
+        if (extent.end() != next_extent.first_logical_block || extent.is_hole() != next_extent.is_hole())
+            return false;
+        return extent.is_hole() || extent.first_block.value() + extent.block_count == next_extent.first_block.value();
+    };
+    bool merges_with_previous = index > 0 && is_continued_by(m_extents[index - 1], extent);
+    bool merges_with_next = index < m_extents.size() && is_continued_by(extent, m_extents[index]);
+
+    if (merges_with_previous && merges_with_next) {
+        m_extents[index - 1].block_count += block_count + m_extents[index].block_count;
+        m_extents.remove(index);
+    } else if (merges_with_previous) {
+        m_extents[index - 1].block_count += block_count;
+    } else if (merges_with_next) {
+        m_extents[index].first_logical_block = first_logical_block;
+        m_extents[index].first_block = first_block;
+        m_extents[index].block_count += block_count;
+    } else {
+        TRY(m_extents.try_insert(index, extent));
+    }
+    return {};
+}
+
+void Ext2FSBlockMap::truncate(u64 logical_block_count)
+{
+    auto index = index_of_first_extent_ending_after(logical_block_count);
+    if (index < m_extents.size() && m_extents[index].first_logical_block < logical_block_count) {
+        m_extents[index].block_count = logical_block_count - m_extents[index].first_logical_block;
+        ++index;
+    }
+    m_extents.shrink(index, true);
+}
+
+}
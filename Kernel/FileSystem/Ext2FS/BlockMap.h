@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+
+namespace Kernel {
+
+// Maps the logical blocks of an Ext2FSInode to blocks on disk.
+//
+// Logical blocks that are stored next to each other on disk (or that are all holes) are kept
+// as a single extent, so even a very large file only needs a handful of entries if it isn't
+// fragmented. The map doesn't have to be complete: the inode only reads the block pointers
+// for a part of the file from the disk once something in that part is looked up.
+class Ext2FSBlockMap {
+public:
+    struct Extent {
+        u64 first_logical_block { 0 };
+        u64 block_count { 0 };
+        // The block on disk that holds the first logical block, or zero if this is a hole.
+        BlockBasedFileSystem::BlockIndex first_block { 0 };
+
+        u64 end() const { return first_logical_block + block_count; }
+        bool is_hole() const { return first_block.value() == 0; }
+        BlockBasedFileSystem::BlockIndex block_at(u64 logical_block) const;
+    };
+
+    // Returns the extent containing the logical block, or nullptr if that part of the file isn't mapped yet.
+    Extent const* find(u64 logical_block) const;
+
+    // Maps the given range of logical blocks, which must not be mapped yet, to blocks starting at first_block.
+    ErrorOr<void> add(u64 first_logical_block, BlockBasedFileSystem::BlockIndex first_block, u64 block_count);
+
+    // Forgets about all logical blocks at or after the given one.
+    void truncate(u64 logical_block_count);
+
+    size_t extent_count() const { return m_extents.size(); }
+
+private:
+    size_t index_of_first_extent_ending_after(u64 logical_block) const;
+
+    // Sorted by logical block, and never overlapping.
+    Vector<Extent> m_extents;
+};
+
+}
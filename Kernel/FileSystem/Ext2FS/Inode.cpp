@@ -16,6 +16,7 @@
 namespace Kernel {
 
 static constexpr size_t max_inline_symlink_length = 60;
+static constexpr size_t max_block_run_size = 256 * KiB;
 
 static u8 to_ext2_file_type(mode_t mode)
 {
@@ -36,31 +37,34 @@ static u8 to_ext2_file_type(mode_t mode)
     return EXT2_FT_UNKNOWN;
 }
 
-ErrorOr<void> Ext2FSInode::write_indirect_block(BlockBasedFileSystem::BlockIndex block, Span<BlockBasedFileSystem::BlockIndex> blocks_indices)
+ErrorOr<void> Ext2FSInode::write_indirect_block(BlockBasedFileSystem::BlockIndex block, u64 first_logical_block, size_t count)
 {
-    auto const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
-    VERIFY(blocks_indices.size() <= entries_per_block);
+    VERIFY(count <= EXT2_ADDR_PER_BLOCK(&fs().super_block()));
 
     auto block_contents = TRY(ByteBuffer::create_zeroed(fs().logical_block_size()));
     FixedMemoryStream stream { block_contents.bytes() };
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(block_contents.data());
 
-    VERIFY(blocks_indices.size() <= EXT2_ADDR_PER_BLOCK(&fs().super_block()));
-    for (unsigned i = 0; i < blocks_indices.size(); ++i)
-        MUST(stream.write_value<u32>(blocks_indices[i].value()));
+    auto const end_logical_block = first_logical_block + count;
+    for (auto logical_block = first_logical_block; logical_block < end_logical_block;) {
+        auto extent = TRY(block_map_extent(logical_block));
+        auto const end_of_run = min(extent.end(), end_logical_block);
+        for (; logical_block < end_of_run; ++logical_block)
+            MUST(stream.write_value<u32>(extent.block_at(logical_block).value()));
+    }
 
     return fs().write_block(block, buffer, block_contents.size());
 }
 
-ErrorOr<void> Ext2FSInode::grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex block, size_t old_blocks_length, Span<BlockBasedFileSystem::BlockIndex> blocks_indices, Vector<Ext2FS::BlockIndex>& new_meta_blocks, unsigned& meta_blocks)
+ErrorOr<void> Ext2FSInode::grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex block, u64 first_logical_block, size_t old_blocks_length, size_t new_blocks_length, Vector<Ext2FS::BlockIndex>& new_meta_blocks, unsigned& meta_blocks)
 {
     auto const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
     auto const entries_per_doubly_indirect_block = entries_per_block * entries_per_block;
     auto const old_indirect_blocks_length = ceil_div(old_blocks_length, entries_per_block);
-    auto const new_indirect_blocks_length = ceil_div(blocks_indices.size(), entries_per_block);
-    VERIFY(blocks_indices.size() > 0);
-    VERIFY(blocks_indices.size() > old_blocks_length);
-    VERIFY(blocks_indices.size() <= entries_per_doubly_indirect_block);
+    auto const new_indirect_blocks_length = ceil_div(new_blocks_length, entries_per_block);
+    VERIFY(new_blocks_length > 0);
+    VERIFY(new_blocks_length > old_blocks_length);
+    VERIFY(new_blocks_length <= entries_per_doubly_indirect_block);
 
     auto block_contents = TRY(ByteBuffer::create_zeroed(fs().logical_block_size()));
     auto* block_as_pointers = (unsigned*)block_contents.data();
@@ -84,7 +88,7 @@ ErrorOr<void> Ext2FSInode::grow_doubly_indirect_block(BlockBasedFileSystem::Bloc
     // Write out the indirect blocks.
     for (unsigned i = old_blocks_length / entries_per_block; i < new_indirect_blocks_length; i++) {
         auto const offset_block = i * entries_per_block;
-        TRY(write_indirect_block(block_as_pointers[i], blocks_indices.slice(offset_block, min(blocks_indices.size() - offset_block, entries_per_block))));
+        TRY(write_indirect_block(block_as_pointers[i], first_logical_block + offset_block, min(new_blocks_length - offset_block, entries_per_block)));
     }
 
     // Write out the doubly indirect block.
@@ -123,16 +127,16 @@ ErrorOr<void> Ext2FSInode::shrink_doubly_indirect_block(BlockBasedFileSystem::Bl
     return {};
 }
 
-ErrorOr<void> Ext2FSInode::grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex block, size_t old_blocks_length, Span<BlockBasedFileSystem::BlockIndex> blocks_indices, Vector<Ext2FS::BlockIndex>& new_meta_blocks, unsigned& meta_blocks)
+ErrorOr<void> Ext2FSInode::grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex block, u64 first_logical_block, size_t old_blocks_length, size_t new_blocks_length, Vector<Ext2FS::BlockIndex>& new_meta_blocks, unsigned& meta_blocks)
 {
     auto const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
     auto const entries_per_doubly_indirect_block = entries_per_block * entries_per_block;
-    auto const entries_per_triply_indirect_block = entries_per_block * entries_per_block;
+    auto const entries_per_triply_indirect_block = entries_per_doubly_indirect_block * entries_per_block;
     auto const old_doubly_indirect_blocks_length = ceil_div(old_blocks_length, entries_per_doubly_indirect_block);
-    auto const new_doubly_indirect_blocks_length = ceil_div(blocks_indices.size(), entries_per_doubly_indirect_block);
-    VERIFY(blocks_indices.size() > 0);
-    VERIFY(blocks_indices.size() > old_blocks_length);
-    VERIFY(blocks_indices.size() <= entries_per_triply_indirect_block);
+    auto const new_doubly_indirect_blocks_length = ceil_div(new_blocks_length, entries_per_doubly_indirect_block);
+    VERIFY(new_blocks_length > 0);
+    VERIFY(new_blocks_length > old_blocks_length);
+    VERIFY(new_blocks_length <= entries_per_triply_indirect_block);
 
     auto block_contents = TRY(ByteBuffer::create_zeroed(fs().logical_block_size()));
     auto* block_as_pointers = (unsigned*)block_contents.data();
@@ -157,8 +161,8 @@ ErrorOr<void> Ext2FSInode::grow_triply_indirect_block(BlockBasedFileSystem::Bloc
     for (unsigned i = old_blocks_length / entries_per_doubly_indirect_block; i < new_doubly_indirect_blocks_length; i++) {
         auto const processed_blocks = i * entries_per_doubly_indirect_block;
         auto const old_doubly_indirect_blocks_length = min(old_blocks_length > processed_blocks ? old_blocks_length - processed_blocks : 0, entries_per_doubly_indirect_block);
-        auto const new_doubly_indirect_blocks_length = min(blocks_indices.size() > processed_blocks ? blocks_indices.size() - processed_blocks : 0, entries_per_doubly_indirect_block);
-        TRY(grow_doubly_indirect_block(block_as_pointers[i], old_doubly_indirect_blocks_length, blocks_indices.slice(processed_blocks, new_doubly_indirect_blocks_length), new_meta_blocks, meta_blocks));
+        auto const new_doubly_indirect_blocks_length = min(new_blocks_length > processed_blocks ? new_blocks_length - processed_blocks : 0, entries_per_doubly_indirect_block);
+        TRY(grow_doubly_indirect_block(block_as_pointers[i], first_logical_block + processed_blocks, old_doubly_indirect_blocks_length, new_doubly_indirect_blocks_length, new_meta_blocks, meta_blocks));
     }
 
     // Write out the triply indirect block.
@@ -200,41 +204,42 @@ ErrorOr<void> Ext2FSInode::shrink_triply_indirect_block(BlockBasedFileSystem::Bl
     return {};
 }
 
-ErrorOr<void> Ext2FSInode::flush_block_list()
+ErrorOr<void> Ext2FSInode::flush_block_list(u64 new_block_count)
 {
     MutexLocker locker(m_inode_lock);
 
-    if (m_block_list.is_empty()) {
+    if (new_block_count == 0) {
         m_raw_inode.i_blocks = 0;
         memset(m_raw_inode.i_block, 0, sizeof(m_raw_inode.i_block));
         set_metadata_dirty(true);
         return {};
     }
 
-    // NOTE: There is a mismatch between i_blocks and blocks.size() since i_blocks includes meta blocks and blocks.size() does not.
-    auto const old_block_count = ceil_div(size(), static_cast<u64>(fs().logical_block_size()));
+    // NOTE: There is a mismatch between i_blocks and the block count since i_blocks includes meta blocks and the block count does not.
+    auto const old_block_count = data_block_count();
 
     auto old_shape = fs().compute_block_list_shape(old_block_count);
-    auto const new_shape = fs().compute_block_list_shape(m_block_list.size());
+    auto const new_shape = fs().compute_block_list_shape(new_block_count);
 
     Vector<Ext2FS::BlockIndex> new_meta_blocks;
     if (new_shape.meta_blocks > old_shape.meta_blocks) {
         new_meta_blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), new_shape.meta_blocks - old_shape.meta_blocks));
     }
 
-    m_raw_inode.i_blocks = (m_block_list.size() + new_shape.meta_blocks) * (fs().logical_block_size() / 512);
+    m_raw_inode.i_blocks = (new_block_count + new_shape.meta_blocks) * (fs().logical_block_size() / 512);
     dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::flush_block_list(): Old shape=({};{};{};{}:{}), new shape=({};{};{};{}:{})", identifier(), old_shape.direct_blocks, old_shape.indirect_blocks, old_shape.doubly_indirect_blocks, old_shape.triply_indirect_blocks, old_shape.meta_blocks, new_shape.direct_blocks, new_shape.indirect_blocks, new_shape.doubly_indirect_blocks, new_shape.triply_indirect_blocks, new_shape.meta_blocks);
 
     unsigned output_block_index = 0;
-    unsigned remaining_blocks = m_block_list.size();
+    unsigned remaining_blocks = new_block_count;
 
     // Deal with direct blocks.
     bool inode_dirty = false;
     VERIFY(new_shape.direct_blocks <= EXT2_NDIR_BLOCKS);
     for (unsigned i = 0; i < new_shape.direct_blocks; ++i) {
-        if (BlockBasedFileSystem::BlockIndex(m_raw_inode.i_block[i]) != m_block_list[output_block_index])
+        auto block_index = TRY(block_map_extent(output_block_index)).block_at(output_block_index);
+        if (BlockBasedFileSystem::BlockIndex(m_raw_inode.i_block[i]) != block_index)
             inode_dirty = true;
-        m_raw_inode.i_block[i] = m_block_list[output_block_index].value();
+        m_raw_inode.i_block[i] = block_index.value();
         ++output_block_index;
         --remaining_blocks;
     }
@@ -249,9 +254,9 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
     }
     if (inode_dirty) {
         if constexpr (EXT2_DEBUG) {
-            dbgln("Ext2FSInode[{}]::flush_block_list(): Writing {} direct block(s) to i_block array of inode {}", identifier(), min((size_t)EXT2_NDIR_BLOCKS, m_block_list.size()), index());
-            for (size_t i = 0; i < min((size_t)EXT2_NDIR_BLOCKS, m_block_list.size()); ++i)
-                dbgln("   + {}", m_block_list[i]);
+            dbgln("Ext2FSInode[{}]::flush_block_list(): Writing {} direct block(s) to i_block array of inode {}", identifier(), new_shape.direct_blocks, index());
+            for (size_t i = 0; i < new_shape.direct_blocks; ++i)
+                dbgln("   + {}", m_raw_inode.i_block[i]);
         }
         set_metadata_dirty(true);
     }
@@ -268,7 +273,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 old_shape.meta_blocks++;
             }
 
-            TRY(write_indirect_block(m_raw_inode.i_block[EXT2_IND_BLOCK], m_block_list.span().slice(output_block_index, new_shape.indirect_blocks)));
+            TRY(write_indirect_block(m_raw_inode.i_block[EXT2_IND_BLOCK], output_block_index, new_shape.indirect_blocks));
         } else if ((new_shape.indirect_blocks == 0) && (old_shape.indirect_blocks != 0)) {
             dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::flush_block_list(): Freeing indirect block: {}", identifier(), m_raw_inode.i_block[EXT2_IND_BLOCK]);
             TRY(fs().set_block_allocation_state(m_raw_inode.i_block[EXT2_IND_BLOCK], false));
@@ -290,7 +295,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 set_metadata_dirty(true);
                 old_shape.meta_blocks++;
             }
-            TRY(grow_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], old_shape.doubly_indirect_blocks, m_block_list.span().slice(output_block_index, new_shape.doubly_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
+            TRY(grow_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], output_block_index, old_shape.doubly_indirect_blocks, new_shape.doubly_indirect_blocks, new_meta_blocks, old_shape.meta_blocks));
         } else {
             TRY(shrink_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], old_shape.doubly_indirect_blocks, new_shape.doubly_indirect_blocks, old_shape.meta_blocks));
             if (new_shape.doubly_indirect_blocks == 0)
@@ -311,7 +316,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 set_metadata_dirty(true);
                 old_shape.meta_blocks++;
             }
-            TRY(grow_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], old_shape.triply_indirect_blocks, m_block_list.span().slice(output_block_index, new_shape.triply_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
+            TRY(grow_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], output_block_index, old_shape.triply_indirect_blocks, new_shape.triply_indirect_blocks, new_meta_blocks, old_shape.meta_blocks));
         } else {
             TRY(shrink_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], old_shape.triply_indirect_blocks, new_shape.triply_indirect_blocks, old_shape.meta_blocks));
             if (new_shape.triply_indirect_blocks == 0)
@@ -332,11 +337,6 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
     VERIFY_NOT_REACHED();
 }
 
-ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list() const
-{
-    return compute_block_list_impl(false);
-}
-
 ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_with_meta_blocks() const
 {
     return compute_block_list_impl(true);
@@ -500,31 +500,122 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_metadata(): Flushing inode", identifier());
     TRY(fs().write_ext2_inode(index(), m_raw_inode));
-    if (is_directory()) {
-        // Unless we're about to go away permanently, invalidate the lookup cache.
-        if (m_raw_inode.i_links_count != 0) {
-            // FIXME: This invalidation is way too hardcore. It's sad to throw away the whole cache.
-            m_lookup_cache.clear();
-        }
-    }
     set_metadata_dirty(false);
     return {};
 }
 
-ErrorOr<void> Ext2FSInode::compute_block_list_with_exclusive_locking()
+u64 Ext2FSInode::data_block_count() const
+{
+    // If we are handling a symbolic link, the path is stored in the 60 bytes in
+    // the inode that are used for the 12 direct and 3 indirect block pointers.
+    if (Kernel::is_symlink(m_raw_inode.i_mode) && m_raw_inode.i_blocks == 0)
+        return 0;
+    return ceil_div(size(), static_cast<u64>(fs().logical_block_size()));
+}
+
+ErrorOr<Ext2FSBlockMap::Extent> Ext2FSInode::block_map_extent(u64 logical_block) const
 {
-    // Note: We verify that the inode mutex is being held locked. Because only the read_bytes_locked()
-    // method uses this method and the mutex can be locked in shared mode when reading the Inode if
-    // it is an ext2 regular file, but also in exclusive mode, when the Inode is an ext2 directory and being
-    // traversed, we use another exclusive lock to ensure we always mutate the block list safely.
     VERIFY(m_inode_lock.is_locked());
-    MutexLocker block_list_locker(m_block_list_lock);
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    MutexLocker block_map_locker(m_block_map_lock);
+    if (auto const* extent = m_block_map.find(logical_block))
+        return *extent;
+    TRY(load_block_map_chunk(logical_block));
+    auto const* extent = m_block_map.find(logical_block);
+    VERIFY(extent);
+    return *extent;
+}
+
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::read_block_pointer(BlockBasedFileSystem::BlockIndex block, size_t index_in_block) const
+{
+    // Everything below a missing indirect block is a hole.
+    if (block.value() == 0)
+        return BlockBasedFileSystem::BlockIndex { 0 };
+    u32 block_pointer = 0;
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(reinterpret_cast<u8*>(&block_pointer));
+    TRY(fs().read_block(block, &buffer, sizeof(block_pointer), index_in_block * sizeof(block_pointer)));
+    return BlockBasedFileSystem::BlockIndex { block_pointer };
+}
+
+ErrorOr<void> Ext2FSInode::add_block_pointers_to_block_map(u64 first_logical_block, ReadonlySpan<u32> block_pointers) const
+{
+    VERIFY(m_block_map_lock.is_locked());
+    for (size_t i = 0; i < block_pointers.size(); ++i) {
+        // Blocks that were added to the file since it was last flushed are already in the map.
+        if (m_block_map.find(first_logical_block + i))
+            continue;
+        TRY(m_block_map.add(first_logical_block + i, block_pointers[i], 1));
+    }
     return {};
 }
 
+ErrorOr<void> Ext2FSInode::load_block_map_chunk(u64 logical_block) const
+{
+    VERIFY(m_block_map_lock.is_locked());
+    auto const block_count = data_block_count();
+    if (logical_block >= block_count) {
+        dmesgln("Ext2FSInode[{}]::load_block_map_chunk(): Logical block {} is out of range ({} blocks)", identifier(), logical_block, block_count);
+        return EIO;
+    }
+
+    if (logical_block < EXT2_NDIR_BLOCKS)
+        return add_block_pointers_to_block_map(0, { m_raw_inode.i_block, min(block_count, static_cast<u64>(EXT2_NDIR_BLOCKS)) });
+
+    // Past the direct blocks, the pointers are read one indirect block at a time,
+    // so only the parts of the file that are actually accessed are ever mapped.
+    u64 const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
+    u64 const entries_per_doubly_indirect_block = entries_per_block * entries_per_block;
+    u64 index = logical_block - EXT2_NDIR_BLOCKS;
+    u64 first_logical_block_of_chunk = EXT2_NDIR_BLOCKS;
+    BlockBasedFileSystem::BlockIndex indirect_block;
+    if (index < entries_per_block) {
+        indirect_block = m_raw_inode.i_block[EXT2_IND_BLOCK];
+    } else {
+        index -= entries_per_block;
+        first_logical_block_of_chunk += entries_per_block;
+        if (index < entries_per_doubly_indirect_block) {
+            indirect_block = TRY(read_block_pointer(m_raw_inode.i_block[EXT2_DIND_BLOCK], index / entries_per_block));
+        } else {
+            index -= entries_per_doubly_indirect_block;
+            first_logical_block_of_chunk += entries_per_doubly_indirect_block;
+            if (index >= entries_per_doubly_indirect_block * entries_per_block) {
+                dmesgln("Ext2FSInode[{}]::load_block_map_chunk(): Logical block {} is past the triply indirect block", identifier(), logical_block);
+                return EIO;
+            }
+            auto doubly_indirect_block = TRY(read_block_pointer(m_raw_inode.i_block[EXT2_TIND_BLOCK], index / entries_per_doubly_indirect_block));
+            indirect_block = TRY(read_block_pointer(doubly_indirect_block, (index / entries_per_block) % entries_per_block));
+        }
+    }
+    first_logical_block_of_chunk += index - index % entries_per_block;
+
+    auto const chunk_size = min(entries_per_block, block_count - first_logical_block_of_chunk);
+    auto block_pointers = TRY(ByteBuffer::create_zeroed(chunk_size * sizeof(u32)));
+    if (indirect_block.value() != 0) {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(block_pointers.data());
+        TRY(fs().read_block(indirect_block, &buffer, block_pointers.size()));
+    }
+    dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::load_block_map_chunk(): Mapping {} blocks at logical block {} from indirect block {}", identifier(), chunk_size, first_logical_block_of_chunk, indirect_block);
+    return add_block_pointers_to_block_map(first_logical_block_of_chunk, { reinterpret_cast<u32 const*>(block_pointers.data()), chunk_size });
+}
+
+size_t Ext2FSInode::contiguous_block_run_length(Ext2FSBlockMap::Extent const& extent, u64 first_logical_block, size_t max_run_length) const
+{
+    // Requests are buffered as a whole, so don't let a single run grow too large.
+    max_run_length = min(max_run_length, max_block_run_size / fs().logical_block_size());
+    return min(extent.end() - first_logical_block, static_cast<u64>(max_run_length));
+}
+
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    return read_bytes_impl(offset, count, buffer, !description || !description->is_direct());
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The data ends up in our own cached pages, so keeping a copy in the file system's device pages as well would only waste memory.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -543,26 +634,18 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         return nread;
     }
 
-    // Note: We bypass the const declaration of this method, but this is a strong
-    // requirement to be able to accomplish the read operation successfully.
-    // We call this special method because it locks a separate mutex to ensure we
-    // update the block list of the inode safely, as the m_inode_lock is locked in
-    // shared mode.
-    TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
-
-    if (m_block_list.is_empty()) {
+    auto const block_count = data_block_count();
+    if (block_count == 0) {
         dmesgln("Ext2FSInode[{}]::read_bytes(): Empty block list", identifier());
         return EIO;
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     int const block_size = fs().logical_block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     int offset_into_first_block = offset % block_size;
 
@@ -572,10 +655,24 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
-        auto block_index = m_block_list[bi.value()];
+        auto extent = TRY(block_map_extent(bi.value()));
+        auto block_index = extent.block_at(bi.value());
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
         auto buffer_offset = buffer.offset(nread);
+        if (block_index.value() != 0 && offset_into_block == 0 && num_bytes_to_copy == (size_t)block_size) {
+            auto run_length = contiguous_block_run_length(extent, bi.value(), min(last_block_logical_index.value() - bi.value() + 1, static_cast<u64>(remaining_count) / block_size));
+            if (run_length > 1) {
+                if (auto result = fs().read_blocks(block_index, run_length, buffer_offset, allow_cache); result.is_error()) {
+                    dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read {} blocks at block {} (index {})", identifier(), run_length, block_index.value(), bi);
+                    return result.release_error();
+                }
+                remaining_count -= run_length * block_size;
+                nread += run_length * block_size;
+                bi = bi.value() + run_length - 1;
+                continue;
+            }
+        }
         if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
@@ -602,7 +699,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         return ENOSPC;
 
     u64 block_size = fs().logical_block_size();
-    auto blocks_needed_before = ceil_div(old_size, block_size);
+    auto blocks_needed_before = data_block_count();
     auto blocks_needed_after = ceil_div(new_size, block_size);
 
     if constexpr (EXT2_DEBUG) {
@@ -616,31 +713,42 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
             return ENOSPC;
     }
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
-        TRY(m_block_list.try_extend(move(blocks)));
-    } else if (blocks_needed_after < blocks_needed_before) {
-        if constexpr (EXT2_VERY_DEBUG) {
-            dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
-            for (auto block_index : m_block_list) {
-                dbgln("    # {}", block_index);
-            }
+        // Try to continue the file right after its current last block, so it stays contiguous on disk.
+        // This also makes sure the end of the block map is loaded before new blocks get appended to it.
+        BlockBasedFileSystem::BlockIndex goal = 0;
+        if (blocks_needed_before > 0) {
+            auto last_block_index = TRY(block_map_extent(blocks_needed_before - 1)).block_at(blocks_needed_before - 1);
+            if (last_block_index.value() != 0)
+                goal = last_block_index.value() + 1;
         }
-        while (m_block_list.size() != blocks_needed_after) {
-            auto block_index = m_block_list.take_last();
-            if (block_index.value()) {
+        auto preferred_group_index = goal.value() != 0 ? fs().group_index_from_block_index(goal) : fs().group_index_from_inode(index());
+        auto blocks = TRY(fs().allocate_blocks(preferred_group_index, blocks_needed_after - blocks_needed_before, goal));
+
+        MutexLocker block_map_locker(m_block_map_lock);
+        for (size_t i = 0; i < blocks.size(); ++i)
+            TRY(m_block_map.add(blocks_needed_before + i, blocks[i], 1));
+        dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::resize(): Block map has {} extents for {} blocks", identifier(), m_block_map.extent_count(), blocks_needed_after);
+    } else if (blocks_needed_after < blocks_needed_before) {
+        for (u64 bi = blocks_needed_after; bi < blocks_needed_before;) {
+            auto extent = TRY(block_map_extent(bi));
+            auto const end_of_run = min(extent.end(), blocks_needed_before);
+            for (; bi < end_of_run; ++bi) {
+                auto block_index = extent.block_at(bi);
+                if (!block_index.value())
+                    continue;
+                dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::resize(): Freeing block {} (index {})", identifier(), block_index, bi);
                 if (auto result = fs().set_block_allocation_state(block_index, false); result.is_error()) {
                     dbgln("Ext2FSInode[{}]::resize(): Failed to free block {}: {}", identifier(), block_index, result.error());
                     return result;
                 }
             }
         }
+        MutexLocker block_map_locker(m_block_map_lock);
+        m_block_map.truncate(blocks_needed_after);
     }
 
-    TRY(flush_block_list());
+    TRY(flush_block_list(blocks_needed_after));
 
     m_raw_inode.i_size = new_size;
     if (Kernel::is_regular_file(m_raw_inode.i_mode))
@@ -692,18 +800,16 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
 
     TRY(resize(new_size));
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-
-    if (m_block_list.is_empty()) {
+    auto const block_count = data_block_count();
+    if (block_count == 0) {
         dbgln("Ext2FSInode[{}]::write_bytes(): Empty block list", identifier());
         return EIO;
     }
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     size_t offset_into_first_block = offset % block_size;
 
@@ -715,9 +821,25 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), m_block_list[bi.value()], offset_into_block);
-        if (auto result = fs().write_block(m_block_list[bi.value()], data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
-            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), m_block_list[bi.value()], bi);
+        auto extent = TRY(block_map_extent(bi.value()));
+        auto block_index = extent.block_at(bi.value());
+        if (offset_into_block == 0 && num_bytes_to_copy == block_size) {
+            auto run_length = contiguous_block_run_length(extent, bi.value(), min(last_block_logical_index.value() - bi.value() + 1, static_cast<u64>(remaining_count) / block_size));
+            if (run_length > 1) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing {} blocks at block {}", identifier(), run_length, block_index);
+                if (auto result = fs().write_blocks(block_index, run_length, data.offset(nwritten), allow_cache); result.is_error()) {
+                    dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write {} blocks at block {} (index {})", identifier(), run_length, block_index, bi);
+                    return result.release_error();
+                }
+                remaining_count -= run_length * block_size;
+                nwritten += run_length * block_size;
+                bi = bi.value() + run_length - 1;
+                continue;
+            }
+        }
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
+        if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, bi);
             return result.release_error();
         }
         remaining_count -= num_bytes_to_copy;
@@ -726,7 +848,7 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
 
     did_modify_contents();
 
-    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks in list)", identifier(), size(), m_raw_inode.i_blocks, m_block_list.size());
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks in list)", identifier(), size(), m_raw_inode.i_blocks, block_count);
     return nwritten;
 }
 
@@ -893,10 +1015,11 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
 
     m_lookup_cache.remove(it);
 
+    // The entry is gone from the directory now, so the name cache must forget it even if we fail to unlink the child below.
+    did_remove_child(child_id, name);
+
     auto child_inode = TRY(fs().get_inode(child_id));
     TRY(child_inode->decrement_link_count());
-
-    did_remove_child(child_id, name);
     return {};
 }
 
@@ -953,7 +1076,7 @@ ErrorOr<void> Ext2FSInode::replace_child(StringView name, Inode& child)
     //        can't "un-write" a directory entry list.
     TRY(write_directory(entries));
 
-    // TODO: Emit a did_replace_child event.
+    did_replace_child(child.identifier(), name);
 
     return {};
 }
@@ -1085,13 +1208,10 @@ ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-
-    if (index < 0 || (size_t)index >= m_block_list.size())
+    if (index < 0 || static_cast<u64>(index) >= data_block_count())
         return 0;
 
-    return m_block_list[index].value();
+    return TRY(block_map_extent(index)).block_at(index).value();
 }
 
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <Kernel/FileSystem/Ext2FS/BlockMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
@@ -28,6 +29,7 @@ public:
 private:
     // ^Inode
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const override;
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) override;
@@ -48,15 +50,23 @@ private:
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
     ErrorOr<void> resize(u64);
-    ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
-    ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
+    ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, u64 first_logical_block, size_t count);
+    ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, u64 first_logical_block, size_t old_blocks_length, size_t new_blocks_length, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
-    ErrorOr<void> grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
+    ErrorOr<void> grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex, u64 first_logical_block, size_t old_blocks_length, size_t new_blocks_length, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
-    ErrorOr<void> flush_block_list();
+    ErrorOr<void> flush_block_list(u64 new_block_count);
 
-    ErrorOr<void> compute_block_list_with_exclusive_locking();
-    ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
+    // The number of logical blocks covered by the block pointers, which is zero for inline symlinks.
+    u64 data_block_count() const;
+    // Returns the extent of the block map that contains the logical block, reading its block pointers from the disk if needed.
+    ErrorOr<Ext2FSBlockMap::Extent> block_map_extent(u64 logical_block) const;
+    ErrorOr<void> load_block_map_chunk(u64 logical_block) const;
+    ErrorOr<void> add_block_pointers_to_block_map(u64 first_logical_block, ReadonlySpan<u32> block_pointers) const;
+    ErrorOr<BlockBasedFileSystem::BlockIndex> read_block_pointer(BlockBasedFileSystem::BlockIndex, size_t index_in_block) const;
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
+    // Returns how many blocks starting at the given logical block are next to each other on disk.
+    size_t contiguous_block_run_length(Ext2FSBlockMap::Extent const&, u64 first_logical_block, size_t max_run_length) const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl(bool include_block_list_blocks) const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl_internal(ext2_inode const&, bool include_block_list_blocks) const;
@@ -65,11 +75,13 @@ private:
     Ext2FS const& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
-    Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
+    // NOTE: Reading only locks the inode in shared mode, and fills in the block map as it goes,
+    //       so the block map is protected by a lock of its own.
+    mutable Ext2FSBlockMap m_block_map;
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode {};
 
-    Mutex m_block_list_lock { "BlockList"sv };
+    mutable Mutex m_block_map_lock { "BlockMap"sv };
 };
 
 inline Ext2FS& Ext2FSInode::fs()
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,54 @@ namespace Kernel {
 
 class File;
 
+// A FileReadinessObserver is told whenever the blocking conditions of a file are re-evaluated,
+// without having to block a thread on it. This is how an EventPoll keeps track of its interests.
+class FileReadinessObserver {
+public:
+    // Called with the blocker set's lock held, so this must not block.
+    virtual void file_readiness_may_have_changed() = 0;
+
+    // Returns a new reference to the EventPoll this observer belongs to if it watches the given description, so the
+    // description can leave it when it is closed. Also called with the blocker set's lock held.
+    virtual RefPtr<EventPoll> event_poll_watching(OpenFileDescription const&) = 0;
+
+protected:
+    ~FileReadinessObserver() = default;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileReadinessObserver> m_readiness_observer_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    virtual ~FileBlockerSet() override
+    {
+        VERIFY(m_readiness_observers.is_empty());
+    }
+
+    void add_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.append(observer);
+    }
+
+    void remove_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.remove(observer);
+    }
+
+    template<typename Callback>
+    void for_each_readiness_observer(Callback callback)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto& observer : m_readiness_observers)
+            callback(observer);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +85,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_readiness_observers)
+            observer.file_readiness_may_have_changed();
     }
+
+private:
+    IntrusiveList<&FileReadinessObserver::m_readiness_observer_list_node> m_readiness_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +164,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_poll() const { return false; }
     virtual bool is_mount_file() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
@@ -9,6 +9,7 @@
 #include <AK/StringView.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/NameCache.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -29,6 +30,10 @@ FileSystem::~FileSystem()
 
 ErrorOr<void> FileSystem::prepare_to_unmount(Inode& mount_guest_inode)
 {
+    // Cached lookups keep inodes alive, which would make them look busy.
+    if (supports_name_cache())
+        NameCache::the().invalidate_all_in(*this);
+
     return m_attach_count.with([&](auto& attach_count) -> ErrorOr<void> {
         dbgln_if(VFS_DEBUG, "VFS: File system {} (id {}) is attached {} time(s)", class_name(), m_fsid.value(), attach_count);
         if (attach_count == 1)
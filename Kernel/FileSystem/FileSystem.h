@@ -33,6 +33,11 @@ public:
     virtual StringView class_name() const = 0;
     virtual Inode& root_inode() = 0;
     virtual bool supports_watchers() const { return false; }
+    // Whether the contents of regular files should be kept in the PageCache.
+    virtual bool supports_page_cache() const { return false; }
+    // Whether directory lookups may be kept in the NameCache. This requires all changes
+    // to directories to be reported through Inode::did_{add,remove,replace}_child().
+    virtual bool supports_name_cache() const { return false; }
 
     bool is_readonly() const { return m_readonly; }
 
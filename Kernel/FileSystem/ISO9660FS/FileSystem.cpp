@@ -83,7 +83,7 @@ u8 ISO9660FS::internal_file_type_to_directory_entry_type(DirectoryEntryView cons
 ErrorOr<void> ISO9660FS::prepare_to_clear_last_mount(Inode&)
 {
     // FIXME: Do proper cleaning here.
-    BlockBasedFileSystem::remove_disk_cache_before_last_unmount();
+    BlockBasedFileSystem::remove_cached_pages_before_last_unmount();
     return {};
 }
 
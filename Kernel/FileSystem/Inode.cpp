@@ -9,20 +9,28 @@
 #include <AK/Singleton.h>
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
+#include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
+#include <Kernel/FileSystem/NameCache.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
 static Singleton<SpinlockProtected<Inode::AllInstancesList, LockRank::None>> s_all_instances;
 
+// Read-ahead fills runs of uncached pages with one file system read each, up to this many pages at a time.
+static constexpr size_t max_pages_per_read_ahead_request = 32;
+// Writes to an inode with cached pages are staged through a kernel buffer of at most this size.
+static constexpr size_t max_cached_write_chunk_size = 64 * KiB;
+
 SpinlockProtected<Inode::AllInstancesList, LockRank::None>& Inode::all_instances()
 {
     return s_all_instances;
@@ -43,13 +51,10 @@ void Inode::sync_all()
     }
 }
 
-void Inode::sync()
+ErrorOr<void> Inode::sync()
 {
-    (void)flush_metadata();
-    auto result = fs().flush_writes();
-    if (result.is_error()) {
-        // TODO: Figure out how to propagate error to a higher function.
-    }
+    TRY(flush_metadata());
+    return fs().flush_writes();
 }
 
 ErrorOr<NonnullRefPtr<Custody>> Inode::resolve_as_link(Credentials const& credentials, Custody& base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level) const
@@ -92,15 +97,228 @@ ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuff
 {
     MutexLocker locker(m_inode_lock);
     TRY(prepare_to_write_data());
-    return write_bytes_locked(offset, length, target_buffer, open_description);
+    // NOTE: Writes go straight through to the file system, we only have to bring pages we already cached up to date.
+    if (length == 0 || m_cached_pages.is_empty())
+        return write_bytes_locked(offset, length, target_buffer, open_description);
+    return write_bytes_and_update_cached_pages_locked(offset, length, target_buffer, open_description);
+}
+
+ErrorOr<size_t> Inode::write_bytes_and_update_cached_pages_locked(off_t offset, size_t length, UserOrKernelBuffer const& data, OpenFileDescription* open_description)
+{
+    VERIFY(m_inode_lock.is_exclusively_locked_by_current_thread());
+
+    // NOTE: The data is copied into a kernel buffer first, so the bytes that end up in our cached pages are exactly
+    //       the ones the file system wrote, even if userspace changes its buffer in the meantime.
+    auto chunk = TRY(ByteBuffer::create_uninitialized(min(length, max_cached_write_chunk_size)));
+    size_t nwritten = 0;
+    while (nwritten < length) {
+        size_t chunk_size = min(length - nwritten, chunk.size());
+        auto nwritten_now_or_error = [&]() -> ErrorOr<size_t> {
+            TRY(data.read(chunk.data(), nwritten, chunk_size));
+            auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(chunk.data());
+            return write_bytes_locked(offset + nwritten, chunk_size, chunk_buffer, open_description);
+        }();
+        if (nwritten_now_or_error.is_error()) {
+            if (nwritten > 0)
+                break;
+            return nwritten_now_or_error.release_error();
+        }
+        auto nwritten_now = nwritten_now_or_error.release_value();
+        write_into_cached_pages_locked(offset + nwritten, chunk.bytes().trim(nwritten_now));
+        nwritten += nwritten_now;
+        if (nwritten_now < chunk_size)
+            break;
+    }
+    return nwritten;
+}
+
+void Inode::write_into_cached_pages_locked(u64 offset, ReadonlyBytes data)
+{
+    VERIFY(m_inode_lock.is_exclusively_locked_by_current_thread());
+    size_t ncopied = 0;
+    while (ncopied < data.size()) {
+        u64 position = offset + ncopied;
+        size_t offset_in_page = position % PAGE_SIZE;
+        size_t chunk_size = min(data.size() - ncopied, PAGE_SIZE - offset_in_page);
+        // NOTE: The file system already has this data, so the page stays clean. Pages we don't have cached are simply skipped.
+        (void)PageCache::the().write(m_cached_pages, position / PAGE_SIZE, offset_in_page, data.slice(ncopied, chunk_size), PageCache::MarkDirty::No);
+        ncopied += chunk_size;
+    }
 }
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
+    if (fs().supports_page_cache() && !(open_description && open_description->is_direct())) {
+        auto metadata = this->metadata();
+        if (metadata.is_regular_file()) {
+            size_t nread = 0;
+            {
+                MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+                nread = TRY(read_bytes_through_page_cache_locked(offset, length, buffer, metadata.size));
+            }
+            if (open_description && nread > 0) {
+                if (auto range = open_description->did_read_through_page_cache(offset, nread); range.has_value())
+                    start_read_ahead(range->offset, range->length);
+            }
+            return nread;
+        }
+    }
+
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+ErrorOr<size_t> Inode::read_for_page_cache_locked(u64 offset, Bytes buffer) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    size_t nread = 0;
+    while (nread < buffer.size()) {
+        auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.offset_pointer(nread));
+        auto nread_now = TRY(read_bytes_for_page_cache_locked(offset + nread, buffer.size() - nread, chunk_buffer));
+        if (nread_now == 0)
+            break;
+        nread += nread_now;
+    }
+    return nread;
+}
+
+ErrorOr<CachedPageReference> Inode::cached_page_locked(u64 page_index, u64 file_size) const
+{
+    auto page = PageCache::the().find(m_cached_pages, page_index);
+    // A page that was cut short by the end of the file has to be read again once the file grew past it.
+    if (page.has_value() && (page->valid_bytes == PAGE_SIZE || page_index * PAGE_SIZE + page->valid_bytes >= file_size))
+        return page.release_value();
+
+    auto page_buffer = TRY(ByteBuffer::create_uninitialized(PAGE_SIZE));
+    auto nread = TRY(read_for_page_cache_locked(page_index * PAGE_SIZE, page_buffer.bytes()));
+    if (page.has_value()) {
+        PageCache::the().replace_contents(m_cached_pages, page_index, page_buffer.bytes().trim(nread));
+        page->valid_bytes = nread;
+        return page.release_value();
+    }
+    return PageCache::the().add(m_cached_pages, page_index, page_buffer.bytes().trim(nread));
+}
+
+ErrorOr<size_t> Inode::read_bytes_through_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer, u64 file_size) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (static_cast<u64>(offset) >= file_size)
+        return 0;
+
+    size_t length_to_read = min<u64>(length, file_size - offset);
+    size_t nread = 0;
+    while (nread < length_to_read) {
+        u64 position = offset + nread;
+        auto page = TRY(cached_page_locked(position / PAGE_SIZE, file_size));
+        size_t offset_in_page = position % PAGE_SIZE;
+        if (offset_in_page >= page.valid_bytes)
+            break;
+        size_t chunk_size = min(length_to_read - nread, page.valid_bytes - offset_in_page);
+        auto chunk_buffer = buffer.offset(nread);
+        TRY(page.read(offset_in_page, chunk_buffer, chunk_size));
+        nread += chunk_size;
+    }
+    return nread;
+}
+
+void Inode::start_read_ahead(u64 offset, size_t length) const
+{
+    // Read-ahead is only a hint, so we don't mind dropping it if there's no memory to queue it.
+    (void)g_read_ahead_work->try_queue([inode = NonnullRefPtr<Inode const>(*this), offset, length] {
+        auto file_size = inode->size();
+        if (offset >= file_size)
+            return;
+        MutexLocker locker(inode->m_inode_lock, Mutex::Mode::Shared);
+        if (auto result = inode->read_ahead_locked(offset, min<u64>(length, file_size - offset)); result.is_error())
+            dbgln_if(READ_AHEAD_DEBUG, "Inode {}: Read-ahead of {} bytes at {} failed: {}", inode->identifier(), length, offset, result.error());
+    });
+}
+
+ErrorOr<void> Inode::read_ahead_locked(u64 offset, size_t length) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(length > 0);
+
+    u64 first_page_index = offset / PAGE_SIZE;
+    u64 last_page_index = (offset + length - 1) / PAGE_SIZE;
+    auto buffer = TRY(ByteBuffer::create_uninitialized(min<u64>(last_page_index - first_page_index + 1, max_pages_per_read_ahead_request) * PAGE_SIZE));
+
+    u64 page_index = first_page_index;
+    while (page_index <= last_page_index) {
+        if (PageCache::the().contains(m_cached_pages, page_index)) {
+            ++page_index;
+            continue;
+        }
+
+        // Read each run of uncached pages with a single request, so the file system can fetch it in large batches.
+        size_t run_page_count = 1;
+        while (run_page_count < max_pages_per_read_ahead_request && page_index + run_page_count <= last_page_index && !PageCache::the().contains(m_cached_pages, page_index + run_page_count))
+            ++run_page_count;
+
+        auto run = buffer.bytes().trim(run_page_count * PAGE_SIZE);
+        auto nread = TRY(read_for_page_cache_locked(page_index * PAGE_SIZE, run));
+        for (size_t offset_in_run = 0; offset_in_run < nread; offset_in_run += PAGE_SIZE)
+            TRY(PageCache::the().add(m_cached_pages, page_index + offset_in_run / PAGE_SIZE, run.slice(offset_in_run, min(PAGE_SIZE, nread - offset_in_run))));
+
+        // We ran into the end of the file.
+        if (nread < run.size())
+            break;
+        page_index += run_page_count;
+    }
+    return {};
+}
+
+ErrorOr<Optional<CachedPageReference>> Inode::read_page_through_page_cache(u64 page_index, size_t cluster_page_count) const
+{
+    VERIFY(cluster_page_count > 0);
+    if (!fs().supports_page_cache())
+        return ENOTSUP;
+    auto metadata = this->metadata();
+    if (!metadata.is_regular_file())
+        return ENOTSUP;
+
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (page_index * PAGE_SIZE >= metadata.size)
+        return Optional<CachedPageReference> {};
+
+    if (cluster_page_count > 1 && !PageCache::the().contains(m_cached_pages, page_index)) {
+        u64 cluster_offset = (page_index - page_index % cluster_page_count) * PAGE_SIZE;
+        auto cluster_length = min<u64>(cluster_page_count * PAGE_SIZE, metadata.size - cluster_offset);
+        // NOTE: The rest of the cluster is only a bonus, so if reading it fails, we still try to read the page itself below.
+        if (auto result = read_ahead_locked(cluster_offset, cluster_length); result.is_error())
+            dbgln_if(READ_AHEAD_DEBUG, "Inode {}: Reading the cluster around page {} failed: {}", identifier(), page_index, result.error());
+    }
+    return TRY(cached_page_locked(page_index, metadata.size));
+}
+
+void Inode::collect_cached_pages(u64 first_page_index, size_t page_count, Vector<CachedPageReference>& pages) const
+{
+    if (!fs().supports_page_cache())
+        return;
+
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    auto file_size = size();
+    for (u64 page_index = first_page_index; page_index < first_page_index + page_count; ++page_index) {
+        if (page_index * PAGE_SIZE >= file_size || pages.size() == pages.capacity())
+            break;
+        auto page = PageCache::the().find(m_cached_pages, page_index);
+        if (!page.has_value())
+            continue;
+        // Same as in cached_page_locked(), a page that was cut short by an earlier end of the file is stale.
+        if (page->valid_bytes != PAGE_SIZE && page_index * PAGE_SIZE + page->valid_bytes < file_size)
+            continue;
+        pages.unchecked_append(page.release_value());
+    }
+}
+
+void Inode::remove_cached_pages_after_truncation(u64 size)
+{
+    // NOTE: The page that now holds the end of the file goes as well, so nothing past the new end
+    //       can show up again if the file grows later.
+    PageCache::the().remove_all_from(m_cached_pages, size / PAGE_SIZE);
+}
+
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
 {
     auto remaining_length = length;
@@ -214,6 +432,9 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    if (fs().supports_name_cache())
+        NameCache::the().invalidate(*this, name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -221,6 +442,9 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    if (fs().supports_name_cache())
+        NameCache::the().invalidate(*this, name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
@@ -231,6 +455,21 @@ void Inode::did_remove_child(InodeIdentifier, StringView name)
     });
 }
 
+void Inode::did_replace_child(InodeIdentifier, StringView name)
+{
+    if (fs().supports_name_cache())
+        NameCache::the().invalidate(*this, name);
+
+    if (name == "." || name == "..")
+        return;
+
+    // To watchers, this looks the same as removing the old entry and then adding the new one.
+    m_watchers.for_each([&](auto& watcher) {
+        watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildDeleted, name);
+        watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
+    });
+}
+
 void Inode::did_modify_contents()
 {
     // FIXME: What happens if this fails?
@@ -245,6 +484,11 @@ void Inode::did_modify_contents()
 
 void Inode::did_delete_self()
 {
+    // A deleted directory is still the parent of its "." and ".." entries, and of any names that were looked up in it
+    // but not found. Those entries would keep it alive forever, since nobody can look them up again.
+    if (fs().supports_name_cache() && is_directory())
+        NameCache::the().invalidate_all_children_of(*this);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::Deleted);
     });
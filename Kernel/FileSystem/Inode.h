@@ -15,6 +15,7 @@
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/InodeIdentifier.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/PageCache.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
@@ -57,6 +58,14 @@ public:
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
     ErrorOr<size_t> read_until_filled_or_end(off_t, size_t, UserOrKernelBuffer buffer, OpenFileDescription*) const;
 
+    // Returns the PageCache's copy of the given page, or nothing if the page lies past the end of the file.
+    // If the page isn't cached yet, the whole aligned cluster of `cluster_page_count` pages around it is read in.
+    // Fails with ENOTSUP if the contents of this inode aren't kept in the PageCache.
+    ErrorOr<Optional<CachedPageReference>> read_page_through_page_cache(u64 page_index, size_t cluster_page_count = 1) const;
+    // Appends the pages in the range that are cached and up to date, without reading anything, as long as the vector has capacity left.
+    void collect_cached_pages(u64 first_page_index, size_t page_count, Vector<CachedPageReference>&) const;
+    void remove_cached_pages_after_truncation(u64 size);
+
     virtual ErrorOr<void> attach(OpenFileDescription&) { return {}; }
     virtual void detach(OpenFileDescription&) { }
     virtual void did_seek(OpenFileDescription&, off_t) { }
@@ -94,7 +103,7 @@ public:
     LockRefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
     static void sync_all();
-    void sync();
+    ErrorOr<void> sync();
 
     bool has_watchers() const;
 
@@ -116,6 +125,7 @@ protected:
 
     void did_add_child(InodeIdentifier child_id, StringView);
     void did_remove_child(InodeIdentifier child_id, StringView);
+    void did_replace_child(InodeIdentifier child_id, StringView);
     void did_modify_contents();
     void did_delete_self();
 
@@ -124,9 +134,23 @@ protected:
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) = 0;
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
 
+    // Reads file data into the page cache. File systems that cache device blocks should bypass that cache here,
+    // since the data is about to be cached in the inode's own pages.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const { return read_bytes_locked(offset, count, buffer, nullptr); }
+
 private:
     ErrorOr<bool> try_apply_flock(Process const&, OpenFileDescription const&, flock const&);
 
+    ErrorOr<size_t> read_for_page_cache_locked(u64 offset, Bytes buffer) const;
+    ErrorOr<CachedPageReference> cached_page_locked(u64 page_index, u64 file_size) const;
+    ErrorOr<size_t> read_bytes_through_page_cache_locked(off_t, size_t, UserOrKernelBuffer&, u64 file_size) const;
+    ErrorOr<size_t> write_bytes_and_update_cached_pages_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
+    void write_into_cached_pages_locked(u64 offset, ReadonlyBytes);
+    void start_read_ahead(u64 offset, size_t length) const;
+    // Fills each run of uncached pages in the range with a single read_bytes_for_page_cache_locked() call,
+    // which is where the file system gets to batch the device requests.
+    ErrorOr<void> read_ahead_locked(u64 offset, size_t length) const;
+
     FileSystem& m_file_system;
     InodeIndex m_index { 0 };
     LockWeakPtr<Memory::SharedInodeVMObject> m_shared_vmobject;
@@ -134,6 +158,7 @@ private:
     SpinlockProtected<HashTable<InodeWatcher*>, LockRank::None> m_watchers {};
     bool m_metadata_dirty { false };
     RefPtr<FIFO> m_fifo;
+    mutable CachedPageSet m_cached_pages;
     IntrusiveListNode<Inode> m_inode_list_node;
 
     struct Flock {
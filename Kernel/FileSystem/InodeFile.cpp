@@ -96,6 +96,7 @@ ErrorOr<NonnullOwnPtr<KString>> InodeFile::pseudo_path(OpenFileDescription const
 ErrorOr<void> InodeFile::truncate(u64 size)
 {
     TRY(m_inode->truncate(size));
+    m_inode->remove_cached_pages_after_truncation(size);
     auto truncated_at = kgettimeofday();
     TRY(m_inode->update_timestamps({}, truncated_at, truncated_at));
     return {};
@@ -103,8 +104,7 @@ ErrorOr<void> InodeFile::truncate(u64 size)
 
 ErrorOr<void> InodeFile::sync()
 {
-    m_inode->sync();
-    return {};
+    return m_inode->sync();
 }
 
 ErrorOr<void> InodeFile::chown(Credentials const& credentials, OpenFileDescription& description, UserID uid, GroupID gid)
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/NameCache.h>
+
+namespace Kernel {
+
+static Singleton<NameCache> s_the;
+
+NameCache& NameCache::the()
+{
+    return s_the;
+}
+
+NameCacheEntry::NameCacheEntry(NonnullRefPtr<Inode> parent, NonnullOwnPtr<KString> name, RefPtr<Inode> child, unsigned hash)
+    : m_parent(move(parent))
+    , m_name(move(name))
+    , m_child(move(child))
+    , m_hash(hash)
+{
+}
+
+NameCacheEntry::~NameCacheEntry() = default;
+
+unsigned NameCache::hash_for(Inode const& parent, StringView name)
+{
+    return pair_int_hash(ptr_hash(&parent), name.hash());
+}
+
+NameCache::Statistics NameCache::statistics() const
+{
+    MutexLocker locker(m_lock);
+    return {
+        .hits = m_hits,
+        .negative_hits = m_negative_hits,
+        .misses = m_misses,
+        .entries = m_entries.size(),
+    };
+}
+
+NameCacheEntry* NameCache::find_locked(Inode const& parent, StringView name, unsigned hash)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    auto it = m_entries.find(hash, [&](NameCacheEntry const* entry) {
+        return entry->m_parent.ptr() == &parent && entry->m_name->view() == name;
+    });
+    if (it == m_entries.end())
+        return nullptr;
+    return *it;
+}
+
+void NameCache::remove_locked(NameCacheEntry& entry, EntryList& removed_entries)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    m_entries.remove(&entry);
+    removed_entries.append(entry);
+}
+
+void NameCache::free_entries(EntryList& entries)
+{
+    // NOTE: Dropping the last reference to an inode can go back into its file system,
+    //       so this must not happen while holding our lock.
+    while (auto* entry = entries.take_first())
+        delete entry;
+}
+
+ErrorOr<NonnullRefPtr<Inode>> NameCache::lookup(Inode& parent, StringView name)
+{
+    if (!parent.fs().supports_name_cache())
+        return parent.lookup(name);
+
+    auto hash = hash_for(parent, name);
+    u64 generation = 0;
+    {
+        MutexLocker locker(m_lock);
+        if (auto* entry = find_locked(parent, name, hash)) {
+            m_lru_list.append(*entry);
+            if (!entry->m_child) {
+                ++m_negative_hits;
+                return ENOENT;
+            }
+            ++m_hits;
+            return *entry->m_child;
+        }
+        ++m_misses;
+        generation = m_generation;
+    }
+
+    auto child_or_error = parent.lookup(name);
+    if (!child_or_error.is_error())
+        add(parent, name, child_or_error.value(), generation);
+    else if (child_or_error.error().code() == ENOENT)
+        add(parent, name, nullptr, generation);
+    return child_or_error;
+}
+
+void NameCache::add(Inode& parent, StringView name, RefPtr<Inode> child, u64 generation)
+{
+    // The cache is only an optimization, so running out of memory here is not an error.
+    auto name_or_error = KString::try_create(name);
+    if (name_or_error.is_error())
+        return;
+    auto* new_entry = new (nothrow) NameCacheEntry(parent, name_or_error.release_value(), move(child), hash_for(parent, name));
+    if (!new_entry)
+        return;
+
+    EntryList removed_entries;
+    {
+        MutexLocker locker(m_lock);
+        if (generation != m_generation || find_locked(parent, name, new_entry->m_hash)) {
+            removed_entries.append(*new_entry);
+        } else if (m_entries.try_set(new_entry).is_error()) {
+            removed_entries.append(*new_entry);
+        } else {
+            m_lru_list.append(*new_entry);
+            while (m_entries.size() > max_entries)
+                remove_locked(*m_lru_list.first(), removed_entries);
+        }
+    }
+    free_entries(removed_entries);
+}
+
+void NameCache::invalidate(Inode& parent, StringView name)
+{
+    EntryList removed_entries;
+    {
+        MutexLocker locker(m_lock);
+        ++m_generation;
+        if (auto* entry = find_locked(parent, name, hash_for(parent, name)))
+            remove_locked(*entry, removed_entries);
+    }
+    free_entries(removed_entries);
+}
+
+void NameCache::invalidate_all_children_of(Inode const& parent)
+{
+    EntryList removed_entries;
+    {
+        MutexLocker locker(m_lock);
+        ++m_generation;
+        for (auto it = m_lru_list.begin(); it != m_lru_list.end();) {
+            auto& entry = *it;
+            ++it;
+            if (entry.m_parent.ptr() == &parent)
+                remove_locked(entry, removed_entries);
+        }
+    }
+    free_entries(removed_entries);
+}
+
+void NameCache::invalidate_all_in(FileSystem const& fs)
+{
+    EntryList removed_entries;
+    {
+        MutexLocker locker(m_lock);
+        ++m_generation;
+        for (auto it = m_lru_list.begin(); it != m_lru_list.end();) {
+            auto& entry = *it;
+            ++it;
+            if (&entry.m_parent->fs() == &fs)
+                remove_locked(entry, removed_entries);
+        }
+    }
+    free_entries(removed_entries);
+}
+
+}
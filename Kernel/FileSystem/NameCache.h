@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashTable.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/RefPtr.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+class NameCacheEntry {
+    AK_MAKE_NONCOPYABLE(NameCacheEntry);
+    AK_MAKE_NONMOVABLE(NameCacheEntry);
+    friend class NameCache;
+
+public:
+    NameCacheEntry(NonnullRefPtr<Inode> parent, NonnullOwnPtr<KString> name, RefPtr<Inode> child, unsigned hash);
+    ~NameCacheEntry();
+
+private:
+    NonnullRefPtr<Inode> m_parent;
+    NonnullOwnPtr<KString> m_name;
+    // Null if the parent is known not to have a child with this name.
+    RefPtr<Inode> m_child;
+    unsigned m_hash { 0 };
+    IntrusiveListNode<NameCacheEntry> m_list_node;
+};
+
+// The NameCache remembers the results of Inode::lookup(), so resolving a path doesn't have
+// to ask the file system about every component again. Names that don't exist are cached
+// as well, since a lot of lookups (think of a compiler going through its include paths)
+// are for files that aren't there.
+//
+// Only file systems whose directories never change behind the VirtualFileSystem's back
+// take part. They report every change through Inode::did_{add,remove,replace}_child(),
+// which drops the affected entry. The least recently used entries are dropped once
+// there are more than max_entries of them.
+class NameCache {
+    AK_MAKE_NONCOPYABLE(NameCache);
+    AK_MAKE_NONMOVABLE(NameCache);
+
+public:
+    static NameCache& the();
+
+    NameCache() = default;
+
+    static constexpr size_t max_entries = 8192;
+
+    struct Statistics {
+        u64 hits { 0 };
+        u64 negative_hits { 0 };
+        u64 misses { 0 };
+        size_t entries { 0 };
+    };
+    Statistics statistics() const;
+
+    // Looks up the name in the parent directory, going to the file system only if the result isn't cached.
+    ErrorOr<NonnullRefPtr<Inode>> lookup(Inode& parent, StringView name);
+
+    void invalidate(Inode& parent, StringView name);
+    // Drops all entries for names in the given directory. Used when it is deleted, since the entries would keep it alive.
+    void invalidate_all_children_of(Inode const& parent);
+    // Drops all entries for directories in the given file system, so it can be unmounted.
+    void invalidate_all_in(FileSystem const&);
+
+private:
+    struct EntryTraits : public DefaultTraits<NameCacheEntry*> {
+        static unsigned hash(NameCacheEntry const* entry) { return entry->m_hash; }
+        static bool equals(NameCacheEntry const* a, NameCacheEntry const* b) { return a == b; }
+    };
+    using EntryList = IntrusiveList<&NameCacheEntry::m_list_node>;
+
+    static unsigned hash_for(Inode const& parent, StringView name);
+    NameCacheEntry* find_locked(Inode const& parent, StringView name, unsigned hash);
+    void remove_locked(NameCacheEntry&, EntryList& removed_entries);
+    void add(Inode& parent, StringView name, RefPtr<Inode> child, u64 generation);
+    static void free_entries(EntryList&);
+
+    mutable Mutex m_lock { "NameCache"sv };
+    HashTable<NameCacheEntry*, EntryTraits> m_entries;
+    // Ordered from least to most recently used.
+    EntryList m_lru_list;
+    // Bumped on every invalidation, so a lookup that raced with a change doesn't cache a stale result.
+    u64 m_generation { 0 };
+
+    u64 m_hits { 0 };
+    u64 m_negative_hits { 0 };
+    u64 m_misses { 0 };
+};
+
+}
@@ -13,6 +13,7 @@
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
+#include <Kernel/FileSystem/EventPoll.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/MountFile.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -53,6 +54,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    remove_from_event_polls();
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -63,6 +65,22 @@ OpenFileDescription::~OpenFileDescription()
         m_inode->remove_flocks_for_description(*this);
 }
 
+void OpenFileDescription::remove_from_event_polls()
+{
+    // An EventPoll interest keeps our file alive, so it has to go away with us. The interests are found through the
+    // file's blocker set, but they can only be removed from their EventPolls once its lock has been released.
+    Vector<NonnullRefPtr<EventPoll>, 4> event_polls;
+    blocker_set().for_each_readiness_observer([&](FileReadinessObserver& observer) {
+        // If we run out of memory here, the EventPoll drops the interest the next time epoll_ctl() is called on it.
+        if (event_polls.try_ensure_capacity(event_polls.size() + 1).is_error())
+            return;
+        if (auto event_poll = observer.event_poll_watching(*this))
+            event_polls.unchecked_append(event_poll.release_nonnull());
+    });
+    for (auto& event_poll : event_polls)
+        event_poll->remove_interests_in(*this);
+}
+
 ErrorOr<void> OpenFileDescription::attach()
 {
     if (m_inode)
@@ -314,6 +332,18 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_event_poll() const
+{
+    return m_file->is_event_poll();
+}
+
+EventPoll* OpenFileDescription::event_poll()
+{
+    if (!is_event_poll())
+        return nullptr;
+    return static_cast<EventPoll*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -499,6 +529,32 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+Optional<OpenFileDescription::ReadAheadRange> OpenFileDescription::did_read_through_page_cache(u64 offset, size_t nread)
+{
+    constexpr size_t initial_read_ahead_window = 4 * PAGE_SIZE;
+    constexpr size_t maximum_read_ahead_window = 64 * PAGE_SIZE;
+
+    return m_state.with([&](auto& state) -> Optional<ReadAheadRange> {
+        bool is_sequential = offset == state.next_sequential_read_offset;
+        state.next_sequential_read_offset = offset + nread;
+        if (!is_sequential) {
+            state.read_ahead_until = 0;
+            state.read_ahead_window = 0;
+            return {};
+        }
+
+        // Start the next batch once the reader got through half of the previous one, so it never has to wait for the disk.
+        u64 end_of_read = offset + nread;
+        if (state.read_ahead_until > end_of_read + state.read_ahead_window / 2)
+            return {};
+
+        state.read_ahead_window = state.read_ahead_window == 0 ? initial_read_ahead_window : min(state.read_ahead_window * 2, maximum_read_ahead_window);
+        u64 start = max(state.read_ahead_until, round_up_to_power_of_two(end_of_read, PAGE_SIZE));
+        state.read_ahead_until = start + state.read_ahead_window;
+        return ReadAheadRange { start, state.read_ahead_window };
+    });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
@@ -15,6 +15,7 @@
 #include <Kernel/FileSystem/InodeMetadata.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
+#include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Memory/VirtualAddress.h>
 
 namespace Kernel {
@@ -24,7 +25,9 @@ public:
     virtual ~OpenFileDescriptionData() = default;
 };
 
-class OpenFileDescription final : public AtomicRefCounted<OpenFileDescription> {
+class OpenFileDescription final
+    : public AtomicRefCounted<OpenFileDescription>
+    , public LockWeakable<OpenFileDescription> {
 public:
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(Custody&);
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(File&);
@@ -63,6 +66,14 @@ public:
 
     bool is_direct() const;
 
+    struct ReadAheadRange {
+        u64 offset { 0 };
+        size_t length { 0 };
+    };
+    // Called after reading through the page cache. While the reads on this description stay sequential,
+    // this returns the next range that should be read ahead, with a window that doubles every time.
+    Optional<ReadAheadRange> did_read_through_page_cache(u64 offset, size_t nread);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -80,6 +91,9 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_poll() const;
+    EventPoll* event_poll();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -136,6 +150,7 @@ private:
     explicit OpenFileDescription(File&);
 
     ErrorOr<void> attach();
+    void remove_from_event_polls();
 
     void evaluate_block_conditions()
     {
@@ -157,6 +172,10 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+
+        u64 next_sequential_read_offset { 0 };
+        u64 read_ahead_until { 0 };
+        size_t read_ahead_window { 0 };
     };
 
     SpinlockProtected<State, LockRank::None> m_state {};
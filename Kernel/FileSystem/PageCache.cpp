@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/PageCache.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/MemoryManager.h>
+
+namespace Kernel {
+
+static Singleton<PageCache> s_the;
+
+// Once fewer than 1/N of all physical pages are left uncommitted, adding a page evicts some old ones.
+static constexpr size_t low_memory_divisor = 32;
+static constexpr size_t low_memory_reclaim_batch_size = 16;
+
+PageCache& PageCache::the()
+{
+    return s_the;
+}
+
+CachedPageSet::~CachedPageSet()
+{
+    PageCache::the().remove_all_from(*this, 0);
+}
+
+ErrorOr<void> CachedPageReference::read(size_t offset_in_page, UserOrKernelBuffer& buffer, size_t count) const
+{
+    return PageCache::copy_from_page(*physical_page, offset_in_page, buffer, count);
+}
+
+ErrorOr<void> PageCache::copy_from_page(Memory::PhysicalPage& physical_page, size_t offset_in_page, UserOrKernelBuffer& buffer, size_t count)
+{
+    VERIFY(offset_in_page + count <= PAGE_SIZE);
+    if (buffer.is_kernel_buffer()) {
+        InterruptDisabler disabler;
+        auto* page = MM.quickmap_page(physical_page);
+        auto result = buffer.write(page + offset_in_page, count);
+        MM.unquickmap_page();
+        return result;
+    }
+
+    // Copying to userspace may fault, so we can't do that with the page quickmapped.
+    u8 bounce_buffer[PAGE_SIZE];
+    {
+        InterruptDisabler disabler;
+        auto* page = MM.quickmap_page(physical_page);
+        memcpy(bounce_buffer, page + offset_in_page, count);
+        MM.unquickmap_page();
+    }
+    return buffer.write(bounce_buffer, count);
+}
+
+void PageCache::copy_into_page(Memory::PhysicalPage& physical_page, size_t offset_in_page, ReadonlyBytes data, size_t zero_fill_until)
+{
+    VERIFY(offset_in_page + data.size() <= PAGE_SIZE);
+    VERIFY(zero_fill_until <= PAGE_SIZE);
+    InterruptDisabler disabler;
+    auto* page = MM.quickmap_page(physical_page);
+    memcpy(page + offset_in_page, data.data(), data.size());
+    auto end_of_data = offset_in_page + data.size();
+    if (zero_fill_until > end_of_data)
+        memset(page + end_of_data, 0, zero_fill_until - end_of_data);
+    MM.unquickmap_page();
+}
+
+void PageCache::free_entries(CachedPageList& entries)
+{
+    while (auto* entry = entries.take_first())
+        delete entry;
+}
+
+PageCache::Statistics PageCache::statistics() const
+{
+    SpinlockLocker locker(m_lock);
+    return {
+        .hits = m_hits,
+        .misses = m_misses,
+        .evictions = m_evictions,
+        .writebacks = m_writebacks,
+        .cached_pages = m_cached_pages,
+        .dirty_pages = m_dirty_pages,
+    };
+}
+
+CachedPage* PageCache::find_locked(CachedPageSet& set, u64 page_index)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    return set.m_pages.find(page_index);
+}
+
+void PageCache::detach_locked(CachedPage& entry)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    auto& set = *entry.m_set;
+    set.m_pages.remove(entry.m_tree_node.key());
+    if (entry.m_dirty) {
+        entry.m_dirty = false;
+        --set.m_dirty_page_count;
+        --m_dirty_pages;
+    }
+    if (entry.m_list_node.is_in_list())
+        entry.m_list_node.remove();
+    entry.m_set = nullptr;
+    --m_cached_pages;
+}
+
+void PageCache::mark_dirty_locked(CachedPage& entry)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    if (entry.m_dirty)
+        return;
+    auto& set = *entry.m_set;
+    entry.m_dirty = true;
+    set.m_dirty_pages.append(entry);
+    ++set.m_dirty_page_count;
+    ++m_dirty_pages;
+}
+
+Optional<CachedPageReference> PageCache::find(CachedPageSet& set, u64 page_index)
+{
+    SpinlockLocker locker(m_lock);
+    auto* entry = find_locked(set, page_index);
+    if (!entry) {
+        ++m_misses;
+        return {};
+    }
+    ++m_hits;
+    entry->m_referenced = true;
+    return CachedPageReference { *entry->m_physical_page, page_index, entry->m_valid_bytes };
+}
+
+bool PageCache::contains(CachedPageSet& set, u64 page_index)
+{
+    SpinlockLocker locker(m_lock);
+    return find_locked(set, page_index) != nullptr;
+}
+
+ErrorOr<CachedPageReference> PageCache::add(CachedPageSet& set, u64 page_index, ReadonlyBytes contents, MarkDirty mark_dirty)
+{
+    VERIFY(contents.size() <= PAGE_SIZE);
+    auto physical_page = TRY(MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No));
+    copy_into_page(*physical_page, 0, contents, PAGE_SIZE);
+
+    CachedPage* new_entry = nullptr;
+    {
+        SpinlockLocker locker(m_lock);
+        new_entry = m_spare_entries.take_first();
+    }
+    if (!new_entry) {
+        new_entry = new (nothrow) CachedPage;
+        if (!new_entry)
+            return ENOMEM;
+    }
+
+    {
+        SpinlockLocker locker(m_lock);
+        if (auto* existing_entry = find_locked(set, page_index)) {
+            m_spare_entries.append(*new_entry);
+            if (mark_dirty == MarkDirty::Yes) {
+                copy_into_page(*existing_entry->m_physical_page, 0, contents, PAGE_SIZE);
+                existing_entry->m_valid_bytes = contents.size();
+                mark_dirty_locked(*existing_entry);
+            }
+            return CachedPageReference { *existing_entry->m_physical_page, page_index, existing_entry->m_valid_bytes };
+        }
+
+        // NOTE: New pages start out unreferenced, so that pages which are only ever read once
+        //       (like a big file being copied) are the first to go.
+        new_entry->m_set = &set;
+        new_entry->m_physical_page = physical_page;
+        new_entry->m_valid_bytes = contents.size();
+        new_entry->m_referenced = false;
+        new_entry->m_dirty = false;
+        set.m_pages.insert(page_index, *new_entry);
+        m_clock_list.append(*new_entry);
+        ++m_cached_pages;
+        if (mark_dirty == MarkDirty::Yes)
+            mark_dirty_locked(*new_entry);
+    }
+
+    reclaim_if_memory_is_low();
+    return CachedPageReference { move(physical_page), page_index, contents.size() };
+}
+
+bool PageCache::write(CachedPageSet& set, u64 page_index, size_t offset_in_page, ReadonlyBytes data, MarkDirty mark_dirty)
+{
+    SpinlockLocker locker(m_lock);
+    auto* entry = find_locked(set, page_index);
+    if (!entry)
+        return false;
+
+    copy_into_page(*entry->m_physical_page, offset_in_page, data, 0);
+    entry->m_valid_bytes = max(entry->m_valid_bytes, offset_in_page + data.size());
+    if (mark_dirty == MarkDirty::Yes)
+        mark_dirty_locked(*entry);
+    return true;
+}
+
+void PageCache::replace_contents(CachedPageSet& set, u64 page_index, ReadonlyBytes contents)
+{
+    VERIFY(contents.size() <= PAGE_SIZE);
+    SpinlockLocker locker(m_lock);
+    auto* entry = find_locked(set, page_index);
+    if (!entry)
+        return;
+    copy_into_page(*entry->m_physical_page, 0, contents, PAGE_SIZE);
+    entry->m_valid_bytes = contents.size();
+}
+
+Optional<CachedPageReference> PageCache::first_dirty_page(CachedPageSet& set)
+{
+    SpinlockLocker locker(m_lock);
+    auto* entry = set.m_dirty_pages.first();
+    if (!entry)
+        return {};
+    return CachedPageReference { *entry->m_physical_page, entry->m_tree_node.key(), entry->m_valid_bytes };
+}
+
+void PageCache::collect_dirty_pages(CachedPageSet& set, Vector<CachedPageReference>& pages)
+{
+    SpinlockLocker locker(m_lock);
+    for (auto& entry : set.m_dirty_pages) {
+        if (pages.size() == pages.capacity())
+            break;
+        pages.unchecked_append(CachedPageReference { *entry.m_physical_page, entry.m_tree_node.key(), entry.m_valid_bytes });
+    }
+}
+
+bool PageCache::is_dirty(CachedPageSet& set, u64 page_index)
+{
+    SpinlockLocker locker(m_lock);
+    auto* entry = find_locked(set, page_index);
+    return entry && entry->m_dirty;
+}
+
+void PageCache::mark_clean(CachedPageSet& set, u64 page_index)
+{
+    SpinlockLocker locker(m_lock);
+    auto* entry = find_locked(set, page_index);
+    if (!entry || !entry->m_dirty)
+        return;
+    entry->m_dirty = false;
+    --set.m_dirty_page_count;
+    --m_dirty_pages;
+    m_clock_list.append(*entry);
+}
+
+void PageCache::did_write_back_pages(size_t count)
+{
+    SpinlockLocker locker(m_lock);
+    m_writebacks += count;
+}
+
+void PageCache::remove(CachedPageSet& set, u64 page_index)
+{
+    CachedPageList removed_entries;
+    {
+        SpinlockLocker locker(m_lock);
+        auto* entry = find_locked(set, page_index);
+        if (!entry)
+            return;
+        detach_locked(*entry);
+        removed_entries.append(*entry);
+    }
+    free_entries(removed_entries);
+}
+
+void PageCache::remove_all_from(CachedPageSet& set, u64 first_page_index)
+{
+    CachedPageList removed_entries;
+    {
+        SpinlockLocker locker(m_lock);
+        while (auto* entry = set.m_pages.find_smallest_not_below(first_page_index)) {
+            detach_locked(*entry);
+            removed_entries.append(*entry);
+        }
+    }
+    free_entries(removed_entries);
+}
+
+size_t PageCache::reclaim_clean_pages(size_t page_count)
+{
+    // The MemoryManager may ask us for pages while this processor is in the middle of changing the cache.
+    if (m_lock.is_locked_by_current_processor())
+        return 0;
+
+    SpinlockLocker locker(m_lock);
+    size_t reclaimed_page_count = 0;
+    // Every page gets at most one second chance per call.
+    size_t pages_to_visit = 2 * m_cached_pages;
+    while (reclaimed_page_count < page_count && pages_to_visit-- > 0) {
+        auto* entry = m_clock_list.first();
+        if (!entry)
+            break;
+        if (entry->m_referenced || entry->m_physical_page->ref_count() > 1) {
+            entry->m_referenced = false;
+            m_clock_list.append(*entry);
+            continue;
+        }
+
+        detach_locked(*entry);
+        // NOTE: Freeing the physical page takes the MemoryManager lock, which is fine,
+        //       but the entry itself can't go back to the heap while we hold our lock.
+        entry->m_physical_page = nullptr;
+        m_spare_entries.append(*entry);
+        ++reclaimed_page_count;
+        ++m_evictions;
+    }
+    return reclaimed_page_count;
+}
+
+void PageCache::reclaim_if_memory_is_low()
+{
+    auto system_memory = MM.get_system_memory_info();
+    if (system_memory.physical_pages_uncommitted >= system_memory.physical_pages / low_memory_divisor)
+        return;
+    reclaim_clean_pages(low_memory_reclaim_batch_size);
+}
+
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/IntrusiveList.h>
+#include <AK/IntrusiveRedBlackTree.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Memory/PhysicalPage.h>
+
+namespace Kernel {
+
+class CachedPageSet;
+class PageCache;
+
+class CachedPage {
+    AK_MAKE_NONCOPYABLE(CachedPage);
+    AK_MAKE_NONMOVABLE(CachedPage);
+    friend class CachedPageSet;
+    friend class PageCache;
+
+public:
+    CachedPage() = default;
+
+private:
+    IntrusiveRedBlackTreeNode<u64, CachedPage, RawPtr<CachedPage>> m_tree_node;
+
+    // Clean pages sit on the PageCache's clock list, dirty pages on the dirty list of their set,
+    // and entries that were evicted under memory pressure on the PageCache's list of spare entries.
+    IntrusiveListNode<CachedPage> m_list_node;
+
+    CachedPageSet* m_set { nullptr };
+    RefPtr<Memory::PhysicalPage> m_physical_page;
+    size_t m_valid_bytes { 0 };
+    bool m_referenced { false };
+    bool m_dirty { false };
+};
+
+// A reference to a page in the PageCache.
+// As long as it's held, the physical page can't be evicted, but it may still be removed from the cache.
+struct CachedPageReference {
+    NonnullRefPtr<Memory::PhysicalPage> physical_page;
+    u64 page_index { 0 };
+    size_t valid_bytes { 0 };
+
+    ErrorOr<void> read(size_t offset_in_page, UserOrKernelBuffer&, size_t count) const;
+};
+
+// The pages cached on behalf of one inode or one block device, keyed by page index.
+class CachedPageSet {
+    AK_MAKE_NONCOPYABLE(CachedPageSet);
+    AK_MAKE_NONMOVABLE(CachedPageSet);
+    friend class PageCache;
+
+public:
+    CachedPageSet() = default;
+    ~CachedPageSet();
+
+    bool is_empty() const { return m_pages.is_empty(); }
+    size_t dirty_page_count() const { return m_dirty_page_count; }
+
+private:
+    IntrusiveRedBlackTree<&CachedPage::m_tree_node> m_pages;
+    IntrusiveList<&CachedPage::m_list_node> m_dirty_pages;
+    size_t m_dirty_page_count { 0 };
+};
+
+// The PageCache keeps file and block device contents in physical pages, so they can be read
+// again without going to the disk, and so that shared file mappings can map the same pages.
+//
+// There is no fixed size. The cache keeps growing while there are uncommitted physical pages,
+// and the MemoryManager asks it to give clean pages back when it runs out. Victims are chosen
+// with the clock algorithm: a page that was looked up since the hand last passed it gets a
+// second chance, and pages that are mapped somewhere else are skipped.
+//
+// NOTE: The PageCache lock is taken before the MemoryManager lock, never the other way around.
+//       Since kmalloc may call into the MemoryManager while holding its own lock, nothing is
+//       ever allocated or freed on the heap while holding the PageCache lock either.
+class PageCache {
+    AK_MAKE_NONCOPYABLE(PageCache);
+    AK_MAKE_NONMOVABLE(PageCache);
+    friend struct CachedPageReference;
+
+public:
+    static PageCache& the();
+
+    PageCache() = default;
+
+    struct Statistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 writebacks { 0 };
+        size_t cached_pages { 0 };
+        size_t dirty_pages { 0 };
+    };
+    Statistics statistics() const;
+
+    Optional<CachedPageReference> find(CachedPageSet&, u64 page_index);
+    bool contains(CachedPageSet&, u64 page_index);
+
+    enum class MarkDirty {
+        No,
+        Yes,
+    };
+
+    // Copies the given contents into a new page, zero-filling the rest of it.
+    // If someone else cached the page in the meantime, their page is returned instead.
+    ErrorOr<CachedPageReference> add(CachedPageSet&, u64 page_index, ReadonlyBytes contents, MarkDirty = MarkDirty::No);
+
+    // Copies the data into the page if it's cached, and returns whether it was.
+    bool write(CachedPageSet&, u64 page_index, size_t offset_in_page, ReadonlyBytes, MarkDirty);
+    // Replaces the whole contents of the page if it's cached.
+    void replace_contents(CachedPageSet&, u64 page_index, ReadonlyBytes contents);
+
+    Optional<CachedPageReference> first_dirty_page(CachedPageSet&);
+    // Appends references to the dirty pages of the set to the vector, as long as it has capacity left.
+    void collect_dirty_pages(CachedPageSet&, Vector<CachedPageReference>&);
+    bool is_dirty(CachedPageSet&, u64 page_index);
+    void mark_clean(CachedPageSet&, u64 page_index);
+    void did_write_back_pages(size_t count);
+
+    void remove(CachedPageSet&, u64 page_index);
+    void remove_all_from(CachedPageSet&, u64 first_page_index);
+
+    // Gives up to `page_count` clean, unmapped pages back to the MemoryManager.
+    size_t reclaim_clean_pages(size_t page_count);
+
+private:
+    using CachedPageList = IntrusiveList<&CachedPage::m_list_node>;
+
+    CachedPage* find_locked(CachedPageSet&, u64 page_index);
+    void detach_locked(CachedPage&);
+    void mark_dirty_locked(CachedPage&);
+    static ErrorOr<void> copy_from_page(Memory::PhysicalPage&, size_t offset_in_page, UserOrKernelBuffer&, size_t count);
+    static void copy_into_page(Memory::PhysicalPage&, size_t offset_in_page, ReadonlyBytes, size_t zero_fill_until);
+    static void free_entries(CachedPageList&);
+    void reclaim_if_memory_is_low();
+
+    mutable RecursiveSpinlock<LockRank::None> m_lock {};
+    CachedPageList m_clock_list;
+    CachedPageList m_spare_entries;
+
+    u64 m_hits { 0 };
+    u64 m_misses { 0 };
+    u64 m_evictions { 0 };
+    u64 m_writebacks { 0 };
+    size_t m_cached_pages { 0 };
+    size_t m_dirty_pages { 0 };
+};
+
+}
@@ -27,6 +27,7 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto huge_pages = MM.huge_page_statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -37,6 +38,25 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("huge_pages_mapped"sv, huge_pages.pages_mapped));
+    TRY(json.add("huge_page_allocations"sv, huge_pages.allocations));
+    TRY(json.add("huge_page_allocation_failures"sv, huge_pages.allocation_failures));
+    TRY(json.add("huge_page_splits"sv, huge_pages.splits));
+
+    auto per_processor_array = TRY(json.add_array("kmalloc_per_processor"sv));
+    for (u32 processor_id = 0; processor_id < Processor::count(); ++processor_id) {
+        kmalloc_processor_stats processor_stats;
+        get_kmalloc_processor_stats(processor_id, processor_stats);
+        auto processor_object = TRY(per_processor_array.add_object());
+        TRY(processor_object.add("kmalloc_call_count"sv, processor_stats.kmalloc_call_count));
+        TRY(processor_object.add("kfree_call_count"sv, processor_stats.kfree_call_count));
+        TRY(processor_object.add("magazine_hits"sv, processor_stats.magazine_hits));
+        TRY(processor_object.add("magazine_refills"sv, processor_stats.magazine_refills));
+        TRY(processor_object.add("magazine_drains"sv, processor_stats.magazine_drains));
+        TRY(processor_object.add("cached_bytes"sv, processor_stats.cached_bytes));
+        TRY(processor_object.finish());
+    }
+    TRY(per_processor_array.finish());
     TRY(json.finish());
     return {};
 }
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/NameCache.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/NameCache.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSNameCache::SysFSNameCache(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSNameCache> SysFSNameCache::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSNameCache(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSNameCache::try_generate(KBufferBuilder& builder)
+{
+    auto statistics = NameCache::the().statistics();
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("entries"sv, statistics.entries));
+    TRY(json.add("hits"sv, statistics.hits));
+    TRY(json.add("negative_hits"sv, statistics.negative_hits));
+    TRY(json.add("misses"sv, statistics.misses));
+    TRY(json.finish());
+    return {};
+}
+
+}
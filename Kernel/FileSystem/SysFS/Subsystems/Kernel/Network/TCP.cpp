@@ -41,6 +41,17 @@ ErrorOr<void> SysFSNetworkTCPStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("bytes_in"sv, socket.bytes_in()));
         TRY(obj.add("packets_out"sv, socket.packets_out()));
         TRY(obj.add("bytes_out"sv, socket.bytes_out()));
+        auto const& congestion_control = socket.congestion_control();
+        TRY(obj.add("congestion_control"sv, congestion_control.name()));
+        TRY(obj.add("cwnd"sv, congestion_control.congestion_window()));
+        TRY(obj.add("ssthresh"sv, congestion_control.slow_start_threshold()));
+        TRY(obj.add("srtt_us"sv, socket.smoothed_rtt().to_microseconds()));
+        TRY(obj.add("rttvar_us"sv, socket.rtt_variation().to_microseconds()));
+        TRY(obj.add("rto_us"sv, socket.retransmission_timeout().to_microseconds()));
+        TRY(obj.add("retransmits"sv, socket.retransmitted_packets()));
+        TRY(obj.add("fast_retransmits"sv, socket.fast_retransmits()));
+        TRY(obj.add("retransmit_timeouts"sv, socket.retransmission_timeouts()));
+        TRY(obj.add("sack_permitted"sv, socket.is_sack_permitted()));
         auto current_process_credentials = Process::current().credentials();
         if (current_process_credentials->is_superuser() || current_process_credentials->uid() == socket.origin_uid()) {
             TRY(obj.add("origin_pid"sv, socket.origin_pid().value()));
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/PageCache.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/PageCache.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSPageCache::SysFSPageCache(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSPageCache> SysFSPageCache::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSPageCache(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSPageCache::try_generate(KBufferBuilder& builder)
+{
+    auto statistics = PageCache::the().statistics();
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("cached_pages"sv, statistics.cached_pages));
+    TRY(json.add("dirty_pages"sv, statistics.dirty_pages));
+    TRY(json.add("hits"sv, statistics.hits));
+    TRY(json.add("misses"sv, statistics.misses));
+    TRY(json.add("evictions"sv, statistics.evictions));
+    TRY(json.add("writebacks"sv, statistics.writebacks));
+    TRY(json.finish());
+    return {};
+}
+
+}
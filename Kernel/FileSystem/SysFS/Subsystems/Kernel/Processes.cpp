@@ -113,6 +113,11 @@ ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
         TRY(process_object.add("amount_purgeable_nonvolatile"sv, amount_purgeable_nonvolatile));
         TRY(process_object.add("dumpable"sv, process.is_dumpable()));
         TRY(process_object.add("kernel"sv, process.is_kernel_process()));
+        auto const& page_fault_counters = process.page_fault_counters();
+        TRY(process_object.add("inode_faults"sv, page_fault_counters.inode_faults.load()));
+        TRY(process_object.add("zero_faults"sv, page_fault_counters.zero_faults.load()));
+        TRY(process_object.add("cow_faults"sv, page_fault_counters.cow_faults.load()));
+        TRY(process_object.add("faulted_around_pages"sv, page_fault_counters.faulted_around_pages.load()));
         auto thread_array = TRY(process_object.add_array("threads"sv));
         TRY(process.try_for_each_thread([&](const Thread& thread) -> ErrorOr<void> {
             SpinlockLocker locker(thread.get_lock());
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSScheduler::SysFSScheduler(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSScheduler> SysFSScheduler::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSScheduler(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSScheduler::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (u32 processor_id = 0; processor_id < Scheduler::scheduled_processor_count(); ++processor_id) {
+        auto statistics = Scheduler::processor_scheduling_statistics(processor_id);
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("processor"sv, processor_id));
+        TRY(obj.add("ready_threads"sv, statistics.ready_thread_count));
+        TRY(obj.add("steals"sv, statistics.steal_count));
+        TRY(obj.add("migrations"sv, statistics.migration_count));
+        TRY(obj.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
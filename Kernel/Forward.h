@@ -19,8 +19,8 @@ class Coredump;
 class Credentials;
 class Custody;
 class Device;
-class DiskCache;
 class DoubleBuffer;
+class EventPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -39,6 +39,7 @@ class LocalSocket;
 class Mutex;
 class MasterPTY;
 class Mount;
+class PageCache;
 class PerformanceEventBuffer;
 class ProcFS;
 class ProcFSInode;
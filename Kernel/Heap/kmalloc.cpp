@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -223,6 +224,22 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static constexpr size_t SLABHEAP_COUNT = 6;
+
+// A stack of free slabs of one size class, owned by a single processor.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    // Refills and drains move half a magazine at once, so that a processor that keeps allocating
+    // and freeing around the boundary doesn't go to the global heap every time.
+    static constexpr size_t batch_size = capacity / 2;
+
+    bool is_empty() const { return count == 0; }
+    bool is_full() const { return count == capacity; }
+
+    void* objects[capacity];
+    size_t count { 0 };
+};
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -277,6 +294,45 @@ struct KmallocGlobalData {
         return allocate(size, alignment, caller_will_initialize_memory);
     }
 
+    Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    Optional<size_t> slabheap_index_for_deallocation(size_t size) const
+    {
+        for (size_t i = 0; i < SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    void refill_magazine(size_t slabheap_index, KmallocMagazine& magazine)
+    {
+        VERIFY(!expansion_in_progress);
+        auto& slabheap = slabheaps[slabheap_index];
+        // NOTE: The slabs are scrubbed when they're handed out of the magazine.
+        while (magazine.count < KmallocMagazine::batch_size) {
+            auto* ptr = slabheap.allocate(slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+            if (!ptr)
+                break;
+            magazine.objects[magazine.count++] = ptr;
+        }
+    }
+
+    void drain_magazine(size_t slabheap_index, KmallocMagazine& magazine, size_t count)
+    {
+        VERIFY(!expansion_in_progress);
+        VERIFY(count <= magazine.count);
+        for (size_t i = 0; i < count; ++i)
+            slabheaps[slabheap_index].deallocate(magazine.objects[--magazine.count]);
+    }
+
     void deallocate(void* ptr, size_t size)
     {
         VERIFY(!expansion_in_progress);
@@ -412,7 +468,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -420,11 +476,99 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
+// Calls made before the boot processor was initialized, or on behalf of no processor in particular.
 static size_t g_kmalloc_call_count;
 static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Most kmalloc() and kfree() calls for slab-sized objects are served from magazines of the current
+// processor, without taking the global kmalloc lock. This is only touched by its own processor,
+// with interrupts disabled.
+struct KmallocPerProcessorData {
+    void* allocate(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+    {
+#ifdef HAS_ADDRESS_SANITIZER
+        // The slabheaps keep the shadow memory up to date, so let them see every allocation.
+        (void)size;
+        (void)alignment;
+        (void)caller_will_initialize_memory;
+        return nullptr;
+#else
+        auto slabheap_index = g_kmalloc_global->slabheap_index_for_allocation(size, alignment);
+        if (!slabheap_index.has_value())
+            return nullptr;
+
+        auto& magazine = magazines[*slabheap_index];
+        if (magazine.is_empty()) {
+            SpinlockLocker lock(s_lock);
+            g_kmalloc_global->refill_magazine(*slabheap_index, magazine);
+            ++magazine_refills;
+            if (magazine.is_empty())
+                return nullptr;
+        } else {
+            ++magazine_hits;
+        }
+
+        auto* ptr = magazine.objects[--magazine.count];
+        if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, KMALLOC_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+        return ptr;
+#endif
+    }
+
+    bool deallocate(void* ptr, size_t size)
+    {
+#ifdef HAS_ADDRESS_SANITIZER
+        (void)ptr;
+        (void)size;
+        return false;
+#else
+        auto slabheap_index = g_kmalloc_global->slabheap_index_for_deallocation(size);
+        if (!slabheap_index.has_value())
+            return false;
+        VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+        auto& magazine = magazines[*slabheap_index];
+        if (magazine.is_full()) {
+            SpinlockLocker lock(s_lock);
+            g_kmalloc_global->drain_magazine(*slabheap_index, magazine, KmallocMagazine::batch_size);
+            ++magazine_drains;
+        }
+
+        memset(ptr, KFREE_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+        magazine.objects[magazine.count++] = ptr;
+        return true;
+#endif
+    }
+
+    size_t cached_bytes() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < SLABHEAP_COUNT; ++i)
+            total += magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
+        return total;
+    }
+
+    KmallocMagazine magazines[SLABHEAP_COUNT];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+    size_t magazine_hits { 0 };
+    size_t magazine_refills { 0 };
+    size_t magazine_drains { 0 };
+};
+
+static KmallocPerProcessorData s_per_processor_data[MAX_CPU_COUNT];
+
+// NOTE: Interrupts have to be disabled while using the returned data.
+static KmallocPerProcessorData* current_per_processor_data()
+{
+    if (!Processor::is_initialized())
+        return nullptr;
+    return &s_per_processor_data[Processor::current_id()];
+}
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -449,15 +593,26 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    InterruptDisabler disabler;
+    auto* per_processor_data = current_per_processor_data();
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    void* ptr = nullptr;
+    if (per_processor_data) {
+        ++per_processor_data->kmalloc_call_count;
+        ptr = per_processor_data->allocate(size, alignment, caller_will_initialize_memory);
+    }
+    if (!ptr) {
+        SpinlockLocker lock(s_lock);
+        if (!per_processor_data)
+            ++g_kmalloc_call_count;
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -500,11 +655,19 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto* per_processor_data = current_per_processor_data();
+    if (!per_processor_data) {
+        SpinlockLocker lock(s_lock);
+        ++g_kfree_call_count;
+        g_kmalloc_global->deallocate(ptr, size);
+        return;
+    }
+
+    ++per_processor_data->kfree_call_count;
+    ++per_processor_data->nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (per_processor_data->nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -514,8 +677,11 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (!per_processor_data->deallocate(ptr, size)) {
+        SpinlockLocker lock(s_lock);
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --per_processor_data->nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -604,4 +770,26 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+
+    // NOTE: The per-processor counters are read without synchronization, so they may be slightly behind.
+    for (auto const& per_processor_data : s_per_processor_data) {
+        auto cached_bytes = per_processor_data.cached_bytes();
+        // Slabs sitting in a magazine are allocated as far as the slabheaps are concerned.
+        stats.bytes_allocated -= min(cached_bytes, stats.bytes_allocated);
+        stats.bytes_free += cached_bytes;
+        stats.kmalloc_call_count += per_processor_data.kmalloc_call_count;
+        stats.kfree_call_count += per_processor_data.kfree_call_count;
+    }
+}
+
+void get_kmalloc_processor_stats(u32 processor_id, kmalloc_processor_stats& stats)
+{
+    VERIFY(processor_id < MAX_CPU_COUNT);
+    auto const& per_processor_data = s_per_processor_data[processor_id];
+    stats.kmalloc_call_count = per_processor_data.kmalloc_call_count;
+    stats.kfree_call_count = per_processor_data.kfree_call_count;
+    stats.magazine_hits = per_processor_data.magazine_hits;
+    stats.magazine_refills = per_processor_data.magazine_refills;
+    stats.magazine_drains = per_processor_data.magazine_drains;
+    stats.cached_bytes = per_processor_data.cached_bytes();
 }
@@ -55,6 +55,16 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+struct kmalloc_processor_stats {
+    size_t kmalloc_call_count;
+    size_t kfree_call_count;
+    size_t magazine_hits;
+    size_t magazine_refills;
+    size_t magazine_drains;
+    size_t cached_bytes;
+};
+void get_kmalloc_processor_stats(u32 processor_id, kmalloc_processor_stats&);
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
@@ -276,6 +276,32 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_allocate_committed_huge_page(Badge<Region>, size_t first_page_index)
+{
+    VERIFY(first_page_index + PAGES_PER_HUGE_PAGE <= page_count());
+    SpinlockLocker locker(m_lock);
+
+    if (!m_unused_committed_pages.has_value())
+        return false;
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto const& page = physical_pages()[first_page_index + i];
+        if (!page || !page->is_lazy_committed_page())
+            return false;
+    }
+
+    auto block = m_unused_committed_pages->try_take_huge_page_block();
+    if (!block.has_value())
+        return false;
+
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        physical_pages()[first_page_index + i] = PhysicalPage::create(block->offset(i * PAGE_SIZE));
+        // Nobody else can have seen these pages yet, so there's nothing to copy on write.
+        if (!m_cow_map.is_null())
+            m_cow_map.set(first_page_index + i, false);
+    }
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
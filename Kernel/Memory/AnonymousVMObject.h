@@ -26,6 +26,9 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    // Replaces PAGES_PER_HUGE_PAGE lazily committed pages with one physically contiguous, huge page aligned block.
+    // Returns false if any of the pages was already faulted in, or if there's no such block available.
+    bool try_allocate_committed_huge_page(Badge<Region>, size_t first_page_index);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
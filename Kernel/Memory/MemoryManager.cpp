@@ -13,6 +13,7 @@
 #include <Kernel/Boot/BootInfo.h>
 #include <Kernel/Boot/Multiboot.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/PageCache.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
@@ -52,6 +53,9 @@ ErrorOr<FlatPtr> page_round_up(FlatPtr x)
     return (((FlatPtr)(x)) + PAGE_SIZE - 1) & (~(PAGE_SIZE - 1));
 }
 
+// How many pages to take back from the page cache at once when we run out of free pages.
+static constexpr size_t page_cache_reclaim_batch_size = 32;
+
 // NOTE: We can NOT use Singleton for this class, because
 // MemoryManager::initialize is called *before* global constructors are
 // run. If we do, then Singleton would get re-initialized, causing
@@ -638,6 +642,10 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    if (pde.is_huge())
+        return nullptr;
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -652,7 +660,11 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
-    if (pde.is_present())
+    bool is_huge = false;
+#if ARCH(X86_64)
+    is_huge = pde.is_huge();
+#endif
+    if (pde.is_present() && !is_huge)
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
     bool did_purge = false;
@@ -669,8 +681,31 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         pd = quickmap_pd(page_directory, page_directory_table_index);
         VERIFY(&pde == &pd[page_directory_index]); // Sanity check
 
-        VERIFY(!pde.is_present()); // Should have not changed
+        VERIFY(pde.is_present() == is_huge); // Should have not changed
     }
+
+#if ARCH(X86_64)
+    if (is_huge) {
+        // Someone wants to change a single page inside a huge page, so split it up into a page table
+        // that maps all the pages the same way the huge page did.
+        auto* page_table_entries = quickmap_pt(page_table->paddr());
+        for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+            auto& pte = page_table_entries[i];
+            pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+            pte.set_present(true);
+            pte.set_writable(pde.is_writable());
+            pte.set_user_allowed(pde.is_user_allowed());
+            pte.set_write_through(pde.is_write_through());
+            pte.set_cache_disabled(pde.is_cache_disabled());
+            pte.set_global(pde.is_global());
+            pte.set_execute_disabled(pde.is_execute_disabled());
+        }
+        pde.clear();
+        --m_huge_pages_mapped;
+        ++m_huge_page_splits;
+    }
+#endif
+
     pde.set_page_table_base(page_table->paddr().get());
     pde.set_user_allowed(true);
     pde.set_present(true);
@@ -693,6 +728,15 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    if (pde.is_huge()) {
+        // NOTE: Huge pages are only ever made out of pages that belong to a single region, and regions
+        //       are always unmapped as a whole, so the rest of the huge page is about to go as well.
+        pde.clear();
+        --m_huge_pages_mapped;
+        return;
+    }
+#endif
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -716,6 +760,29 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+PageDirectoryEntry* MemoryManager::ensure_huge_pde(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % HUGE_PAGE_SIZE == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    if (pde.is_huge())
+        return &pde;
+#endif
+    if (pde.is_present()) {
+        // NOTE: This matches the leaked ref in MemoryManager::ensure_pte().
+        get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
+        pde.clear();
+    }
+    ++m_huge_pages_mapped;
+    return &pde;
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -929,16 +996,26 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
 ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
-    auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
-        if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
-            dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
-            return ENOMEM;
-        }
+    auto try_to_commit = [&](bool complain) {
+        return m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+            if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
+                if (complain)
+                    dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
+                return ENOMEM;
+            }
 
-        global_data.system_memory_info.physical_pages_uncommitted -= page_count;
-        global_data.system_memory_info.physical_pages_committed += page_count;
-        return CommittedPhysicalPageSet { {}, page_count };
-    });
+            global_data.system_memory_info.physical_pages_uncommitted -= page_count;
+            global_data.system_memory_info.physical_pages_committed += page_count;
+            return CommittedPhysicalPageSet { {}, page_count };
+        });
+    };
+    auto result = try_to_commit(false);
+    if (result.is_error()) {
+        // Pages in the page cache count as uncommitted memory that's in use, so give some of them back and try again.
+        // NOTE: This has to happen without holding the global data lock, see PageCache.
+        PageCache::the().reclaim_clean_pages(page_count);
+        result = try_to_commit(true);
+    }
     if (result.is_error()) {
         Process::for_each_ignoring_jails([&](Process const& process) {
             size_t amount_resident = 0;
@@ -1038,10 +1115,47 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badg
     return page.release_nonnull();
 }
 
+Optional<PhysicalAddress> MemoryManager::allocate_committed_huge_page_block(Badge<CommittedPhysicalPageSet>)
+{
+    auto block = m_global_data.with([&](auto& global_data) -> Optional<PhysicalAddress> {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= PAGES_PER_HUGE_PAGE);
+        for (auto& region : global_data.physical_regions) {
+            auto block = region->take_free_huge_page_block();
+            if (!block.has_value())
+                continue;
+            global_data.system_memory_info.physical_pages_committed -= PAGES_PER_HUGE_PAGE;
+            global_data.system_memory_info.physical_pages_used += PAGES_PER_HUGE_PAGE;
+            return block;
+        }
+        return {};
+    });
+
+    if (!block.has_value()) {
+        ++m_huge_page_allocation_failures;
+        return {};
+    }
+    ++m_huge_page_allocations;
+
+    InterruptDisabler disabler;
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto* ptr = quickmap_page(block->offset(i * PAGE_SIZE));
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return block;
+}
+
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
+    auto page = m_global_data.with([&](auto&) { return find_free_physical_page(false); });
+    if (!page) {
+        // Clean pages that only the page cache holds on to are the cheapest to give up, so they go first.
+        // NOTE: This has to happen without holding the global data lock, see PageCache.
+        if (PageCache::the().reclaim_clean_pages(page_cache_reclaim_batch_size) > 0)
+            page = m_global_data.with([&](auto&) { return find_free_physical_page(false); });
+    }
+
     return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
-        auto page = find_free_physical_page(false);
         bool purged_pages = false;
 
         if (!page) {
@@ -1287,6 +1401,16 @@ void CommittedPhysicalPageSet::uncommit_one()
     MM.uncommit_physical_pages({}, 1);
 }
 
+Optional<PhysicalAddress> CommittedPhysicalPageSet::try_take_huge_page_block()
+{
+    if (m_page_count < PAGES_PER_HUGE_PAGE)
+        return {};
+    auto block = MM.allocate_committed_huge_page_block({});
+    if (block.has_value())
+        m_page_count -= PAGES_PER_HUGE_PAGE;
+    return block;
+}
+
 void MemoryManager::copy_physical_page(PhysicalPage& physical_page, u8 page_buffer[PAGE_SIZE])
 {
     auto* quickmapped_page = quickmap_page(physical_page);
@@ -1319,4 +1443,14 @@ MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
         return global_data.system_memory_info;
     });
 }
+
+MemoryManager::HugePageStatistics MemoryManager::huge_page_statistics() const
+{
+    return {
+        .pages_mapped = m_huge_pages_mapped.load(),
+        .allocations = m_huge_page_allocations.load(),
+        .allocation_failures = m_huge_page_allocation_failures.load(),
+        .splits = m_huge_page_splits.load(),
+    };
+}
 }
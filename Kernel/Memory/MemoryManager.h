@@ -116,6 +116,10 @@ public:
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
     void uncommit_one();
 
+    // Takes PAGES_PER_HUGE_PAGE pages at once if there's a free, suitably aligned block of them.
+    // The caller has to create the PhysicalPages for the returned block.
+    Optional<PhysicalAddress> try_take_huge_page_block();
+
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
 private:
@@ -128,6 +132,7 @@ class MemoryManager {
     friend class Region;
     friend class RegionTree;
     friend class VMObject;
+    friend class Kernel::PageCache;
     friend struct ::KmallocGlobalData;
 
 public:
@@ -164,6 +169,7 @@ public:
     void uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, size_t page_count);
 
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    Optional<PhysicalAddress> allocate_committed_huge_page_block(Badge<CommittedPhysicalPageSet>);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> allocate_contiguous_physical_pages(size_t size);
     void deallocate_physical_page(PhysicalAddress);
@@ -188,6 +194,15 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    struct HugePageStatistics {
+        u64 pages_mapped { 0 };
+        u64 allocations { 0 };
+        u64 allocation_failures { 0 };
+        u64 splits { 0 };
+    };
+
+    HugePageStatistics huge_page_statistics() const;
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -274,6 +289,10 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    // Returns the page directory entry to map the huge page at `vaddr` with, throwing away the page table
+    // that was there before. All pages in that page table have to belong to the caller's region.
+    PageDirectoryEntry* ensure_huge_pde(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -302,6 +321,11 @@ private:
     };
 
     SpinlockProtected<GlobalData, LockRank::None> m_global_data;
+
+    Atomic<u64> m_huge_pages_mapped { 0 };
+    Atomic<u64> m_huge_page_allocations { 0 };
+    Atomic<u64> m_huge_page_allocation_failures { 0 };
+    Atomic<u64> m_huge_page_splits { 0 };
 };
 
 inline bool PhysicalPage::is_shared_zero_page() const
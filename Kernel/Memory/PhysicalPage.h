@@ -11,6 +11,11 @@
 
 namespace Kernel::Memory {
 
+// A huge page is mapped by a single page directory entry instead of a whole page table.
+// Physically, it's still made up of individually refcounted PhysicalPages.
+static constexpr size_t HUGE_PAGE_SIZE = 2 * MiB;
+static constexpr size_t PAGES_PER_HUGE_PAGE = HUGE_PAGE_SIZE / PAGE_SIZE;
+
 enum class MayReturnToFreeList : bool {
     No,
     Yes
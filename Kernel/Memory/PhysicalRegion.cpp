@@ -39,15 +39,19 @@ void PhysicalRegion::initialize_zones()
     size_t remaining_pages = m_pages;
     auto base_address = m_lower;
 
+    auto make_zone = [&](size_t page_count) {
+        m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, page_count)).release_value_but_fixme_should_propagate_errors());
+        base_address = base_address.offset(page_count * PAGE_SIZE);
+        m_usable_zones.append(*m_zones.last());
+        remaining_pages -= page_count;
+    };
+
     auto make_zones = [&](size_t zone_size) -> size_t {
         size_t pages_per_zone = zone_size / PAGE_SIZE;
         size_t zone_count = 0;
         auto first_address = base_address;
         while (remaining_pages >= pages_per_zone) {
-            m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
-            base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
-            m_usable_zones.append(*m_zones.last());
-            remaining_pages -= pages_per_zone;
+            make_zone(pages_per_zone);
             ++zone_count;
         }
         if (zone_count)
@@ -55,8 +59,16 @@ void PhysicalRegion::initialize_zones()
         return zone_count;
     };
 
+    // If the region doesn't start at a huge page boundary, cover the pages up to the next one with zones
+    // that are as large as the alignment allows. Otherwise, none of the large zones could hand out huge pages.
+    size_t pages_until_huge_page_boundary = (HUGE_PAGE_SIZE - (base_address.get() % HUGE_PAGE_SIZE)) % HUGE_PAGE_SIZE / PAGE_SIZE;
+    if (pages_until_huge_page_boundary && remaining_pages >= pages_until_huge_page_boundary + large_zone_size / PAGE_SIZE) {
+        while (base_address.get() % HUGE_PAGE_SIZE)
+            make_zone(1u << count_trailing_zeroes(base_address.get() / PAGE_SIZE));
+    }
+
     // First make 16 MiB zones (with 4096 pages each)
-    m_large_zones = make_zones(large_zone_size);
+    make_zones(large_zone_size);
 
     // Then divide any remaining space into 1 MiB zones (with 256 pages each)
     make_zones(small_zone_size);
@@ -102,6 +114,25 @@ Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(s
     return physical_pages;
 }
 
+Optional<PhysicalAddress> PhysicalRegion::take_free_huge_page_block()
+{
+    auto order = count_trailing_zeroes(PAGES_PER_HUGE_PAGE);
+    for (auto& zone : m_usable_zones) {
+        if (!zone.has_physically_aligned_blocks(order))
+            continue;
+        auto block_base = zone.allocate_block(order);
+        if (!block_base.has_value())
+            continue;
+        if (zone.is_empty()) {
+            // We've exhausted this zone, move it to the full zones list.
+            m_full_zones.append(zone);
+        }
+        VERIFY(block_base->get() % HUGE_PAGE_SIZE == 0);
+        return block_base;
+    }
+    return {};
+}
+
 RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
 {
     if (m_usable_zones.is_empty())
@@ -119,22 +150,28 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
     return PhysicalPage::create(page.value());
 }
 
+PhysicalZone& PhysicalRegion::zone_containing(PhysicalAddress paddr)
+{
+    size_t low = 0;
+    size_t high = m_zones.size();
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (paddr < m_zones[middle]->base())
+            high = middle;
+        else
+            low = middle;
+    }
+    auto& zone = *m_zones[low];
+    VERIFY(zone.contains(paddr));
+    return zone;
+}
+
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
-    auto large_zone_base = lower().get();
-    auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
-
-    size_t zone_index;
-    if (paddr.get() < small_zone_base)
-        zone_index = (paddr.get() - large_zone_base) / large_zone_size;
-    else
-        zone_index = m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
-
-    auto& zone = m_zones[zone_index];
-    VERIFY(zone->contains(paddr));
-    zone->deallocate_block(paddr, 0);
-    if (m_full_zones.contains(*zone))
-        m_usable_zones.append(*zone);
+    auto& zone = zone_containing(paddr);
+    zone.deallocate_block(paddr, 0);
+    if (m_full_zones.contains(zone))
+        m_usable_zones.append(zone);
 }
 
 }
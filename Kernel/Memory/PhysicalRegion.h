@@ -36,6 +36,9 @@ public:
 
     RefPtr<PhysicalPage> take_free_page();
     Vector<NonnullRefPtr<PhysicalPage>> take_contiguous_free_pages(size_t count);
+    // Takes PAGES_PER_HUGE_PAGE free pages that start at a HUGE_PAGE_SIZE aligned address.
+    // The caller is responsible for creating the PhysicalPages.
+    Optional<PhysicalAddress> take_free_huge_page_block();
     void return_page(PhysicalAddress);
 
 private:
@@ -44,9 +47,10 @@ private:
     static constexpr size_t large_zone_size = 16 * MiB;
     static constexpr size_t small_zone_size = 1 * MiB;
 
+    // NOTE: The zones are sorted by their base address.
     Vector<NonnullOwnPtr<PhysicalZone>> m_zones;
 
-    size_t m_large_zones { 0 };
+    PhysicalZone& zone_containing(PhysicalAddress);
 
     PhysicalZone::List m_usable_zones;
     PhysicalZone::List m_full_zones;
@@ -35,6 +35,13 @@ public:
     bool is_empty() const { return available() == 0; }
 
     PhysicalAddress base() const { return m_base_address; }
+
+    // Blocks are aligned to their own size relative to the zone base, so they're only
+    // physically aligned (as huge pages need to be) if the zone base is aligned too.
+    bool has_physically_aligned_blocks(size_t order) const
+    {
+        return (m_base_address.get() % ((2u << order) * ZONE_CHUNK_SIZE)) == 0;
+    }
     bool contains(PhysicalAddress paddr) const
     {
         return paddr >= m_base_address && paddr < m_base_address.offset(m_page_count * PAGE_SIZE);
@@ -21,6 +21,10 @@
 
 namespace Kernel::Memory {
 
+// A fault on a file-backed page that isn't cached yet reads this many pages around it at once,
+// and the ones around it that are cached already get mapped right away.
+static constexpr size_t fault_around_page_count = 16;
+
 Region::Region()
     : m_range(VirtualRange({}, 0))
 {
@@ -257,6 +261,80 @@ bool Region::map_individual_page_impl(size_t page_index)
     return map_individual_page_impl(page_index, page);
 }
 
+bool Region::may_map_huge_page_at(size_t page_index) const
+{
+#if ARCH(X86_64)
+    if (vaddr_from_page_index(page_index).get() % HUGE_PAGE_SIZE != 0 || page_index + PAGES_PER_HUGE_PAGE > page_count())
+        return false;
+    if (!is_user() || !vmobject().is_anonymous() || !m_cacheable || m_write_combine)
+        return false;
+    if (!is_readable() && !is_writable())
+        return false;
+    return !static_cast<AnonymousVMObject const&>(vmobject()).is_purgeable();
+#else
+    (void)page_index;
+    return false;
+#endif
+}
+
+bool Region::can_map_huge_page_at(size_t page_index) const
+{
+    if (!may_map_huge_page_at(page_index))
+        return false;
+
+    SpinlockLocker vmobject_locker(vmobject().m_lock);
+    auto pages = vmobject().physical_pages().slice(translate_to_vmobject_page(page_index), PAGES_PER_HUGE_PAGE);
+    if (!pages[0] || pages[0]->paddr().get() % HUGE_PAGE_SIZE != 0)
+        return false;
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto const& page = pages[i];
+        if (!page || page->paddr() != pages[0]->paddr().offset(i * PAGE_SIZE))
+            return false;
+        if (page->is_shared_zero_page() || page->is_lazy_committed_page() || should_cow(page_index + i))
+            return false;
+    }
+    return true;
+}
+
+bool Region::map_huge_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!can_map_huge_page_at(page_index))
+        return false;
+
+    auto paddr = physical_page(page_index)->paddr();
+    auto* pde = MM.ensure_huge_pde(*m_page_directory, vaddr_from_page_index(page_index));
+    pde->set_page_table_base(paddr.get());
+    pde->set_huge(true);
+    pde->set_present(true);
+    pde->set_writable(is_writable());
+    pde->set_user_allowed(true);
+    if (Processor::current().has_nx())
+        pde->set_execute_disabled(!is_executable());
+    return true;
+}
+
+bool Region::try_map_huge_page_for_zero_fault(size_t page_index_in_region)
+{
+    auto page_index_in_huge_page = (vaddr_from_page_index(page_index_in_region).get() % HUGE_PAGE_SIZE) / PAGE_SIZE;
+    if (page_index_in_huge_page > page_index_in_region)
+        return false;
+    auto first_page_index = page_index_in_region - page_index_in_huge_page;
+    if (!may_map_huge_page_at(first_page_index))
+        return false;
+
+    // NOTE: If this fails, another thread may have faulted in the whole huge page in the meantime.
+    //       In that case, we still want to map it as one.
+    (void)static_cast<AnonymousVMObject&>(vmobject()).try_allocate_committed_huge_page({}, translate_to_vmobject_page(first_page_index));
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    if (!map_huge_page_impl(first_page_index))
+        return false;
+    MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index), PAGES_PER_HUGE_PAGE);
+    return true;
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage> physical_page)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -310,6 +388,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (map_huge_page_impl(page_index)) {
+            page_index += PAGES_PER_HUGE_PAGE;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -416,6 +498,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (page_in_slot_at_time_of_fault.is_lazy_committed_page() && try_map_huge_page_for_zero_fault(page_index_in_region))
+        return PageFaultResponse::Continue;
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -499,34 +584,55 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
 
     u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
+    RefPtr<PhysicalPage> new_physical_page;
 
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    auto cached_page_or_error = inode.read_page_through_page_cache(page_index_in_vmobject, fault_around_page_count);
+    if (!cached_page_or_error.is_error()) {
+        auto cached_page = cached_page_or_error.release_value();
+        // Note: If the page lies at the end of file or after it, we should return bus error.
+        if (!cached_page.has_value() || cached_page->valid_bytes == 0)
+            return PageFaultResponse::BusError;
+
+        // NOTE: Shared mappings map the cached page itself, which keeps them coherent with read() and write().
+        //       Private mappings may be written to, so they get a copy of it.
+        if (inode_vmobject.is_shared_inode()) {
+            new_physical_page = move(cached_page->physical_page);
+        } else {
+            InterruptDisabler disabler;
+            MM.copy_physical_page(*cached_page->physical_page, page_buffer);
+        }
+    } else if (cached_page_or_error.error().code() == ENOTSUP) {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
-    if (result.is_error()) {
-        dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
-        return PageFaultResponse::ShouldCrash;
-    }
+        if (result.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
+            return PageFaultResponse::ShouldCrash;
+        }
 
-    auto nread = result.value();
-    // Note: If we received 0, it means we are at the end of file or after it,
-    // which means we should return bus error.
-    if (nread == 0)
-        return PageFaultResponse::BusError;
+        auto nread = result.value();
+        // Note: If we received 0, it means we are at the end of file or after it,
+        // which means we should return bus error.
+        if (nread == 0)
+            return PageFaultResponse::BusError;
 
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+        if (nread < PAGE_SIZE) {
+            // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+            memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+        }
+    } else {
+        dmesgln("handle_inode_fault: Error ({}) while reading from inode", cached_page_or_error.error());
+        return PageFaultResponse::ShouldCrash;
     }
 
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
+    if (!new_physical_page) {
+        // Allocate a new physical page, and copy the read inode contents into it.
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error()) {
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
+        }
+        new_physical_page = new_physical_page_or_error.release_value();
         InterruptDisabler disabler;
         u8* dest_ptr = MM.quickmap_page(*new_physical_page);
         memcpy(dest_ptr, page_buffer, PAGE_SIZE);
@@ -552,9 +658,74 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
         return PageFaultResponse::OutOfMemory;
 
+    fault_around_inode_page(page_index_in_region);
     return PageFaultResponse::Continue;
 }
 
+void Region::fault_around_inode_page(size_t page_index_in_region)
+{
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
+
+    auto first_index = max(page_index_in_vmobject - page_index_in_vmobject % fault_around_page_count, first_page_index());
+    auto end_index = min(first_index + fault_around_page_count, first_page_index() + page_count());
+
+    Vector<CachedPageReference> cached_pages;
+    if (cached_pages.try_ensure_capacity(end_index - first_index).is_error())
+        return;
+    inode_vmobject.inode().collect_cached_pages(first_index, end_index - first_index, cached_pages);
+
+    // NOTE: Shared mappings map the cached pages themselves, private ones get copies, just like in handle_inode_fault().
+    Vector<size_t, fault_around_page_count> installed_page_indices;
+    u8 page_buffer[PAGE_SIZE];
+    for (auto& cached_page : cached_pages) {
+        auto& physical_page_slot = inode_vmobject.physical_pages()[cached_page.page_index];
+        {
+            SpinlockLocker locker(inode_vmobject.m_lock);
+            if (!physical_page_slot.is_null())
+                continue;
+        }
+
+        RefPtr<PhysicalPage> new_physical_page;
+        if (inode_vmobject.is_shared_inode()) {
+            new_physical_page = move(cached_page.physical_page);
+        } else {
+            auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+            if (new_physical_page_or_error.is_error())
+                break;
+            new_physical_page = new_physical_page_or_error.release_value();
+            InterruptDisabler disabler;
+            MM.copy_physical_page(*cached_page.physical_page, page_buffer);
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        SpinlockLocker locker(inode_vmobject.m_lock);
+        if (!physical_page_slot.is_null())
+            continue;
+        physical_page_slot = move(new_physical_page);
+        installed_page_indices.unchecked_append(cached_page.page_index - first_page_index());
+    }
+
+    if (installed_page_indices.is_empty())
+        return;
+
+    {
+        SpinlockLocker page_lock(m_page_directory->get_lock());
+        for (auto page_index : installed_page_indices) {
+            // If we can't map one of them, it'll just fault later on.
+            if (!map_individual_page_impl(page_index))
+                break;
+        }
+        auto first_mapped_page_index = first_index - first_page_index();
+        MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_mapped_page_index), end_index - first_index);
+    }
+
+    if (auto* current_thread = Thread::current())
+        current_thread->process().page_fault_counters().faulted_around_pages += installed_page_indices.size();
+}
+
 RefPtr<PhysicalPage> Region::physical_page(size_t index) const
 {
     SpinlockLocker vmobject_locker(vmobject().m_lock);
@@ -227,11 +227,23 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
+    void fault_around_inode_page(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalPage& page_in_slot_at_time_of_fault);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
 
+    // Huge pages are only used for anonymous user memory, and only where a whole huge page aligned
+    // chunk of the region is backed by physically contiguous pages with identical permissions.
+    // NOTE: Kernel memory is not mapped with huge pages. The kernel image is mapped through the Prekernel's static
+    //       page tables, which ensure_huge_pde() can't free, and its sections get different permissions at 4 KiB
+    //       granularity. kmalloc commits its subheaps one page at a time, so they are not physically contiguous.
+    //       There is no direct map of physical memory either, since physical pages are only ever quickmapped.
+    [[nodiscard]] bool may_map_huge_page_at(size_t page_index) const;
+    [[nodiscard]] bool can_map_huge_page_at(size_t page_index) const;
+    [[nodiscard]] bool map_huge_page_impl(size_t page_index);
+    [[nodiscard]] bool try_map_huge_page_for_zero_fault(size_t page_index);
+
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
     size_t m_offset_in_vmobject { 0 };
@@ -431,18 +431,43 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
     Optional<u8> send_window_scale;
+    Optional<u16> peer_maximum_segment_size;
+    bool sack_permitted = false;
     if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
-            if (option.kind() != TCPOptionKind::WindowScale)
+        tcp_packet.for_each_option([&](auto const& option) {
+            switch (option.kind()) {
+            case TCPOptionKind::WindowScale: {
+                if (option.length() != sizeof(TCPOptionWindowScale))
+                    return;
+                auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
+                if (scale > 14)
+                    return; // Maximum allowed as per RFC7323
+                send_window_scale = scale;
+                return;
+            }
+            case TCPOptionKind::MSS:
+                if (option.length() != sizeof(TCPOptionMSS))
+                    return;
+                if (auto mss = static_cast<TCPOptionMSS const&>(option).value(); mss > 0)
+                    peer_maximum_segment_size = mss;
                 return;
-            if (option.length() != sizeof(TCPOptionWindowScale))
+            case TCPOptionKind::SACKPermitted:
+                if (option.length() == sizeof(TCPOptionSACKPermitted))
+                    sack_permitted = true;
                 return;
-            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
-            if (scale > 14)
-                return; // Maximum allowed as per RFC7323
-            send_window_scale = scale;
+            default:
+                return;
+            }
         });
     }
+    auto apply_syn_options = [&](TCPSocket& socket) {
+        if (send_window_scale.has_value())
+            socket.set_send_window_scale(*send_window_scale);
+        if (peer_maximum_segment_size.has_value())
+            socket.set_peer_maximum_segment_size(*peer_maximum_segment_size);
+        if (sack_permitted)
+            socket.set_sack_permitted();
+    };
 
     switch (socket->state()) {
     case TCPSocket::State::Closed:
@@ -470,10 +495,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            apply_syn_options(*client);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                client->set_send_window_scale(*send_window_scale);
             return;
         }
         default:
@@ -485,19 +509,17 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            apply_syn_options(*socket);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            apply_syn_options(*socket);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
             socket->set_connected(true);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
             return;
         case TCPFlags::ACK | TCPFlags::FIN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
@@ -74,7 +74,50 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+struct TCPSACKBlock {
+    u32 left_edge { 0 };
+    u32 right_edge { 0 };
+};
+
+// RFC 2018: A variable number of blocks, each one describing a contiguous
+// range of sequence space that the peer has received out of order.
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    // The option has to fit into the 40 bytes of TCP options, which leaves room for 4 blocks at most.
+    static constexpr size_t max_block_count = 4;
+
+    bool is_valid() const
+    {
+        if (length() < sizeof(TCPOption))
+            return false;
+        auto blocks_size = length() - sizeof(TCPOption);
+        return blocks_size % (2 * sizeof(u32)) == 0 && blocks_size / (2 * sizeof(u32)) <= max_block_count;
+    }
+
+    size_t block_count() const
+    {
+        VERIFY(is_valid());
+        return (length() - sizeof(TCPOption)) / (2 * sizeof(u32));
+    }
+
+    TCPSACKBlock block(size_t index) const
+    {
+        VERIFY(index < block_count());
+        auto const* edges = reinterpret_cast<NetworkOrdered<u32> const*>(reinterpret_cast<u8 const*>(this) + sizeof(TCPOption)) + 2 * index;
+        return { edges[0], edges[1] };
+    }
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
 
 class [[gnu::packed]] TCPPacket {
 public:
@@ -135,6 +178,8 @@ public:
             }
             if (option->length() < sizeof(TCPOption))
                 return; // minimal option length
+            if (option->length() > (size_t)options_end - (size_t)next_option)
+                return; // The option runs past the end of the header
             callback(*option);
             next_option += option->length();
         }
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+static u32 clamp_to_window(u64 window)
+{
+    return static_cast<u32>(min(window, static_cast<u64>(NumericLimits<u32>::max())));
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    // (2^21)^3 is the largest cube of a power of two that fits in a u64.
+    u64 low = 0;
+    u64 high = 1ull << 21;
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(TCPCongestionControlAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case TCPCongestionControlAlgorithm::NewReno:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewReno));
+    case TCPCongestionControlAlgorithm::CUBIC:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPCubic));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControlAlgorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return TCPCongestionControlAlgorithm::NewReno;
+    if (name == "cubic"sv)
+        return TCPCongestionControlAlgorithm::CUBIC;
+    return {};
+}
+
+TCPCongestionControl::TCPCongestionControl()
+{
+    set_maximum_segment_size(m_maximum_segment_size);
+}
+
+void TCPCongestionControl::set_maximum_segment_size(u32 maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    m_maximum_segment_size = maximum_segment_size;
+    // RFC 6928: IW = min(10*MSS, max(2*MSS, 14600))
+    m_congestion_window = min(10 * maximum_segment_size, max(2 * maximum_segment_size, 14600u));
+}
+
+void TCPCongestionControl::inherit_window_from(TCPCongestionControl const& other)
+{
+    m_congestion_window = other.m_congestion_window;
+    m_slow_start_threshold = other.m_slow_start_threshold;
+    m_maximum_segment_size = other.m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_ack(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt)
+{
+    if (m_in_fast_recovery)
+        return;
+
+    if (is_in_slow_start()) {
+        // RFC 5681 section 3.1, with appropriate byte counting (RFC 3465) limited to one segment per ACK.
+        m_congestion_window = clamp_to_window(static_cast<u64>(m_congestion_window) + min(bytes_acknowledged, m_maximum_segment_size));
+        return;
+    }
+
+    grow_in_congestion_avoidance(bytes_acknowledged, now, smoothed_rtt);
+}
+
+void TCPCongestionControl::enter_fast_recovery(u32 bytes_in_flight, MonotonicTime now)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    // Inflate the window by the three segments that have left the network to trigger the duplicate ACKs.
+    m_congestion_window = clamp_to_window(static_cast<u64>(m_slow_start_threshold) + 3 * m_maximum_segment_size);
+    m_in_fast_recovery = true;
+}
+
+void TCPCongestionControl::on_duplicate_ack_in_fast_recovery()
+{
+    VERIFY(m_in_fast_recovery);
+    m_congestion_window = clamp_to_window(static_cast<u64>(m_congestion_window) + m_maximum_segment_size);
+}
+
+void TCPCongestionControl::on_partial_ack(u32 bytes_acknowledged)
+{
+    VERIFY(m_in_fast_recovery);
+    // RFC 6582 section 3.2, step 5: Deflate the window by the amount of new data acknowledged,
+    // then add back one segment if at least one segment worth of data was acknowledged.
+    m_congestion_window -= min(bytes_acknowledged, m_congestion_window);
+    if (bytes_acknowledged >= m_maximum_segment_size)
+        m_congestion_window += m_maximum_segment_size;
+    m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+}
+
+void TCPCongestionControl::exit_fast_recovery()
+{
+    VERIFY(m_in_fast_recovery);
+    m_congestion_window = m_slow_start_threshold;
+    m_in_fast_recovery = false;
+}
+
+void TCPCongestionControl::on_retransmission_timeout(u32 bytes_in_flight, MonotonicTime now)
+{
+    // RFC 5681 section 3.1: Don't lower the threshold again if the retransmitted segment is lost as well.
+    if (m_congestion_window > m_maximum_segment_size)
+        m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    m_congestion_window = m_maximum_segment_size;
+    m_in_fast_recovery = false;
+}
+
+void TCPNewReno::grow_in_congestion_avoidance(u32 bytes_acknowledged, MonotonicTime, Duration)
+{
+    // RFC 5681 section 3.1: Grow by one segment per round trip, i.e. whenever a full window has been acknowledged.
+    m_bytes_acknowledged_in_round += bytes_acknowledged;
+    if (m_bytes_acknowledged_in_round < m_congestion_window)
+        return;
+    m_bytes_acknowledged_in_round -= m_congestion_window;
+    m_congestion_window = clamp_to_window(static_cast<u64>(m_congestion_window) + m_maximum_segment_size);
+}
+
+u32 TCPNewReno::slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime)
+{
+    m_bytes_acknowledged_in_round = 0;
+    return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+u64 TCPCubic::cubic_window_at(i64 milliseconds_since_epoch_start) const
+{
+    // W_cubic(t) = C * (t - K)^3 + W_max, with C = 0.4 segments per second cubed.
+    i64 offset = milliseconds_since_epoch_start - m_time_to_origin_in_milliseconds;
+    // Clamping the distance to 100 seconds keeps the arithmetic below within 64 bits.
+    u64 distance = min(static_cast<u64>(offset < 0 ? -offset : offset), 100'000ull);
+    u64 delta = (distance * distance * distance / 1000) * m_maximum_segment_size * 4 / 10'000'000;
+    if (offset >= 0)
+        return m_origin_window + delta;
+    return delta >= m_origin_window ? 0 : m_origin_window - delta;
+}
+
+void TCPCubic::grow_in_congestion_avoidance(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt)
+{
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        m_reno_friendly_window = m_congestion_window;
+        m_reno_friendly_window_remainder = 0;
+        if (m_congestion_window < m_maximum_window) {
+            // K = cubic_root((W_max - cwnd_epoch) / C), with the windows in segments and K in seconds.
+            u64 difference = m_maximum_window - m_congestion_window;
+            m_time_to_origin_in_milliseconds = static_cast<i64>(integer_cube_root(difference * 2'500'000'000ull / m_maximum_segment_size));
+            m_origin_window = m_maximum_window;
+        } else {
+            m_time_to_origin_in_milliseconds = 0;
+            m_origin_window = m_congestion_window;
+        }
+    }
+
+    // Aim for where the cubic function will be one round trip from now.
+    auto elapsed = (now - *m_epoch_start + smoothed_rtt).to_milliseconds();
+    auto cubic_window = cubic_window_at(elapsed);
+
+    // Reno-friendly region (RFC 9438 section 4.3): alpha = 3 * (1 - beta) / (1 + beta) = 9 / 17.
+    m_reno_friendly_window_remainder += static_cast<u64>(bytes_acknowledged) * 9 * m_maximum_segment_size;
+    u64 divisor = 17 * static_cast<u64>(m_congestion_window);
+    m_reno_friendly_window = clamp_to_window(m_reno_friendly_window + m_reno_friendly_window_remainder / divisor);
+    m_reno_friendly_window_remainder %= divisor;
+    if (cubic_window < m_reno_friendly_window) {
+        m_congestion_window = max(m_congestion_window, m_reno_friendly_window);
+        return;
+    }
+
+    // Never grow by more than half the window per round trip (RFC 9438 section 4.2).
+    auto target = min(cubic_window, static_cast<u64>(m_congestion_window) * 3 / 2);
+    if (target <= m_congestion_window)
+        return;
+    m_congestion_window = clamp_to_window(m_congestion_window + (target - m_congestion_window) * bytes_acknowledged / m_congestion_window);
+}
+
+u32 TCPCubic::slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime)
+{
+    m_epoch_start.clear();
+    // Fast convergence (RFC 9438 section 4.7): Release bandwidth for new flows if the window keeps shrinking.
+    if (m_congestion_window < m_maximum_window)
+        m_maximum_window = static_cast<u32>(static_cast<u64>(m_congestion_window) * 17 / 20);
+    else
+        m_maximum_window = m_congestion_window;
+    // beta_cubic = 0.7
+    return max(static_cast<u32>(static_cast<u64>(bytes_in_flight) * 7 / 10), 2 * m_maximum_segment_size);
+}
+
+}
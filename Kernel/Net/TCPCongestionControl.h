@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+enum class TCPCongestionControlAlgorithm {
+    NewReno,
+    CUBIC,
+};
+
+// A TCPCongestionControl decides how many bytes a TCPSocket may have in flight.
+// The socket reports acknowledged data and detected losses, and the controller
+// maintains the congestion window and slow start threshold (RFC 5681).
+// Subclasses only decide how the window grows in congestion avoidance and how
+// far it shrinks after a loss.
+class TCPCongestionControl {
+public:
+    static constexpr TCPCongestionControlAlgorithm default_algorithm = TCPCongestionControlAlgorithm::CUBIC;
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(TCPCongestionControlAlgorithm);
+    static Optional<TCPCongestionControlAlgorithm> algorithm_from_name(StringView);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual TCPCongestionControlAlgorithm algorithm() const = 0;
+    virtual StringView name() const = 0;
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 maximum_segment_size() const { return m_maximum_segment_size; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+    bool is_in_fast_recovery() const { return m_in_fast_recovery; }
+
+    // Resets the congestion window to the initial window for this segment size (RFC 6928).
+    void set_maximum_segment_size(u32);
+    void inherit_window_from(TCPCongestionControl const&);
+
+    void on_ack(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt);
+
+    // RFC 6582 (NewReno) fast recovery.
+    void enter_fast_recovery(u32 bytes_in_flight, MonotonicTime now);
+    void on_duplicate_ack_in_fast_recovery();
+    void on_partial_ack(u32 bytes_acknowledged);
+    void exit_fast_recovery();
+
+    void on_retransmission_timeout(u32 bytes_in_flight, MonotonicTime now);
+
+protected:
+    TCPCongestionControl();
+
+    virtual void grow_in_congestion_avoidance(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt) = 0;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) = 0;
+
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+    u32 m_maximum_segment_size { 536 };
+    bool m_in_fast_recovery { false };
+};
+
+// RFC 5681 congestion avoidance with RFC 6582 fast recovery.
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::NewReno; }
+    virtual StringView name() const override { return "newreno"sv; }
+
+private:
+    virtual void grow_in_congestion_avoidance(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) override;
+
+    u32 m_bytes_acknowledged_in_round { 0 };
+};
+
+// RFC 9438 CUBIC. The kernel can't use floating point, so the cubic function
+// is evaluated in milliseconds and bytes with C = 0.4 and beta = 0.7 folded
+// into integer ratios.
+class TCPCubic final : public TCPCongestionControl {
+public:
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::CUBIC; }
+    virtual StringView name() const override { return "cubic"sv; }
+
+private:
+    virtual void grow_in_congestion_avoidance(u32 bytes_acknowledged, MonotonicTime now, Duration smoothed_rtt) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) override;
+
+    u64 cubic_window_at(i64 milliseconds_since_epoch_start) const;
+
+    Optional<MonotonicTime> m_epoch_start;
+    u32 m_maximum_window { 0 };
+    u32 m_origin_window { 0 };
+    i64 m_time_to_origin_in_milliseconds { 0 };
+    u32 m_reno_friendly_window { 0 };
+    u64 m_reno_friendly_window_remainder { 0 };
+};
+
+}
@@ -23,6 +23,20 @@
 
 namespace Kernel {
 
+// RFC 6298 section 2.4: Whenever RTO is computed, if it is less than 1 second, then the RTO SHOULD be rounded up to 1 second.
+static constexpr auto minimum_retransmission_timeout = Duration::from_seconds(1);
+static constexpr auto maximum_retransmission_timeout = Duration::from_seconds(60);
+// NetworkTask checks the retransmission timers at least this often.
+static constexpr auto retransmission_timer_granularity = Duration::from_milliseconds(500);
+
+static constexpr size_t maximum_congestion_control_name_length = 16;
+
+// Sequence numbers wrap around, so they have to be compared in modular arithmetic (RFC 9293 section 3.4).
+static bool sequence_number_is_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
     sockets_by_tuple().for_each_shared([&](auto const& it) {
@@ -64,6 +78,14 @@ void TCPSocket::set_state(State new_state)
 
     m_state = new_state;
 
+    if (new_state == State::Established && m_local_maximum_segment_size != 0) {
+        // Both sides have sent their SYN by now, so we know the segment size that the congestion window is counted in.
+        auto maximum_segment_size = m_local_maximum_segment_size;
+        if (m_peer_maximum_segment_size.has_value())
+            maximum_segment_size = min(maximum_segment_size, static_cast<u32>(*m_peer_maximum_segment_size));
+        m_congestion_control->set_maximum_segment_size(maximum_segment_size);
+    }
+
     if (new_state == State::Established && m_direction == Direction::Outgoing) {
         set_role(Role::Connected);
         clear_so_error();
@@ -132,6 +154,7 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const
 
         auto receive_buffer = TRY(try_create_receive_buffer());
         auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        TRY(client->set_congestion_control_algorithm(m_congestion_control->algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -165,10 +188,11 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
-    , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_retransmit_timer_start(TimeManagement::the().monotonic_time())
+    , m_congestion_control(move(congestion_control))
 {
 }
 
@@ -183,7 +207,18 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwn
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(TCPCongestionControl::default_algorithm));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), move(congestion_control)));
+}
+
+ErrorOr<void> TCPSocket::set_congestion_control_algorithm(TCPCongestionControlAlgorithm algorithm)
+{
+    if (m_congestion_control->algorithm() == algorithm)
+        return {};
+    auto congestion_control = TRY(TCPCongestionControl::try_create(algorithm));
+    congestion_control->inherit_window_from(*m_congestion_control);
+    m_congestion_control = move(congestion_control);
+    return {};
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -210,7 +245,7 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    size_t mss = maximum_segment_size(routing_decision);
 
     if (!m_no_delay) {
         // RFC 896 (Nagle’s algorithm): https://www.ietf.org/rfc/rfc0896
@@ -224,11 +259,25 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
             return set_so_error(EAGAIN);
     }
 
-    data_length = min(data_length, mss);
+    // Only send as much as both the peer's receive window and the congestion window allow.
+    size_t window = min(m_send_window_size, m_congestion_control->congestion_window());
+    size_t in_flight = m_unacked_packets.with_shared([&](auto const& packets) { return bytes_in_flight(packets); });
+    if (in_flight >= window)
+        return set_so_error(EAGAIN);
+
+    data_length = min(min(data_length, mss), window - in_flight);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
 
+u32 TCPSocket::maximum_segment_size(RoutingDecision const& routing_decision) const
+{
+    u32 maximum_segment_size = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    if (m_peer_maximum_segment_size.has_value())
+        maximum_segment_size = min(maximum_segment_size, static_cast<u32>(*m_peer_maximum_segment_size));
+    return maximum_segment_size;
+}
+
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
 {
     if (!allow_duplicate && m_last_ack_number_sent == m_ack_number)
@@ -247,7 +296,11 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     bool const has_mss_option = flags & TCPFlags::SYN;
     bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    // Only offer SACK in a SYN-ACK if the peer offered it first (RFC 2018 section 2).
+    bool const has_sack_permitted_option = (flags & TCPFlags::SYN) && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0);
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -282,6 +335,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    u32 const first_sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
@@ -291,6 +345,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     u8* next_option = packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket);
     if (has_mss_option) {
         u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+        m_local_maximum_segment_size = mss;
         TCPOptionMSS mss_option { mss };
         memcpy(next_option, &mss_option, sizeof(mss_option));
         next_option += sizeof(mss_option);
@@ -300,8 +355,12 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
-    if ((options_size % 4) != 0)
-        *next_option = to_underlying(TCPOptionKind::End);
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
+    memset(next_option, to_underlying(TCPOptionKind::End), tcp_header_size - sizeof(TCPPacket) - options_size);
 
     tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
 
@@ -309,7 +368,11 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+            // RFC 6298 section 5.1: Start the timer if it isn't already running.
+            if (unacked_packets.packets.is_empty())
+                m_retransmit_timer_start = now;
+            auto result = unacked_packets.packets.try_append({ first_sequence_number, m_sequence_number, static_cast<u32>(payload_size), packet, ipv4_payload_offset, *routing_decision.adapter, now });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -335,47 +398,211 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        size_t payload_size = size - packet.header_size();
+        auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+
+        u32 send_window_size = packet.window_size();
+        if (!packet.has_syn())
+            send_window_size <<= m_send_window_scale;
+        bool const window_did_change = send_window_size != m_send_window_size;
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
-        int removed = 0;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            if (unacked_packets.packets.is_empty())
+                return;
+
+            // RFC 5681 section 2: An ACK that acknowledges nothing new, carries no data and leaves the window
+            // alone while we have data outstanding is a duplicate, telling us a later segment has arrived.
+            bool const is_duplicate_ack = ack_number == unacked_packets.packets.first().sequence_number
+                && payload_size == 0 && !packet.has_syn() && !packet.has_fin() && !window_did_change;
+
+            int removed = 0;
+            u32 bytes_acknowledged = 0;
+            Optional<Duration> rtt_sample;
             while (!unacked_packets.packets.is_empty()) {
-                auto& packet = unacked_packets.packets.first();
-
-                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
-
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
-                    }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
-                } else {
+                auto& outgoing_packet = unacked_packets.packets.first();
+
+                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", outgoing_packet.ack_number);
+
+                if (sequence_number_is_before(ack_number, outgoing_packet.ack_number))
                     break;
-                }
+
+                auto old_adapter = outgoing_packet.adapter.strong_ref();
+                if (old_adapter)
+                    old_adapter->release_packet_buffer(*outgoing_packet.buffer);
+                // Karn's algorithm: We can't tell which transmission of a retransmitted packet is being acknowledged.
+                if (outgoing_packet.tx_counter == 0)
+                    rtt_sample = now - outgoing_packet.sent_time;
+                unacked_packets.size -= outgoing_packet.payload_size;
+                bytes_acknowledged += outgoing_packet.payload_size;
+                unacked_packets.packets.take_first();
+                removed++;
             }
 
+            if (m_sack_permitted)
+                process_sack_option(packet, unacked_packets);
+
+            if (rtt_sample.has_value())
+                update_retransmission_timeout(*rtt_sample);
+
+            if (removed > 0)
+                did_receive_new_ack(ack_number, bytes_acknowledged, unacked_packets, now);
+            else if (is_duplicate_ack)
+                did_receive_duplicate_ack(unacked_packets, now);
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
+            } else {
+                if (m_sack_permitted && m_congestion_control->is_in_fast_recovery())
+                    mark_packets_below_sacked_data_as_lost(unacked_packets);
+                retransmit_lost_packets(unacked_packets);
             }
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        m_send_window_size = send_window_size;
+        // Either data left the network or the peer opened its window, so there may be room to send again.
+        evaluate_block_conditions();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::did_receive_new_ack(u32 ack_number, u32 bytes_acknowledged, UnackedPackets& unacked_packets, MonotonicTime now)
+{
+    // RFC 6298 section 5.3: Restart the timer whenever new data is acknowledged.
+    m_retransmit_timer_start = now;
+    m_retransmit_attempts = 0;
+    m_duplicate_acks_received = 0;
+
+    if (!m_congestion_control->is_in_fast_recovery()) {
+        m_congestion_control->on_ack(bytes_acknowledged, now, m_smoothed_rtt);
+        return;
+    }
+
+    if (!sequence_number_is_before(ack_number, m_recovery_point)) {
+        // Everything that was outstanding when we noticed the loss has arrived.
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) leaving fast recovery", this);
+        m_congestion_control->exit_fast_recovery();
+        return;
+    }
+
+    // RFC 6582 section 3.2, step 5: A partial acknowledgment means that the next packet was lost too.
+    m_congestion_control->on_partial_ack(bytes_acknowledged);
+    if (!unacked_packets.packets.is_empty() && !unacked_packets.packets.first().is_sacked)
+        unacked_packets.packets.first().is_lost = true;
+}
+
+void TCPSocket::did_receive_duplicate_ack(UnackedPackets& unacked_packets, MonotonicTime now)
+{
+    ++m_duplicate_acks_received;
+
+    if (m_congestion_control->is_in_fast_recovery()) {
+        m_congestion_control->on_duplicate_ack_in_fast_recovery();
+        return;
+    }
+
+    if (m_duplicate_acks_received != duplicate_ack_threshold)
+        return;
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) got {} duplicate ACKs, entering fast recovery", this, m_duplicate_acks_received);
+
+    // RFC 6582 section 3.2, step 2: Remember how far we had sent, so we know when recovery is complete.
+    m_recovery_point = m_sequence_number;
+    m_congestion_control->enter_fast_recovery(bytes_in_flight(unacked_packets), now);
+    for (auto& outgoing_packet : unacked_packets.packets)
+        outgoing_packet.was_retransmitted_in_recovery = false;
+    unacked_packets.packets.first().is_lost = true;
+    ++m_fast_retransmits;
+}
+
+void TCPSocket::process_sack_option(TCPPacket const& packet, UnackedPackets& unacked_packets)
+{
+    packet.for_each_option([&](auto const& option) {
+        if (option.kind() != TCPOptionKind::SACK)
+            return;
+        auto const& sack_option = static_cast<TCPOptionSACK const&>(option);
+        if (!sack_option.is_valid())
+            return;
+        for (size_t i = 0; i < sack_option.block_count(); ++i) {
+            auto block = sack_option.block(i);
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (sequence_number_is_before(outgoing_packet.sequence_number, block.left_edge))
+                    continue;
+                if (sequence_number_is_before(block.right_edge, outgoing_packet.ack_number))
+                    break;
+                outgoing_packet.is_sacked = true;
+                outgoing_packet.is_lost = false;
+            }
+        }
+    });
+}
+
+void TCPSocket::mark_packets_below_sacked_data_as_lost(UnackedPackets& unacked_packets)
+{
+    // RFC 6675: While recovering, a hole below data that the peer has already received has been lost,
+    // so there's no need to wait for the partial acknowledgments to find it one round trip at a time.
+    Optional<u32> highest_sacked_sequence_number;
+    for (auto const& outgoing_packet : unacked_packets.packets) {
+        if (outgoing_packet.is_sacked)
+            highest_sacked_sequence_number = outgoing_packet.ack_number;
+    }
+    if (!highest_sacked_sequence_number.has_value())
+        return;
+
+    for (auto& outgoing_packet : unacked_packets.packets) {
+        if (!sequence_number_is_before(outgoing_packet.sequence_number, *highest_sacked_sequence_number))
+            break;
+        if (!outgoing_packet.is_sacked && !outgoing_packet.was_retransmitted_in_recovery)
+            outgoing_packet.is_lost = true;
+    }
+}
+
+u32 TCPSocket::bytes_in_flight(UnackedPackets const& unacked_packets) const
+{
+    // RFC 6675 "pipe": Packets that the peer has selectively acknowledged, or that we believe were lost,
+    // are no longer taking up space in the network.
+    u32 bytes = 0;
+    for (auto const& outgoing_packet : unacked_packets.packets) {
+        if (!outgoing_packet.is_sacked && !outgoing_packet.is_lost)
+            bytes += outgoing_packet.payload_size;
+    }
+    return bytes;
+}
+
+void TCPSocket::update_retransmission_timeout(Duration rtt_sample)
+{
+    // RFC 6298 section 2
+    auto sample = rtt_sample.to_microseconds();
+    if (!m_has_rtt_sample) {
+        m_smoothed_rtt = rtt_sample;
+        m_rtt_variation = Duration::from_microseconds(sample / 2);
+        m_has_rtt_sample = true;
+    } else {
+        auto smoothed_rtt = m_smoothed_rtt.to_microseconds();
+        auto difference = smoothed_rtt > sample ? smoothed_rtt - sample : sample - smoothed_rtt;
+        m_rtt_variation = Duration::from_microseconds((3 * m_rtt_variation.to_microseconds() + difference) / 4);
+        m_smoothed_rtt = Duration::from_microseconds((7 * smoothed_rtt + sample) / 8);
+    }
+
+    auto variation = Duration::from_microseconds(4 * m_rtt_variation.to_microseconds());
+    auto timeout = m_smoothed_rtt + max(retransmission_timer_granularity, variation);
+    m_retransmission_timeout = clamp(timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+}
+
+Duration TCPSocket::retransmission_timeout_with_backoff() const
+{
+    // RFC 6298 section 5.5: Double the timeout for every retransmission (RFC 1122 requires this even for SYN packets).
+    auto timeout = m_retransmission_timeout;
+    for (u32 i = 0; i < m_retransmit_attempts && timeout < maximum_retransmission_timeout; ++i)
+        timeout = timeout + timeout;
+    return min(timeout, maximum_retransmission_timeout);
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -458,6 +685,19 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
             return EINVAL;
         m_no_delay = value;
         return {};
+    case TCP_CONGESTION: {
+        if (user_value_size == 0 || user_value_size > maximum_congestion_control_name_length)
+            return EINVAL;
+        auto name = TRY(try_copy_kstring_from_user(static_ptr_cast<char const*>(user_value), user_value_size));
+        // The caller may or may not include the null terminator in the size.
+        auto name_view = name->view();
+        if (auto terminator = name_view.find('\0'); terminator.has_value())
+            name_view = name_view.substring_view(0, *terminator);
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name_view);
+        if (!algorithm.has_value())
+            return ENOENT;
+        return set_congestion_control_algorithm(*algorithm);
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -483,6 +723,17 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
         size = sizeof(nodelay);
         return copy_to_user(value_size, &size);
     }
+    case TCP_CONGESTION: {
+        auto name = m_congestion_control->name();
+        if (size < name.length() + 1)
+            return EINVAL;
+        char buffer[maximum_congestion_control_name_length] {};
+        VERIFY(name.length() < sizeof(buffer));
+        memcpy(buffer, name.characters_without_null_termination(), name.length());
+        size = name.length() + 1;
+        TRY(copy_to_user(static_ptr_cast<char*>(value), buffer, size));
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -681,18 +932,12 @@ void TCPSocket::retransmit_packets()
 {
     auto now = TimeManagement::the().monotonic_time();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
-
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (now < m_retransmit_timer_start + retransmission_timeout_with_backoff())
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
+    m_retransmit_timer_start = now;
     ++m_retransmit_attempts;
 
     if (m_retransmit_attempts > maximum_retransmits) {
@@ -702,47 +947,93 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    ++m_retransmission_timeouts;
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        m_congestion_control->on_retransmission_timeout(bytes_in_flight(unacked_packets), now);
+        m_duplicate_acks_received = 0;
+
+        // Everything outstanding is presumed lost and gets resent as the window opens up again.
+        // RFC 2018 section 8: The peer may have discarded data it selectively acknowledged, so forget about that too.
+        for (auto& outgoing_packet : unacked_packets.packets) {
+            outgoing_packet.is_sacked = false;
+            outgoing_packet.is_lost = true;
+        }
+
+        retransmit_lost_packets(unacked_packets);
+    });
+}
+
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets)
+{
+    bool has_lost_packets = false;
+    for (auto const& outgoing_packet : unacked_packets.packets) {
+        if (outgoing_packet.is_lost) {
+            has_lost_packets = true;
+            break;
+        }
+    }
+    if (!has_lost_packets)
+        return;
+
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return;
 
-    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+    auto in_flight = bytes_in_flight(unacked_packets);
+    bool is_first_unacknowledged_packet = true;
+    for (auto& outgoing_packet : unacked_packets.packets) {
+        if (outgoing_packet.is_lost) {
+            // The oldest packet is always resent right away (that is the fast retransmit, or the first packet
+            // after a timeout), everything behind it has to fit into the congestion window.
+            if (!is_first_unacknowledged_packet && in_flight + outgoing_packet.payload_size > m_congestion_control->congestion_window())
+                break;
+            retransmit_packet(outgoing_packet, routing_decision);
+            in_flight += outgoing_packet.payload_size;
+        }
+        is_first_unacknowledged_packet = false;
+    }
+}
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+    packet.is_lost = false;
+    packet.was_retransmitted_in_recovery = true;
+    packet.sent_time = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
 
-            auto packet_buffer = packet.buffer->bytes();
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
-        }
-    });
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+    m_retransmitted_packets++;
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -756,8 +1047,9 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (!file_description.is_blocking())
         return true;
 
+    auto window = min(m_send_window_size, m_congestion_control->congestion_window());
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return bytes_in_flight(unacked_packets) + size < window;
     });
 }
 }
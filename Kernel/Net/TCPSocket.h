@@ -15,6 +15,7 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
@@ -142,6 +143,20 @@ public:
         m_send_window_scale = scale;
     }
 
+    void set_peer_maximum_segment_size(u16 maximum_segment_size) { m_peer_maximum_segment_size = maximum_segment_size; }
+    void set_sack_permitted() { m_sack_permitted = true; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+
+    TCPCongestionControl const& congestion_control() const { return *m_congestion_control; }
+    ErrorOr<void> set_congestion_control_algorithm(TCPCongestionControlAlgorithm);
+
+    Duration smoothed_rtt() const { return m_smoothed_rtt; }
+    Duration rtt_variation() const { return m_rtt_variation; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+    u32 fast_retransmits() const { return m_fast_retransmits; }
+    u32 retransmission_timeouts() const { return m_retransmission_timeouts; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
@@ -179,7 +194,7 @@ protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -195,6 +210,20 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct OutgoingPacket;
+    struct UnackedPackets;
+
+    u32 maximum_segment_size(RoutingDecision const&) const;
+    u32 bytes_in_flight(UnackedPackets const&) const;
+    Duration retransmission_timeout_with_backoff() const;
+    void update_retransmission_timeout(Duration rtt_sample);
+    void process_sack_option(TCPPacket const&, UnackedPackets&);
+    void mark_packets_below_sacked_data_as_lost(UnackedPackets&);
+    void did_receive_new_ack(u32 ack_number, u32 bytes_acknowledged, UnackedPackets&, MonotonicTime now);
+    void did_receive_duplicate_ack(UnackedPackets&, MonotonicTime now);
+    void retransmit_lost_packets(UnackedPackets&);
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+
     static constexpr size_t receive_window_scale()
     {
         auto buffer_size_bit_length = AK::log2(receive_buffer_size) + 1;
@@ -217,11 +246,17 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
+        u32 payload_size { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
+        MonotonicTime sent_time;
         int tx_counter { 0 };
+        bool is_sacked { false };
+        bool is_lost { false };
+        bool was_retransmitted_in_recovery { false };
     };
 
     struct UnackedPackets {
@@ -232,21 +267,41 @@ private:
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
+    u32 m_duplicate_acks_received { 0 };
 
     u32 m_last_ack_number_sent { 0 };
     MonotonicTime m_last_ack_sent_time;
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
-    MonotonicTime m_last_retransmit_time;
+    static constexpr u32 duplicate_ack_threshold = 3;
+    MonotonicTime m_retransmit_timer_start;
     u32 m_retransmit_attempts { 0 };
 
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    // The highest sequence number sent when fast recovery began (RFC 6582 "recover").
+    u32 m_recovery_point { 0 };
+
+    // RFC 6298 round trip time estimation.
+    bool m_has_rtt_sample { false };
+    Duration m_smoothed_rtt;
+    Duration m_rtt_variation;
+    Duration m_retransmission_timeout { Duration::from_seconds(1) };
+
+    u32 m_retransmitted_packets { 0 };
+    u32 m_fast_retransmits { 0 };
+    u32 m_retransmission_timeouts { 0 };
+
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
     u32 m_send_window_size { 64 * KiB };
     bool m_window_scaling_supported { false };
     size_t m_send_window_scale { 0 };
 
+    u32 m_local_maximum_segment_size { 0 };
+    Optional<u16> m_peer_maximum_segment_size;
+    bool m_sack_permitted { false };
+
     bool m_no_delay { false };
 
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Checked.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & EPOLL_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto epoll_description = TRY(open_file_description(params.epoll_fd));
+    auto* event_poll = epoll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(params.fd));
+    if (description == epoll_description)
+        return EINVAL;
+
+    epoll_event event {};
+    if (params.op != EPOLL_CTL_DEL)
+        TRY(copy_from_user(&event, params.event));
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        TRY(event_poll->add_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(event_poll->modify_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_DEL:
+        TRY(event_poll->remove_interest(params.fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.max_events <= 0)
+        return EINVAL;
+    size_t max_events = min(static_cast<size_t>(params.max_events), OpenFileDescriptions::max_open());
+
+    auto description = TRY(open_file_description(params.epoll_fd));
+    auto* event_poll = description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    bool should_block = true;
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        should_block = !timeout_time.is_zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    Vector<epoll_event> events;
+    for (;;) {
+        TRY(event_poll->collect_ready_events(events, max_events));
+        if (!events.is_empty() || !should_block)
+            break;
+
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = Thread::current()->block<Thread::ReadBlocker>(timeout, *description, unblock_flags);
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            return 0;
+        if (result.was_interrupted())
+            return EINTR;
+    }
+
+    TRY(copy_n_to_user(params.events, events.data(), events.size()));
+    return events.size();
+}
+
+}
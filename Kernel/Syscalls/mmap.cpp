@@ -206,6 +206,11 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
             vmobject = TRY(Memory::AnonymousVMObject::try_create_purgeable_with_size(rounded_size, strategy));
         } else {
             vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(rounded_size, strategy));
+#if ARCH(X86_64)
+            // Line large mappings up with huge page boundaries, so they can be mapped with as few huge pages as possible.
+            if (!params.alignment && rounded_size >= Memory::HUGE_PAGE_SIZE)
+                alignment = Memory::HUGE_PAGE_SIZE;
+#endif
         }
     } else {
         if (offset < 0)
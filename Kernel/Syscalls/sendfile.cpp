@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// Large enough that a typical static file goes out in a handful of iterations,
+// small enough that we don't tie up much kernel memory per call.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    // Only regular files can be read at an arbitrary offset without side effects.
+    if (!in_description->inode() || !in_description->metadata().is_regular_file())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+    if (out_description->should_append())
+        return EINVAL;
+
+    off_t offset = 0;
+    if (params.offset) {
+        TRY(copy_from_user(&offset, params.offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", params.out_fd, params.in_fd, offset, params.count);
+
+    if (params.count == 0)
+        return 0;
+
+    auto chunk = TRY(KBuffer::try_create_with_size("sendfile"sv, min(params.count, sendfile_chunk_size)));
+    auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(chunk->data());
+
+    size_t total_nsent = 0;
+    while (total_nsent < params.count) {
+        auto nread_or_error = in_description->read(chunk_buffer, offset + total_nsent, min(params.count - total_nsent, chunk->size()));
+        if (nread_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        // do_write() takes care of blocking on the output and of partial writes on non-blocking descriptions.
+        auto nwritten_or_error = do_write(*out_description, chunk_buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        total_nsent += nwritten_or_error.value();
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+
+    auto new_offset = static_cast<off_t>(offset + total_nsent);
+    if (params.offset)
+        TRY(copy_to_user(params.offset, &new_offset));
+    else
+        TRY(in_description->seek(new_offset, SEEK_SET));
+
+    return total_nsent;
+}
+
+}
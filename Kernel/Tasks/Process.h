@@ -234,6 +234,17 @@ public:
     bool is_kernel_process() const { return m_is_kernel_process; }
     bool is_user_process() const { return !m_is_kernel_process; }
 
+    // The page faults of all threads of this process, including the ones that have exited already.
+    struct PageFaultCounters {
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> inode_faults { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> zero_faults { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> cow_faults { 0 };
+        // Pages that were mapped while handling a fault on one of their neighbours, saving a fault of their own.
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> faulted_around_pages { 0 };
+    };
+    PageFaultCounters& page_fault_counters() { return m_page_fault_counters; }
+    PageFaultCounters const& page_fault_counters() const { return m_page_fault_counters; }
+
     static RefPtr<Process> from_pid_in_same_jail(ProcessID);
     static RefPtr<Process> from_pid_ignoring_jails(ProcessID);
     static SessionID get_sid_from_pgid(ProcessGroupID pgid);
@@ -361,6 +372,9 @@ public:
     ErrorOr<FlatPtr> sys$msync(Userspace<void*>, size_t, int flags);
     ErrorOr<FlatPtr> sys$purge(int mode);
     ErrorOr<FlatPtr> sys$poll(Userspace<Syscall::SC_poll_params const*>);
+    ErrorOr<FlatPtr> sys$epoll_create1(int flags);
+    ErrorOr<FlatPtr> sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*>);
+    ErrorOr<FlatPtr> sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*>);
     ErrorOr<FlatPtr> sys$get_dir_entries(int fd, Userspace<void*>, size_t);
     ErrorOr<FlatPtr> sys$getcwd(Userspace<char*>, size_t);
     ErrorOr<FlatPtr> sys$chdir(Userspace<char const*>, size_t);
@@ -453,6 +467,7 @@ public:
     ErrorOr<FlatPtr> sys$get_stack_bounds(Userspace<FlatPtr*> stack_base, Userspace<size_t*> stack_size);
     ErrorOr<FlatPtr> sys$ptrace(Userspace<Syscall::SC_ptrace_params const*>);
     ErrorOr<FlatPtr> sys$sendfd(int sockfd, int fd);
+    ErrorOr<FlatPtr> sys$sendfile(Userspace<Syscall::SC_sendfile_params const*>);
     ErrorOr<FlatPtr> sys$recvfd(int sockfd, int options);
     ErrorOr<FlatPtr> sys$sysconf(int name);
     ErrorOr<FlatPtr> sys$disown(ProcessID);
@@ -915,6 +930,8 @@ private:
     Atomic<bool, AK::MemoryOrder::memory_order_relaxed> m_is_stopped { false };
     bool m_should_generate_coredump { false };
 
+    PageFaultCounters m_page_fault_counters;
+
     SpinlockProtected<RefPtr<Custody>, LockRank::None> m_executable;
 
     SpinlockProtected<RefPtr<Custody>, LockRank::None> m_current_directory;
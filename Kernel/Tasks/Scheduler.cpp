@@ -46,7 +46,21 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor has its own ready queues, so that processors don't all contend on the same lock when picking the next thread.
+// Idle processors steal runnable threads from the busiest other processor.
+struct ProcessorReadyQueues {
+    SpinlockProtected<ThreadReadyQueues, LockRank::None> ready_queues;
+
+    // These can be read without holding the lock, which is all load balancing needs.
+    Atomic<u32> thread_count { 0 };
+    Atomic<u64> steal_count { 0 };
+    Atomic<u64> migration_count { 0 };
+};
+
+// Thread affinity is a u32 mask, so we can't schedule on more processors than that.
+static constexpr u32 max_scheduled_processor_count = sizeof(u32) * 8;
+
+static Singleton<Array<ProcessorReadyQueues, max_scheduled_processor_count>> s_processor_ready_queues;
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -55,7 +69,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into a ThreadReadyQueues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,11 +78,19 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static u32 ready_queue_processor_count()
+{
+    // NOTE: Processor::count() isn't set up on every architecture.
+    return clamp(Processor::count(), 1u, max_scheduled_processor_count);
+}
+
+// Finds the highest priority thread in the ready queues of processor_id that is allowed to run on the current processor.
+Thread* Scheduler::find_runnable_thread_in_queues_of(u32 processor_id, TakeThread take_thread)
 {
     auto affinity_mask = 1u << Processor::current_id();
+    auto& processor_ready_queues = s_processor_ready_queues->at(processor_id);
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
+    return processor_ready_queues.ready_queues.with([&](auto& ready_queues) -> Thread* {
         auto priority_mask = ready_queues.mask;
         while (priority_mask != 0) {
             auto priority = bit_scan_forward(priority_mask);
@@ -76,62 +98,87 @@ Thread& Scheduler::pull_next_runnable_thread()
             auto& ready_queue = ready_queues.queues[--priority];
             for (auto& thread : ready_queue.thread_list) {
                 VERIFY(thread.m_runnable_priority == (int)priority);
+                VERIFY(thread.m_ready_queue_processor == processor_id);
                 if (thread.is_active())
                     continue;
                 if (!(thread.affinity() & affinity_mask))
                     continue;
+                if (take_thread == TakeThread::No)
+                    return &thread;
                 thread.m_runnable_priority = -1;
                 ready_queue.thread_list.remove(thread);
                 if (ready_queue.thread_list.is_empty())
                     ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
+                processor_ready_queues.thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+                return &thread;
             }
             priority_mask &= ~(1u << priority);
         }
-
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
+        return nullptr;
     });
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+// Looks at our own ready queues first, then at those of the other processors from busiest to least busy.
+Thread* Scheduler::find_runnable_thread(TakeThread take_thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    auto current_processor_id = Processor::current_id();
+    if (auto* thread = find_runnable_thread_in_queues_of(current_processor_id, take_thread))
+        return thread;
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
+    auto processor_count = ready_queue_processor_count();
+    u32 tried_processors_mask = 1u << current_processor_id;
+    for (;;) {
+        Optional<u32> busiest_processor_id;
+        u32 busiest_thread_count = 0;
+        for (u32 processor_id = 0; processor_id < processor_count; ++processor_id) {
+            if (tried_processors_mask & (1u << processor_id))
+                continue;
+            auto thread_count = s_processor_ready_queues->at(processor_id).thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+            if (thread_count > busiest_thread_count) {
+                busiest_processor_id = processor_id;
+                busiest_thread_count = thread_count;
             }
-            priority_mask &= ~(1u << priority);
         }
+        if (!busiest_processor_id.has_value())
+            return nullptr;
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
-    });
+        if (auto* thread = find_runnable_thread_in_queues_of(*busiest_processor_id, take_thread)) {
+            if (take_thread == TakeThread::Yes)
+                s_processor_ready_queues->at(current_processor_id).steal_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            return thread;
+        }
+        tried_processors_mask |= 1u << *busiest_processor_id;
+    }
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    if (auto* thread = find_runnable_thread(TakeThread::Yes)) {
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return *thread;
+    }
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return find_runnable_thread(TakeThread::No);
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -139,7 +186,8 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
+    auto& processor_ready_queues = s_processor_ready_queues->at(thread.m_ready_queue_processor);
+    return processor_ready_queues.ready_queues.with([&](auto& ready_queues) {
         auto priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
@@ -155,29 +203,85 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
         ready_queue.thread_list.remove(thread);
         if (ready_queue.thread_list.is_empty())
             ready_queues.mask &= ~(1u << priority);
+        processor_ready_queues.thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
         return true;
     });
 }
 
+static u32 ready_queue_processor_for(Thread const& thread)
+{
+    auto processor_count = ready_queue_processor_count();
+    auto allowed_processors_mask = thread.affinity();
+    if (processor_count < max_scheduled_processor_count)
+        allowed_processors_mask &= (1u << processor_count) - 1;
+    VERIFY(allowed_processors_mask != 0);
+
+    // Threads are kept on the processor they last ran on, since that's where their caches are warm.
+    auto preferred_processor_id = thread.cpu();
+    if (preferred_processor_id >= processor_count || !(allowed_processors_mask & (1u << preferred_processor_id)))
+        preferred_processor_id = bit_scan_forward(allowed_processors_mask) - 1;
+
+    Optional<u32> least_busy_processor_id;
+    u32 least_busy_thread_count = NumericLimits<u32>::max();
+    for (u32 processor_id = 0; processor_id < processor_count; ++processor_id) {
+        if (!(allowed_processors_mask & (1u << processor_id)))
+            continue;
+        auto thread_count = s_processor_ready_queues->at(processor_id).thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (thread_count < least_busy_thread_count) {
+            least_busy_processor_id = processor_id;
+            least_busy_thread_count = thread_count;
+        }
+    }
+
+    // ...unless that processor is so much busier than another one that waiting for it would cost more than a cold cache.
+    static constexpr u32 migration_thread_count_imbalance = 2;
+    auto preferred_thread_count = s_processor_ready_queues->at(preferred_processor_id).thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+    if (preferred_thread_count >= least_busy_thread_count + migration_thread_count_imbalance) {
+        s_processor_ready_queues->at(*least_busy_processor_id).migration_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return *least_busy_processor_id;
+    }
+    return preferred_processor_id;
+}
+
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto processor_id = ready_queue_processor_for(thread);
+    auto& processor_ready_queues = s_processor_ready_queues->at(processor_id);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    processor_ready_queues.ready_queues.with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_ready_queue_processor = processor_id;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        processor_ready_queues.thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     });
 }
 
+ProcessorSchedulingStatistics Scheduler::processor_scheduling_statistics(u32 processor_id)
+{
+    VERIFY(processor_id < max_scheduled_processor_count);
+    auto& processor_ready_queues = s_processor_ready_queues->at(processor_id);
+    return {
+        .ready_thread_count = processor_ready_queues.thread_count.load(AK::MemoryOrder::memory_order_relaxed),
+        .steal_count = processor_ready_queues.steal_count.load(AK::MemoryOrder::memory_order_relaxed),
+        .migration_count = processor_ready_queues.migration_count.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
+u32 Scheduler::scheduled_processor_count()
+{
+    return ready_queue_processor_count();
+}
+
 UNMAP_AFTER_INIT void Scheduler::start()
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -217,6 +321,22 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
+    // Most calls don't end up switching threads: idle processors get here after every interrupt, and every spinlock
+    // that deferred a preemption calls us when it is released. If the current thread may keep running and no ready
+    // queue we can take from has anything for us, we only need the locks of those queues, not g_scheduler_lock.
+    // NOTE: A thread's state only changes away from Running on its own processor, so reading it here doesn't race.
+    auto* current_thread = Thread::current();
+    if (current_thread->state() == Thread::State::Running && !current_thread->should_be_stopped() && !peek_next_runnable_thread()) {
+        // The timer may have asked for this preemption because the thread's time slice ran out, and the thread that was
+        // ready back then has since been taken by another processor. Give it another time slice, like timer_tick() does
+        // when nothing else is ready, as Thread::tick() would wrap around its ticks otherwise.
+        if (current_thread->ticks_left() == 0) {
+            current_thread->set_ticks_left(time_slice_for(*current_thread));
+            current_thread->did_schedule();
+        }
+        return;
+    }
+
     SpinlockLocker lock(g_scheduler_lock);
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
@@ -29,6 +29,14 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ProcessorSchedulingStatistics {
+    u32 ready_thread_count { 0 };
+    // Threads this processor took from the ready queues of other processors.
+    u64 steal_count { 0 };
+    // Threads that were queued on this processor instead of the busier one they last ran on.
+    u64 migration_count { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -55,6 +63,16 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static u32 scheduled_processor_count();
+    static ProcessorSchedulingStatistics processor_scheduling_statistics(u32 processor_id);
+
+private:
+    enum class TakeThread {
+        No,
+        Yes,
+    };
+    static Thread* find_runnable_thread(TakeThread);
+    static Thread* find_runnable_thread_in_queues_of(u32 processor_id, TakeThread);
 };
 
 }
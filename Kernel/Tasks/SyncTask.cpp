@@ -4,21 +4,32 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Singleton.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/WaitQueue.h>
 #include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
+static Singleton<WaitQueue> s_sync_wait_queue;
+
+void SyncTask::wake()
+{
+    s_sync_wait_queue->wake_one();
+}
+
 UNMAP_AFTER_INIT void SyncTask::spawn()
 {
     MUST(Process::create_kernel_process("VFS Sync Task"sv, [] {
         dbgln("VFS SyncTask is running");
         while (!Process::current().is_dying()) {
             VirtualFileSystem::sync();
-            (void)Thread::current()->sleep(Duration::from_seconds(1));
+            auto timeout_time = Duration::from_seconds(1);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = s_sync_wait_queue->wait_on(timeout, "SyncTask"sv);
         }
         Process::current().sys$exit(0);
         VERIFY_NOT_REACHED();
@@ -10,5 +10,8 @@ namespace Kernel {
 class SyncTask {
 public:
     static void spawn();
+
+    // Makes the SyncTask write back dirty data now instead of at its next regular interval.
+    static void wake();
 };
 }
@@ -648,6 +648,24 @@ bool Thread::tick()
     return m_ticks_left != 0;
 }
 
+void Thread::did_inode_fault()
+{
+    ++m_inode_faults;
+    ++m_process->page_fault_counters().inode_faults;
+}
+
+void Thread::did_zero_fault()
+{
+    ++m_zero_faults;
+    ++m_process->page_fault_counters().zero_faults;
+}
+
+void Thread::did_cow_fault()
+{
+    ++m_cow_faults;
+    ++m_process->page_fault_counters().cow_faults;
+}
+
 void Thread::check_dispatch_pending_signal()
 {
     auto result = DispatchSignalResult::Continue;
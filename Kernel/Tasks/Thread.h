@@ -893,11 +893,11 @@ public:
     unsigned syscall_count() const { return m_syscall_count; }
     void did_syscall() { ++m_syscall_count; }
     unsigned inode_faults() const { return m_inode_faults; }
-    void did_inode_fault() { ++m_inode_faults; }
+    void did_inode_fault();
     unsigned zero_faults() const { return m_zero_faults; }
-    void did_zero_fault() { ++m_zero_faults; }
+    void did_zero_fault();
     unsigned cow_faults() const { return m_cow_faults; }
-    void did_cow_fault() { ++m_cow_faults; }
+    void did_cow_fault();
 
     u64 file_read_bytes() const { return m_file_read_bytes; }
     u64 file_write_bytes() const { return m_file_write_bytes; }
@@ -1092,6 +1092,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_ready_queue_processor { 0 };
 
     friend class WaitQueue;
 
@@ -17,6 +17,8 @@ namespace Kernel {
 
 extern WorkQueue* g_io_work;
 extern WorkQueue* g_ata_work;
+// NOTE: Read-ahead blocks on the disk, so it can't run on g_io_work, which completes the disk requests.
+extern WorkQueue* g_read_ahead_work;
 
 class WorkQueue {
     AK_MAKE_NONCOPYABLE(WorkQueue);
@@ -148,6 +148,7 @@ set(PS2MOUSE_DEBUG ON)
 set(PTHREAD_DEBUG ON)
 set(PTMX_DEBUG ON)
 set(REACHABLE_DEBUG ON)
+set(READ_AHEAD_DEBUG ON)
 set(REGEX_DEBUG ON)
 set(REQUESTSERVER_DEBUG ON)
 set(RESIZE_DEBUG ON)
@@ -427,6 +427,30 @@ TEST_CASE(find_copy_in_seekback)
     }
 }
 
+TEST_CASE(copy_from_seekback)
+{
+    auto circular_buffer = MUST(CircularBuffer::create_empty(64));
+    EXPECT_EQ(circular_buffer.write("abc"sv.bytes()), 3ul);
+
+    // Copies that overlap their own output repeat the last `distance` bytes.
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(3, 20)), 20ul);
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(1, 9)), 9ul);
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(16, 10)), 10ul);
+
+    Array<u8, 42> result;
+    EXPECT_EQ(circular_buffer.read(result).size(), result.size());
+    EXPECT_EQ(StringView { result.span() }, "abcabcabcabcabcabcabcabbbbbbbbbbbcabcabbbb"sv);
+
+    // Make the next copy wrap around the end of the buffer.
+    EXPECT_EQ(circular_buffer.write("0123456789"sv.bytes()), 10ul);
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(10, 20)), 20ul);
+    Array<u8, 30> wrapped_result;
+    EXPECT_EQ(circular_buffer.read(wrapped_result).size(), wrapped_result.size());
+    EXPECT_EQ(StringView { wrapped_result.span() }, "012345678901234567890123456789"sv);
+
+    EXPECT(circular_buffer.copy_from_seekback(65, 1).is_error());
+}
+
 BENCHMARK_CASE(looping_copy_from_seekback)
 {
     auto circular_buffer = MUST(CircularBuffer::create_empty(16 * MiB));
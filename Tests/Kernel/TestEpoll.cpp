@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+TEST_CASE(level_triggered)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+    EXPECT_EQ(fcntl(epoll_fd, F_GETFD) & FD_CLOEXEC, FD_CLOEXEC);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = 0x1234'5678'9abc'def0;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event ready[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 100), 1);
+    EXPECT_EQ(ready[0].events, static_cast<u32>(EPOLLIN));
+    EXPECT_EQ(ready[0].data.u64, 0x1234'5678'9abc'def0ull);
+
+    // Nothing has been read yet, so the pipe is still readable.
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 1);
+
+    char buffer;
+    EXPECT_EQ(read(pipe_fds[0], &buffer, 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(edge_triggered_and_oneshot)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLET;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event ready[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 100), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 0);
+
+    // New data is a new edge.
+    EXPECT_EQ(write(pipe_fds[1], "y", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 100), 1);
+
+    event.events = EPOLLIN | EPOLLONESHOT;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 100), 1);
+    EXPECT_EQ(write(pipe_fds[1], "z", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 0);
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(invalid_arguments)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(epoll_ctl(pipe_fds[0], EPOLL_CTL_ADD, pipe_fds[1], &event), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    epoll_event ready[1];
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 0, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(interests_go_away_with_their_description)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = 1;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    // Another fd still refers to the description, so the interest has to stay.
+    int duplicate_fd = dup(pipe_fds[0]);
+    EXPECT(duplicate_fd >= 0);
+    close(pipe_fds[0]);
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    epoll_event ready[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 100), 1);
+    EXPECT_EQ(ready[0].data.u64, 1ull);
+
+    // Once the last fd is closed, nothing is reported for it any more.
+    close(duplicate_fd);
+    EXPECT_EQ(epoll_wait(epoll_fd, ready, 4, 0), 0);
+
+    // A new description can be added under the same fd number.
+    int new_pipe_fds[2];
+    EXPECT_EQ(pipe(new_pipe_fds), 0);
+    if (new_pipe_fds[0] == pipe_fds[0] || new_pipe_fds[0] == duplicate_fd)
+        EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, new_pipe_fds[0], &event), 0);
+
+    close(new_pipe_fds[0]);
+    close(new_pipe_fds[1]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
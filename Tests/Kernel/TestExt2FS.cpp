@@ -5,7 +5,9 @@
  */
 
 #include <LibTest/TestCase.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 TEST_CASE(test_uid_and_gid_high_bits_are_set)
@@ -29,3 +31,40 @@ TEST_CASE(test_uid_and_gid_high_bits_are_set)
     EXPECT_EQ(st.st_uid, 65536u);
     EXPECT_EQ(st.st_gid, 65536u);
 }
+
+TEST_CASE(lookups_see_directory_changes)
+{
+    static constexpr auto TEST_DIRECTORY_PATH = "/home/anon/.ext2_lookup_test";
+    static constexpr auto TEST_FILE_PATH = "/home/anon/.ext2_lookup_test/file";
+    static constexpr auto RENAMED_FILE_PATH = "/home/anon/.ext2_lookup_test/renamed";
+
+    EXPECT_EQ(mkdir(TEST_DIRECTORY_PATH, 0755), 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        unlink(TEST_FILE_PATH);
+        unlink(RENAMED_FILE_PATH);
+        rmdir(TEST_DIRECTORY_PATH);
+    });
+
+    // Look up the missing names twice, so the second lookups are answered from the cache.
+    struct stat st;
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(stat(TEST_FILE_PATH, &st), -1);
+        EXPECT_EQ(errno, ENOENT);
+        EXPECT_EQ(stat(RENAMED_FILE_PATH, &st), -1);
+        EXPECT_EQ(errno, ENOENT);
+    }
+
+    int fd = open(TEST_FILE_PATH, O_CREAT | O_WRONLY, 0644);
+    EXPECT(fd >= 0);
+    close(fd);
+    EXPECT_EQ(stat(TEST_FILE_PATH, &st), 0);
+
+    EXPECT_EQ(rename(TEST_FILE_PATH, RENAMED_FILE_PATH), 0);
+    EXPECT_EQ(stat(TEST_FILE_PATH, &st), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(stat(RENAMED_FILE_PATH, &st), 0);
+
+    EXPECT_EQ(unlink(RENAMED_FILE_PATH), 0);
+    EXPECT_EQ(stat(RENAMED_FILE_PATH, &st), -1);
+    EXPECT_EQ(errno, ENOENT);
+}
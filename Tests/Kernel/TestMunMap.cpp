@@ -14,3 +14,32 @@ TEST_CASE(munmap_zero_page)
     auto res = munmap(0x0, 0xF);
     EXPECT_EQ(res, 0);
 }
+
+TEST_CASE(munmap_and_mprotect_inside_large_anonymous_mapping)
+{
+    // Large enough to contain at least one fully covered 2 MiB huge page, wherever the mapping ends up.
+    static constexpr size_t mapping_size = 8 * MiB;
+    auto* mapping = static_cast<u8*>(mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(mapping != MAP_FAILED);
+
+    for (size_t offset = 0; offset < mapping_size; offset += PAGE_SIZE)
+        mapping[offset] = static_cast<u8>(offset / PAGE_SIZE);
+
+    // Punch a hole into the middle of the mapping and make the page after it read-only.
+    // Whatever was mapped as a huge page around them has to be split, and the other pages must keep their contents.
+    size_t const hole_offset = 3 * MiB + 5 * PAGE_SIZE;
+    EXPECT_EQ(munmap(mapping + hole_offset, PAGE_SIZE), 0);
+    EXPECT_EQ(mprotect(mapping + hole_offset + PAGE_SIZE, PAGE_SIZE, PROT_READ), 0);
+
+    for (size_t offset = 0; offset < mapping_size; offset += PAGE_SIZE) {
+        if (offset == hole_offset)
+            continue;
+        EXPECT_EQ(mapping[offset], static_cast<u8>(offset / PAGE_SIZE));
+    }
+
+    mapping[hole_offset + 2 * PAGE_SIZE] = 'x';
+    EXPECT_EQ(mapping[hole_offset + 2 * PAGE_SIZE], 'x');
+
+    EXPECT_EQ(munmap(mapping, hole_offset), 0);
+    EXPECT_EQ(munmap(mapping + hole_offset + PAGE_SIZE, mapping_size - hole_offset - PAGE_SIZE), 0);
+}
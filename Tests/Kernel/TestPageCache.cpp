@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/ScopeGuard.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// NOTE: /tmp is a RAMFS, which doesn't use the page cache, so these tests need a file on the Ext2 root file system.
+static constexpr auto TEST_FILE_PATH = "/home/anon/.page_cache_test";
+
+TEST_CASE(read_sees_writes_to_cached_pages)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    u8 buffer[0x2800];
+    memset(buffer, 'a', sizeof(buffer));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+
+    // Pull every page into the cache, then overwrite a range that spans a page boundary.
+    u8 read_buffer[0x2800];
+    EXPECT_EQ(pread(fd, read_buffer, sizeof(read_buffer), 0), static_cast<ssize_t>(sizeof(read_buffer)));
+    EXPECT_EQ(pwrite(fd, "hello", 5, 0xffe), 5);
+
+    EXPECT_EQ(pread(fd, read_buffer, sizeof(read_buffer), 0), static_cast<ssize_t>(sizeof(read_buffer)));
+    EXPECT_EQ(memcmp(read_buffer + 0xffe, "hello", 5), 0);
+    EXPECT_EQ(read_buffer[0xffd], 'a');
+    EXPECT_EQ(read_buffer[0x1003], 'a');
+
+    // Growing the file past the short last page has to be visible too.
+    EXPECT_EQ(pwrite(fd, "!", 1, 0x3000), 1);
+    EXPECT_EQ(pread(fd, read_buffer, 0x10, 0x27f8), 0x10);
+    EXPECT_EQ(read_buffer[7], 'a');
+    EXPECT_EQ(read_buffer[8], 0);
+    EXPECT_EQ(pread(fd, read_buffer, 0x10, 0x3000), 1);
+    EXPECT_EQ(read_buffer[0], '!');
+}
+
+TEST_CASE(truncation_drops_cached_pages)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    u8 buffer[0x2000];
+    memset(buffer, 'b', sizeof(buffer));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+
+    EXPECT_EQ(ftruncate(fd, 0x800), 0);
+    EXPECT_EQ(ftruncate(fd, 0x2000), 0);
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(buffer[0x7ff], 'b');
+    EXPECT_EQ(buffer[0x800], 0);
+    EXPECT_EQ(buffer[0x1fff], 0);
+}
+
+TEST_CASE(shared_mappings_see_writes)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    u8 buffer[0x1000];
+    memset(buffer, 'c', sizeof(buffer));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+
+    auto* mapping = static_cast<u8*>(mmap(nullptr, sizeof(buffer), PROT_READ, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+    EXPECT_EQ(mapping[0x10], 'c');
+
+    EXPECT_EQ(pwrite(fd, "d", 1, 0x10), 1);
+    EXPECT_EQ(mapping[0x10], 'd');
+
+    EXPECT_EQ(munmap(mapping, sizeof(buffer)), 0);
+}
+
+TEST_CASE(sequential_reads_across_read_ahead_windows)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // Large enough for the read-ahead window to grow to its maximum, and not a multiple of the page size.
+    static constexpr size_t file_size = 0x80000 + 0x123;
+    u8 buffer[0x1000];
+    for (size_t offset = 0; offset < file_size; offset += sizeof(buffer)) {
+        auto length = min(sizeof(buffer), file_size - offset);
+        for (size_t i = 0; i < length; ++i)
+            buffer[i] = static_cast<u8>((offset + i) / 0x1000);
+        EXPECT_EQ(pwrite(fd, buffer, length, offset), static_cast<ssize_t>(length));
+    }
+
+    size_t total_read = 0;
+    while (true) {
+        auto nread = read(fd, buffer, sizeof(buffer));
+        VERIFY(nread >= 0);
+        if (nread == 0)
+            break;
+        for (ssize_t i = 0; i < nread; ++i)
+            EXPECT_EQ(buffer[i], static_cast<u8>((total_read + i) / 0x1000));
+        total_read += nread;
+    }
+    EXPECT_EQ(total_read, file_size);
+
+    // Rewrite a page the read-ahead already brought in, and read it back out of order.
+    memset(buffer, 'e', sizeof(buffer));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), 0x7f000), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(pread(fd, buffer, 2, 0x7efff), 2);
+    EXPECT_EQ(buffer[0], 0x7e);
+    EXPECT_EQ(buffer[1], 'e');
+}
+
+TEST_CASE(large_unaligned_transfers)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // Big enough to be split into several multi-block requests, and starting in the middle of a block.
+    static constexpr size_t transfer_size = 0x61000 + 0x321;
+    static constexpr off_t transfer_offset = 0x1234;
+    auto write_buffer = MUST(ByteBuffer::create_uninitialized(transfer_size));
+    for (size_t i = 0; i < transfer_size; ++i)
+        write_buffer[i] = static_cast<u8>(i * 7 + i / 0x1000);
+    EXPECT_EQ(pwrite(fd, write_buffer.data(), transfer_size, transfer_offset), static_cast<ssize_t>(transfer_size));
+    EXPECT_EQ(fsync(fd), 0);
+
+    auto read_buffer = MUST(ByteBuffer::create_zeroed(transfer_size));
+    EXPECT_EQ(pread(fd, read_buffer.data(), transfer_size, transfer_offset), static_cast<ssize_t>(transfer_size));
+    EXPECT_EQ(memcmp(read_buffer.data(), write_buffer.data(), transfer_size), 0);
+
+    u8 head[0x10];
+    EXPECT_EQ(pread(fd, head, sizeof(head), 0), static_cast<ssize_t>(sizeof(head)));
+    EXPECT_EQ(head[0], 0);
+}
+
+TEST_CASE(blocks_mapped_through_indirect_blocks)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // Past the singly indirect block, even with 4 KiB blocks.
+    static constexpr off_t far_offset = 0x600000;
+    u8 buffer[0x1000];
+    memset(buffer, 'f', sizeof(buffer));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), 0), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(pwrite(fd, buffer, sizeof(buffer), far_offset), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(fsync(fd), 0);
+
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), far_offset - 0x800), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(buffer[0x7ff], 0);
+    EXPECT_EQ(buffer[0x800], 'f');
+
+    // Shrink into the middle of the mapped range and grow again; the freed blocks must read back as zeroes.
+    EXPECT_EQ(ftruncate(fd, far_offset - 0x100000 + 0x10), 0);
+    EXPECT_EQ(ftruncate(fd, far_offset + sizeof(buffer)), 0);
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), far_offset), static_cast<ssize_t>(sizeof(buffer)));
+    EXPECT_EQ(buffer[0], 0);
+    EXPECT_EQ(pread(fd, buffer, 0x10, 0), 0x10);
+    EXPECT_EQ(buffer[0xf], 'f');
+}
+
+TEST_CASE(mappings_fault_around_cached_pages)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // A few fault-around windows, with a short last page.
+    static constexpr size_t file_size = 0x28000 + 0x456;
+    static constexpr size_t mapping_size = 0x29000;
+    u8 buffer[0x1000];
+    for (size_t offset = 0; offset < file_size; offset += sizeof(buffer)) {
+        auto length = min(sizeof(buffer), file_size - offset);
+        memset(buffer, static_cast<u8>(offset / 0x1000 + 1), length);
+        EXPECT_EQ(pwrite(fd, buffer, length, offset), static_cast<ssize_t>(length));
+    }
+
+    auto* shared_mapping = static_cast<u8*>(mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0));
+    VERIFY(shared_mapping != MAP_FAILED);
+    auto* private_mapping = static_cast<u8*>(mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    VERIFY(private_mapping != MAP_FAILED);
+
+    // Touch the pages out of order, so that most of them get mapped while faulting on a neighbour.
+    for (size_t page = 0; page < mapping_size / 0x1000; page += 3) {
+        EXPECT_EQ(shared_mapping[page * 0x1000], static_cast<u8>(page + 1));
+        EXPECT_EQ(private_mapping[page * 0x1000], static_cast<u8>(page + 1));
+    }
+    for (size_t page = 0; page < mapping_size / 0x1000; ++page) {
+        auto end_of_page = min((page + 1) * 0x1000, file_size) - 1;
+        EXPECT_EQ(shared_mapping[end_of_page], static_cast<u8>(page + 1));
+        EXPECT_EQ(private_mapping[end_of_page], static_cast<u8>(page + 1));
+    }
+    EXPECT_EQ(shared_mapping[file_size], 0);
+
+    // Writing to the private mapping must not show up in the file, not even in pages that were faulted around.
+    private_mapping[0x5000] = 'x';
+    EXPECT_EQ(shared_mapping[0x5000], 6);
+    EXPECT_EQ(pread(fd, buffer, 1, 0x5000), 1);
+    EXPECT_EQ(buffer[0], 6);
+
+    EXPECT_EQ(munmap(private_mapping, mapping_size), 0);
+    EXPECT_EQ(munmap(shared_mapping, mapping_size), 0);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(sendfile_basics)
+{
+    char pattern[] = "/tmp/sendfile.XXXXXX";
+    auto file_fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    EXPECT_EQ(MUST(Core::System::write(file_fd, "Well hello friends!"sv.bytes())), 19u);
+
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    char buffer[32] {};
+
+    {
+        // With an explicit offset, the file position stays put.
+        off_t offset = 5;
+        EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, &offset, 5)), 5u);
+        EXPECT_EQ(offset, 10);
+        EXPECT_EQ(MUST(Core::System::read(pipe_fds[0], { buffer, 5 })), 5u);
+        EXPECT_EQ(StringView(buffer, 5), "hello"sv);
+        EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), 19);
+    }
+
+    {
+        // Without one, the file position is used and advanced, and we stop at the end of the file.
+        MUST(Core::System::lseek(file_fd, 11, SEEK_SET));
+        EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, nullptr, 100)), 8u);
+        EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), 19);
+        EXPECT_EQ(MUST(Core::System::read(pipe_fds[0], { buffer, 8 })), 8u);
+        EXPECT_EQ(StringView(buffer, 8), "friends!"sv);
+    }
+
+    {
+        // Only regular files can be sent from.
+        auto result = Core::System::sendfile(pipe_fds[1], pipe_fds[0], nullptr, 1);
+        EXPECT(result.is_error());
+        EXPECT_EQ(result.error().code(), EINVAL);
+    }
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(file_fd));
+}
@@ -6,9 +6,12 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +41,41 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+static void* allocate_and_free_from_thread(void*)
+{
+    for (size_t round = 0; round < 100; ++round) {
+        Array<u8*, 64> pointers;
+        for (size_t i = 0; i < pointers.size(); ++i) {
+            size_t size = 1 + (i * 37 + round) % 600;
+            pointers[i] = static_cast<u8*>(malloc(size));
+            VERIFY(pointers[i]);
+            VERIFY(malloc_size(pointers[i]) >= size);
+            memset(pointers[i], static_cast<u8>(i), size);
+        }
+        for (size_t i = 0; i < pointers.size(); ++i) {
+            VERIFY(pointers[i][0] == static_cast<u8>(i));
+            free(pointers[i]);
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE(malloc_from_several_threads)
+{
+    Array<pthread_t, 4> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_from_thread, nullptr), 0);
+    allocate_and_free_from_thread(nullptr);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    serenity_malloc_size_class_stats stats[num_size_classes];
+    EXPECT_EQ(serenity_get_malloc_size_class_stats(stats, num_size_classes), num_size_classes);
+    size_t thread_cache_hits = 0;
+    for (size_t i = 0; i < num_size_classes; ++i) {
+        EXPECT_EQ(stats[i].chunk_size, static_cast<size_t>(size_classes[i]));
+        thread_cache_hits += stats[i].thread_cache_hits;
+    }
+    EXPECT(thread_cache_hits > 0);
+}
@@ -69,6 +69,47 @@ TEST_CASE(invalid_canonical_code)
     EXPECT(Compress::CanonicalCode::from_bytes(code).is_error());
 }
 
+TEST_CASE(deflate_decompress_end_of_block_in_last_bits)
+{
+    // Six 9-bit literals leave exactly the 7-bit end-of-block code in the last byte, which is less than a full prefix table lookup.
+    Array<u8, 8> const compressed {
+        0x3B, 0xF1, 0xF2, 0xC3, 0x84, 0xFF, 0x4B, 0x01
+    };
+    Array<u8, 6> const uncompressed {
+        0xC8, 0xE9, 0xF0, 0x90, 0xFF, 0xA5
+    };
+
+    auto const decompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(decompressed.bytes() == uncompressed.span());
+}
+
+TEST_CASE(deflate_round_trip_back_references)
+{
+    // Mix short and long codes with back-references of all distances, including ones that overlap their own output
+    auto size = 256 * KiB;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    u32 state = 1;
+    auto next_random = [&] {
+        state = state * 1103515245 + 12345;
+        return state >> 16;
+    };
+    for (size_t i = 0; i < size;) {
+        auto value = next_random();
+        if (i > 0 && value % 16 == 0) {
+            auto distance = 1 + next_random() % min<size_t>(i, 32 * KiB);
+            auto length = 3 + next_random() % 256;
+            for (size_t j = 0; j < length && i < size; ++j, ++i)
+                original[i] = original[i - distance];
+        } else {
+            original[i++] = value % 5 == 0 ? next_random() & 0xff : 'a' + value % 4;
+        }
+    }
+
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(deflate_decompress_compressed_block)
 {
     Array<u8, 28> const compressed {
@@ -156,6 +197,30 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_parallel)
+{
+    // Repeat a random pattern so that chunks can only compress well by referring back into the previous chunk
+    auto size = Compress::DeflateCompressor::parallel_chunk_size * 3 + Compress::DeflateCompressor::parallel_chunk_size / 2;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    Array<u8, 1000> pattern;
+    fill_with_random(pattern);
+    for (size_t i = 0; i < size; i++)
+        original[i] = pattern[i % pattern.size()];
+
+    Array<size_t, 4> chunk_sizes {};
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_parallel(original, Compress::DeflateCompressor::CompressionLevel::FAST, 3, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_sizes[chunk_index] = chunk.size();
+    }));
+    // Without the previous chunk as a dictionary, every chunk would have to spell out the 1000 byte pattern again.
+    auto single_stream = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    EXPECT(compressed.size() < single_stream.size() + 100);
+    EXPECT_EQ(chunk_sizes[0], Compress::DeflateCompressor::parallel_chunk_size);
+    EXPECT_EQ(chunk_sizes[3], Compress::DeflateCompressor::parallel_chunk_size / 2);
+
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
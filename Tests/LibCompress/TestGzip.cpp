@@ -94,6 +94,39 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(gzip_round_trip_parallel)
+{
+    // The decompressor validates the checksum, which is stitched together from per-chunk checksums
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::parallel_chunk_size * 2 + 1234).release_value();
+    fill_with_random(original);
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 0));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(gzip_round_trip_thread_counts)
+{
+    // 1 takes the single-stream path, anything else the parallel one (0 meaning one thread per processor).
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::parallel_chunk_size * 3 + 17).release_value();
+    fill_with_random(original);
+    original.bytes().slice(0, Compress::DeflateCompressor::parallel_chunk_size).fill('A');
+
+    ByteBuffer parallel_reference;
+    for (size_t thread_count : { 1, 2, 0 }) {
+        auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, thread_count));
+        auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+
+        // The parallel output doesn't depend on how many threads produced it.
+        if (thread_count == 1)
+            continue;
+        if (parallel_reference.is_empty())
+            parallel_reference = move(compressed);
+        else
+            EXPECT(compressed == parallel_reference);
+    }
+}
+
 TEST_CASE(gzip_truncated_uncompressed_block)
 {
     Array<u8, 38> const compressed {
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+TEST_CASE(notifier_on_regular_file)
+{
+    auto event_loop = Core::EventLoop();
+
+    // Regular files never block, so their notifiers should fire right away, just like poll() reports them as ready.
+    auto fd = MUST(Core::System::open("/tmp/test-notifier-regular-file"sv, O_CREAT | O_RDWR | O_TRUNC, 0644));
+    MUST(Core::System::unlink("/tmp/test-notifier-regular-file"sv));
+
+    auto notifier = Core::Notifier::construct(fd, Core::Notifier::Type::Read);
+    int activation_count = 0;
+    notifier->on_activation = [&] {
+        if (++activation_count == 2)
+            event_loop.quit(0);
+    };
+
+    auto catchall_timer = MUST(Core::Timer::create_single_shot(1000, [&] {
+        FAIL("Notifier on a regular file never fired");
+        event_loop.quit(1);
+    }));
+    catchall_timer->start();
+
+    EXPECT_EQ(event_loop.exec(), 0);
+    EXPECT_EQ(activation_count, 2);
+
+    notifier->set_enabled(false);
+    MUST(Core::System::close(fd));
+}
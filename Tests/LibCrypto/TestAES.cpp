@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibTest/TestCase.h>
@@ -454,3 +456,75 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+static ByteBuffer make_test_pattern(size_t length, u8 seed)
+{
+    auto buffer = ByteBuffer::create_uninitialized(length).release_value();
+    for (size_t i = 0; i < length; ++i)
+        buffer[i] = static_cast<u8>(i * 31 + seed);
+    return buffer;
+}
+
+// These compare whichever accelerated paths the machine supports against the portable implementation.
+TEST_CASE(test_AES_CTR_accelerated_matches_portable)
+{
+    ScopeGuard restore_features = [] { Crypto::restrict_cpu_features(Crypto::CPUFeatures::all()); };
+
+    auto key = make_test_pattern(32, 7);
+    // A counter close to wrapping around checks that batched key stream generation carries correctly.
+    auto iv = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\xff\xff\xff\xfa"_b;
+
+    for (size_t key_bits : { 128, 192, 256 }) {
+        for (size_t length : { 1, 16, 127, 128, 129, 1000 }) {
+            auto input = make_test_pattern(length, 3);
+            auto accelerated = ByteBuffer::create_zeroed(length).release_value();
+            auto portable = ByteBuffer::create_zeroed(length).release_value();
+
+            Crypto::restrict_cpu_features(Crypto::CPUFeatures::all());
+            Crypto::Cipher::AESCipher::CTRMode accelerated_cipher(key.bytes().trim(key_bits / 8), key_bits, Crypto::Cipher::Intent::Encryption);
+            auto accelerated_bytes = accelerated.bytes();
+            accelerated_cipher.encrypt(input, accelerated_bytes, iv);
+
+            Crypto::restrict_cpu_features({});
+            Crypto::Cipher::AESCipher::CTRMode portable_cipher(key.bytes().trim(key_bits / 8), key_bits, Crypto::Cipher::Intent::Encryption);
+            auto portable_bytes = portable.bytes();
+            portable_cipher.encrypt(input, portable_bytes, iv);
+
+            EXPECT_EQ(accelerated, portable);
+        }
+    }
+}
+
+TEST_CASE(test_AES_GCM_accelerated_matches_portable)
+{
+    ScopeGuard restore_features = [] { Crypto::restrict_cpu_features(Crypto::CPUFeatures::all()); };
+
+    auto key = make_test_pattern(16, 11);
+    auto iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b;
+    auto aad = make_test_pattern(77, 5);
+
+    for (size_t length : { 0, 13, 64, 200, 1024 }) {
+        auto input = make_test_pattern(length, 1);
+        auto accelerated = ByteBuffer::create_zeroed(length).release_value();
+        auto portable = ByteBuffer::create_zeroed(length).release_value();
+        u8 accelerated_tag[16];
+        u8 portable_tag[16];
+
+        Crypto::restrict_cpu_features(Crypto::CPUFeatures::all());
+        Crypto::Cipher::AESCipher::GCMMode accelerated_cipher(key, 128, Crypto::Cipher::Intent::Encryption);
+        accelerated_cipher.encrypt(input, accelerated.bytes(), iv, aad, { accelerated_tag, 16 });
+
+        Crypto::restrict_cpu_features({});
+        Crypto::Cipher::AESCipher::GCMMode portable_cipher(key, 128, Crypto::Cipher::Intent::Encryption);
+        portable_cipher.encrypt(input, portable.bytes(), iv, aad, { portable_tag, 16 });
+
+        EXPECT_EQ(accelerated, portable);
+        EXPECT(memcmp(accelerated_tag, portable_tag, 16) == 0);
+
+        auto decrypted = ByteBuffer::create_zeroed(length).release_value();
+        Crypto::restrict_cpu_features(Crypto::CPUFeatures::all());
+        auto consistency = accelerated_cipher.decrypt(portable, decrypted.bytes(), iv, aad, { portable_tag, 16 });
+        EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+        EXPECT_EQ(decrypted, input);
+    }
+}
@@ -201,6 +201,28 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_karatsuba_multiplication)
+{
+    // (2^a - 1) * (2^b - 1) = 2^(a + b) - 2^a - 2^b + 1, for sizes above the Karatsuba threshold, balanced and unbalanced.
+    Crypto::UnsignedBigInteger one(1);
+    struct {
+        size_t left_bits;
+        size_t right_bits;
+    } sizes[] = { { 3200, 3200 }, { 6400, 1600 }, { 5000, 1700 } };
+
+    for (auto [left_bits, right_bits] : sizes) {
+        auto left = one.shift_left(left_bits).minus(one);
+        auto right = one.shift_left(right_bits).minus(one);
+        auto expected = one.shift_left(left_bits + right_bits).minus(one.shift_left(left_bits)).minus(one.shift_left(right_bits)).plus(one);
+        EXPECT_EQ(left.multiplied_by(right), expected);
+        EXPECT_EQ(right.multiplied_by(left), expected);
+    }
+
+    // (2^a - 1)^2 = 2^2a - 2^(a + 1) + 1
+    auto number = one.shift_left(4000).minus(one);
+    EXPECT_EQ(number.multiplied_by(number), one.shift_left(8000).minus(one.shift_left(4001)).plus(one));
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -232,6 +254,28 @@ TEST_CASE(test_unsigned_bigint_division_combined_test)
     EXPECT_EQ(div_result.quotient.multiplied_by(num2).plus(div_result.remainder), num1);
 }
 
+TEST_CASE(test_unsigned_bigint_division_with_large_divisor)
+{
+    // F(n) divides F(2n).
+    auto num1 = bigint_fibonacci(5000);
+    auto num2 = bigint_fibonacci(2500);
+    auto div_result = num1.divided_by(num2);
+    EXPECT_EQ(div_result.remainder, Crypto::UnsignedBigInteger(0));
+    EXPECT_EQ(div_result.quotient.multiplied_by(num2), num1);
+
+    auto num3 = num1.plus(bigint_fibonacci(2400));
+    div_result = num3.divided_by(num2);
+    EXPECT_EQ(div_result.remainder, bigint_fibonacci(2400));
+    EXPECT_EQ(div_result.quotient.multiplied_by(num2).plus(div_result.remainder), num3);
+}
+
+TEST_CASE(test_unsigned_bigint_division_by_zero)
+{
+    auto div_result = bigint_fibonacci(100).divided_by(0);
+    EXPECT(div_result.quotient.is_invalid());
+    EXPECT(div_result.remainder.is_invalid());
+}
+
 TEST_CASE(test_unsigned_bigint_base10_from_string)
 {
     auto result = TRY_OR_FAIL(Crypto::UnsignedBigInteger::from_base(10, "57195071295721390579057195715793"sv));
@@ -267,6 +311,14 @@ TEST_CASE(test_bigint_even_simple_modular_power)
     EXPECT_EQ(result.words(), Vector<u32> { 9 });
 }
 
+TEST_CASE(test_bigint_modular_power_with_zero_modulus)
+{
+    Crypto::UnsignedBigInteger base { 7 };
+    Crypto::UnsignedBigInteger exponent { 65537 };
+    auto result = Crypto::NumberTheory::ModularPower(base, exponent, 0);
+    EXPECT(result.is_invalid());
+}
+
 TEST_CASE(test_bigint_odd_simple_modular_power)
 {
     Crypto::UnsignedBigInteger base { 10 };
@@ -335,6 +387,28 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_large_odd_modular_power)
+{
+    // b^(e1 + e2) = b^e1 * b^e2 (mod m), with numbers the size of an RSA-2048 key.
+    auto modulo = bigint_fibonacci(2950);
+    EXPECT(modulo.is_odd());
+    auto base = bigint_fibonacci(2900);
+
+    Crypto::UnsignedBigInteger exponents[] = {
+        bigint_fibonacci(2800),
+        Crypto::UnsignedBigInteger(65537),
+        Crypto::UnsignedBigInteger(1).shift_left(1000).plus(1),
+    };
+
+    for (auto& exponent : exponents) {
+        auto e1 = exponent;
+        auto e2 = bigint_fibonacci(1000);
+        auto actual = Crypto::NumberTheory::ModularPower(base, e1.plus(e2), modulo);
+        auto expected = Crypto::NumberTheory::ModularPower(base, e1, modulo).multiplied_by(Crypto::NumberTheory::ModularPower(base, e2, modulo)).divided_by(modulo).remainder;
+        EXPECT_EQ(actual, expected);
+    }
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -63,3 +63,15 @@ TEST_CASE(test_crc32)
     do_test(ByteString("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(ByteString("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+TEST_CASE(test_crc32_combine)
+{
+    auto first = "The quick brown fox "sv.bytes();
+    auto second = "jumps over the lazy dog"sv.bytes();
+    auto first_digest = Crypto::Checksum::CRC32(first).digest();
+    auto second_digest = Crypto::Checksum::CRC32(second).digest();
+
+    EXPECT_EQ(Crypto::Checksum::CRC32::combine(first_digest, second_digest, second.size()), 0x414FA339u);
+    EXPECT_EQ(Crypto::Checksum::CRC32::combine(first_digest, 0, 0), first_digest);
+    EXPECT_EQ(Crypto::Checksum::CRC32::combine(0, second_digest, second.size()), second_digest);
+}
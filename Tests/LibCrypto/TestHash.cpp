@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Authentication/HMAC.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
 #include <LibCrypto/Hash/MD5.h>
 #include <LibCrypto/Hash/SHA1.h>
@@ -241,6 +243,69 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_many)
+{
+    ScopeGuard restore_features = [] { Crypto::restrict_cpu_features(Crypto::CPUFeatures::all()); };
+
+    // Messages of different lengths finish after different numbers of blocks, and padding
+    // takes one or two blocks depending on how much room the last block has left.
+    Vector<ByteBuffer> messages;
+    Vector<ReadonlyBytes> message_bytes;
+    for (size_t i = 0; i < 19; ++i) {
+        auto message = MUST(ByteBuffer::create_uninitialized(i * 29));
+        for (size_t j = 0; j < message.size(); ++j)
+            message[j] = static_cast<u8>(i + j);
+        messages.append(move(message));
+    }
+    for (auto const& message : messages)
+        message_bytes.append(message.bytes());
+
+    // Only allowing AVX2 makes hash_many() interleave the messages instead of using the SHA extensions.
+    for (auto features : { Crypto::CPUFeatures { .avx2 = true }, Crypto::CPUFeatures {} }) {
+        Crypto::restrict_cpu_features(features);
+
+        Vector<Crypto::Hash::SHA256::DigestType> digests;
+        digests.resize(messages.size());
+        Crypto::Hash::SHA256::hash_many(message_bytes, digests);
+
+        for (size_t i = 0; i < messages.size(); ++i)
+            EXPECT_EQ(digests[i], Crypto::Hash::SHA256::hash(messages[i]));
+    }
+}
+
+template<typename HashFunction>
+static void expect_accelerated_hash_matches_portable(ReadonlyBytes data)
+{
+    Crypto::restrict_cpu_features({});
+    auto portable = HashFunction::hash(data.data(), data.size());
+
+    Crypto::restrict_cpu_features(Crypto::CPUFeatures::all());
+    auto accelerated = HashFunction::hash(data.data(), data.size());
+
+    // Feed the data in odd-sized pieces, so that updates start both with and without buffered bytes.
+    HashFunction hash;
+    for (size_t offset = 0; offset < data.size(); offset += 100)
+        hash.update(data.slice(offset, min<size_t>(100, data.size() - offset)));
+
+    EXPECT_EQ(accelerated, portable);
+    EXPECT_EQ(hash.digest(), portable);
+}
+
+TEST_CASE(test_hashes_accelerated_match_portable)
+{
+    ScopeGuard restore_features = [] { Crypto::restrict_cpu_features(Crypto::CPUFeatures::all()); };
+
+    auto data = MUST(ByteBuffer::create_uninitialized(1000));
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<u8>(i * 7);
+
+    for (size_t length : { 0, 55, 56, 64, 128, 129, 1000 }) {
+        expect_accelerated_hash_matches_portable<Crypto::Hash::SHA1>(data.bytes().trim(length));
+        expect_accelerated_hash_matches_portable<Crypto::Hash::SHA256>(data.bytes().trim(length));
+        expect_accelerated_hash_matches_portable<Crypto::Hash::BLAKE2b>(data.bytes().trim(length));
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
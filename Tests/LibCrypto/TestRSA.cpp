@@ -129,6 +129,20 @@ TEST_CASE(test_RSA_encrypt_decrypt)
     EXPECT(memcmp(enc.data(), "WellHelloFriendsWellHelloFriendsWellHelloFriendsWellHelloFriends", 64) == 0);
 }
 
+TEST_CASE(test_RSA_zero_modulus)
+{
+    Crypto::PK::RSA rsa("0"_bigint, "3"_bigint, "65537"_bigint);
+
+    u8 buffer[8] {};
+    auto buf = Bytes { buffer, sizeof(buffer) };
+    rsa.verify("hello"_b, buf);
+    EXPECT(buf.is_empty());
+
+    buf = Bytes { buffer, sizeof(buffer) };
+    rsa.sign("hello"_b, buf);
+    EXPECT(buf.is_empty());
+}
+
 TEST_CASE(test_RSA_EMSA_PSS_construction)
 {
     // This is a template validity test
@@ -170,7 +170,12 @@ ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_str
         member.modification_time = to_packed_dos_time(modification_time->hour(), modification_time->minute(), modification_time->second());
     }
 
-    auto deflate_buffer = Compress::DeflateCompressor::compress_all(buffer);
+    // Compress on all processors, checksumming each chunk on the thread that compresses it.
+    Vector<u32> chunk_checksums;
+    TRY(chunk_checksums.try_resize(Compress::DeflateCompressor::parallel_chunk_count(buffer.size())));
+    auto deflate_buffer = Compress::DeflateCompressor::compress_all_parallel(buffer, Compress::DeflateCompressor::CompressionLevel::GOOD, 0, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::CRC32 { chunk }.digest();
+    });
     auto compression_ratio = 1.f;
     auto compressed_size = buffer.size();
 
@@ -187,8 +192,17 @@ ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_str
 
     member.uncompressed_size = buffer.size();
 
-    Crypto::Checksum::CRC32 checksum { buffer.bytes() };
-    member.crc32 = checksum.digest();
+    if (deflate_buffer.is_error()) {
+        Crypto::Checksum::CRC32 checksum { buffer.bytes() };
+        member.crc32 = checksum.digest();
+    } else {
+        member.crc32 = 0;
+        for (size_t i = 0; i < chunk_checksums.size(); ++i) {
+            auto chunk_offset = i * Compress::DeflateCompressor::parallel_chunk_size;
+            auto chunk_size = min(Compress::DeflateCompressor::parallel_chunk_size, buffer.size() - chunk_offset);
+            member.crc32 = Crypto::Checksum::CRC32::combine(member.crc32, chunk_checksums[i], chunk_size);
+        }
+    }
     member.is_directory = false;
 
     TRY(add_member(member));
@@ -50,11 +50,27 @@ constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// Each thread keeps a few free chunks of the small size classes around, so that most malloc() and free()
+// calls don't need the malloc mutex. Chunks move between a thread's cache and the shared blocks in batches.
+constexpr size_t largest_thread_cached_chunk_size = 496;
+constexpr size_t thread_cache_bin_capacity = 16;
+constexpr size_t thread_cache_batch_size = thread_cache_bin_capacity / 2;
+
+consteval size_t count_thread_cached_size_classes()
+{
+    size_t count = 0;
+    while (size_classes[count] && size_classes[count] <= largest_thread_cached_chunk_size)
+        ++count;
+    return count;
+}
+constexpr size_t num_thread_cached_size_classes = count_thread_cached_size_classes();
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
 static bool s_in_userspace_emulator = false;
+static bool s_use_thread_caches = true;
 
 ALWAYS_INLINE static void ue_notify_malloc(void const* ptr, size_t size)
 {
@@ -128,6 +144,10 @@ struct Allocator {
     size_t block_count { 0 };
     ChunkedBlock::List usable_blocks;
     ChunkedBlock::List full_blocks;
+
+    size_t thread_cache_hits { 0 };
+    size_t thread_cache_misses { 0 };
+    size_t thread_cache_drains { 0 };
 };
 
 struct BigAllocator {
@@ -153,6 +173,11 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+static inline size_t size_class_index(Allocator const& allocator)
+{
+    return &allocator - allocators();
+}
+
 // --- BEGIN MATH ---
 // This stuff is only used for checking if there exists an aligned block in a
 // chunk. It has no bearing on the rest of the allocator, especially for
@@ -237,8 +262,6 @@ static BigAllocator* big_allocator_for_size(size_t size)
 }
 #endif
 
-extern "C" {
-
 static ErrorOr<void*> os_alloc(size_t size, char const* name)
 {
     int flags = MAP_ANONYMOUS | MAP_PRIVATE | MAP_PURGEABLE;
@@ -284,6 +307,191 @@ static void* try_allocate_chunk_aligned(size_t align, ChunkedBlock& block)
     return nullptr;
 }
 
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block && s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block && s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(*block);
+        allocator->usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(*block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+struct ThreadCacheBin {
+    void* chunks[thread_cache_bin_capacity] {};
+    size_t count { 0 };
+    // Hits are counted here and only added to the shared statistics whenever the thread takes the malloc mutex anyway.
+    size_t unreported_hits { 0 };
+};
+
+static __thread ThreadCacheBin s_thread_cache_bins[num_thread_cached_size_classes];
+
+static bool should_use_thread_cache(Allocator const& allocator, size_t align)
+{
+    // Every chunk is 16-byte aligned, so any of them will do for smaller alignments.
+    return s_use_thread_caches && align <= 16 && size_class_index(allocator) < num_thread_cached_size_classes;
+}
+
+static ErrorOr<void*> take_chunk_from_thread_cache(Allocator& allocator)
+{
+    auto& bin = s_thread_cache_bins[size_class_index(allocator)];
+    if (bin.count > 0) {
+        ++bin.unreported_hits;
+        return bin.chunks[--bin.count];
+    }
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    ++allocator.thread_cache_misses;
+    allocator.thread_cache_hits += exchange(bin.unreported_hits, 0);
+    // Hand out one chunk right away and keep the rest of the batch.
+    auto* ptr = TRY(allocate_chunk(allocator, allocator.size, 16));
+    while (bin.count < thread_cache_batch_size - 1) {
+        auto chunk_or_error = allocate_chunk(allocator, allocator.size, 16);
+        if (chunk_or_error.is_error())
+            break;
+        bin.chunks[bin.count++] = chunk_or_error.release_value();
+    }
+    return ptr;
+}
+
+static bool put_chunk_into_thread_cache(ChunkedBlock* block, void* ptr)
+{
+    size_t good_size;
+    auto* allocator = allocator_for_size(block->bytes_per_chunk(), good_size);
+    VERIFY(allocator);
+    if (!should_use_thread_cache(*allocator, 16))
+        return false;
+
+    auto& bin = s_thread_cache_bins[size_class_index(*allocator)];
+    if (bin.count == thread_cache_bin_capacity) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        ++allocator->thread_cache_drains;
+        allocator->thread_cache_hits += exchange(bin.unreported_hits, 0);
+        for (size_t i = 0; i < thread_cache_batch_size; ++i) {
+            auto* chunk = bin.chunks[--bin.count];
+            free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+    }
+    bin.chunks[bin.count++] = ptr;
+    return true;
+}
+#endif
+
+extern "C" {
+
+
 enum class CallerWillInitializeMemory {
     No,
     Yes,
@@ -321,9 +529,8 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (!allocator) {
+        PthreadMutexLocker locker(s_malloc_mutex);
         size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
         if (real_size < size) {
             dbgln_if(MALLOC_DEBUG, "LibC: Detected overflow trying to do big allocation of size {} for {}", real_size, size);
@@ -365,79 +572,18 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return ptr;
     }
 
-    ChunkedBlock* block = nullptr;
     void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
+#ifndef NO_TLS
+    if (should_use_thread_cache(*allocator, align))
+        ptr = TRY(take_chunk_from_thread_cache(*allocator));
+#endif
     if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
+        PthreadMutexLocker locker(s_malloc_mutex);
+        ptr = TRY(allocate_chunk(*allocator, good_size, align));
     }
 
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -459,9 +605,8 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
+        PthreadMutexLocker locker(s_malloc_mutex);
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
@@ -489,51 +634,16 @@ static void free_impl(void* ptr)
     assert(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
+#ifndef NO_TLS
+    if (put_chunk_into_thread_cache(block, ptr))
+        return;
+#endif
 
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    PthreadMutexLocker locker(s_malloc_mutex);
+    free_chunk(block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -663,6 +773,8 @@ void __malloc_init()
         // keeps track of heap memory anyway.
         s_scrub_malloc = false;
         s_scrub_free = false;
+        // Chunks sitting in a thread cache would look like leaks to UE.
+        s_use_thread_caches = false;
     }
 
     if (secure_getenv("LIBC_NOSCRUB_MALLOC"))
@@ -673,6 +785,8 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (secure_getenv("LIBC_NO_MALLOC_THREAD_CACHE"))
+        s_use_thread_caches = false;
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -682,6 +796,55 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_release_thread_cache()
+{
+#ifndef NO_TLS
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (size_t i = 0; i < num_thread_cached_size_classes; ++i) {
+        auto& bin = s_thread_cache_bins[i];
+        allocators()[i].thread_cache_hits += exchange(bin.unreported_hits, 0);
+        while (bin.count > 0) {
+            auto* chunk = bin.chunks[--bin.count];
+            free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+    }
+#endif
+}
+
+size_t serenity_get_malloc_size_class_stats(struct serenity_malloc_size_class_stats* stats, size_t count)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (size_t i = 0; i < min(count, num_size_classes); ++i) {
+        auto const& allocator = allocators()[i];
+        size_t block_count = 0;
+        size_t chunks_in_use = 0;
+        for (auto const& block : allocator.usable_blocks) {
+            ++block_count;
+            chunks_in_use += block.used_chunks();
+        }
+        for (auto const& block : allocator.full_blocks) {
+            ++block_count;
+            chunks_in_use += block.used_chunks();
+        }
+
+        auto thread_cache_hits = allocator.thread_cache_hits;
+#ifndef NO_TLS
+        // Hits of other threads show up once they next take the malloc mutex.
+        if (i < num_thread_cached_size_classes)
+            thread_cache_hits += s_thread_cache_bins[i].unreported_hits;
+#endif
+        stats[i] = {
+            .chunk_size = allocator.size,
+            .block_count = block_count,
+            .chunks_in_use = chunks_in_use,
+            .thread_cache_hits = thread_cache_hits,
+            .thread_cache_misses = allocator.thread_cache_misses,
+            .thread_cache_drains = allocator.thread_cache_drains,
+        };
+    }
+    return num_size_classes;
+}
+
 void serenity_dump_malloc_stats()
 {
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
@@ -705,5 +868,15 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+
+    serenity_malloc_size_class_stats size_class_stats[num_size_classes];
+    serenity_get_malloc_size_class_stats(size_class_stats, num_size_classes);
+    for (auto const& stats : size_class_stats) {
+        if (stats.block_count == 0 && stats.thread_cache_misses == 0)
+            continue;
+        dbgln("size class {}: {} blocks, {} chunks in use, thread cache hits/misses/drains: {}/{}/{}", stats.chunk_size,
+            stats.block_count, stats.chunks_in_use, stats.thread_cache_hits, stats.thread_cache_misses, stats.thread_cache_drains);
+    }
 }
 }
@@ -16,7 +16,11 @@
 
 #define PAGE_ROUND_UP(x) ((((size_t)(x)) + PAGE_SIZE - 1) & (~(PAGE_SIZE - 1)))
 
-static constexpr unsigned short size_classes[] = { 16, 32, 64, 128, 256, 496, 1008, 2032, 4080, 8176, 16368, 32752, 0 };
+// Size classes are spaced more finely than powers of two, so that rounding a request up to its class wastes less memory.
+static constexpr unsigned short size_classes[] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 496,
+    624, 752, 880, 1008, 1520, 2032, 3056, 4080, 6128, 8176, 12272, 16368, 24560, 32752, 0
+};
 static constexpr size_t num_size_classes = (sizeof(size_classes) / sizeof(unsigned short)) - 1;
 
 #ifndef NO_TLS
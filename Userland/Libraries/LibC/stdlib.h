@@ -29,6 +29,18 @@ __attribute__((malloc)) __attribute__((alloc_size(1, 2))) void* calloc(size_t nm
 size_t malloc_size(void const*);
 size_t malloc_good_size(size_t);
 void serenity_dump_malloc_stats(void);
+
+struct serenity_malloc_size_class_stats {
+    size_t chunk_size;
+    size_t block_count;
+    // This includes the chunks sitting in the caches of threads.
+    size_t chunks_in_use;
+    size_t thread_cache_hits;
+    size_t thread_cache_misses;
+    size_t thread_cache_drains;
+};
+// Fills in the statistics for up to `count` size classes, and returns the number of size classes.
+size_t serenity_get_malloc_size_class_stats(struct serenity_malloc_size_class_stats*, size_t count);
 void free(void*);
 __attribute__((alloc_size(2))) void* realloc(void* ptr, size_t);
 char* getenv(char const* name);
@@ -11,7 +11,9 @@
 #include <AK/BinarySearch.h>
 #include <AK/BitStream.h>
 #include <AK/MemoryStream.h>
+#include <LibThreading/Thread.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <LibCompress/Deflate.h>
 
@@ -29,7 +31,7 @@ CanonicalCode const& CanonicalCode::fixed_literal_codes()
     if (initialized)
         return code;
 
-    code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
+    code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths, FastTable::Yes));
     initialized = true;
 
     return code;
@@ -43,16 +45,22 @@ CanonicalCode const& CanonicalCode::fixed_distance_codes()
     if (initialized)
         return code;
 
-    code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
+    code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths, FastTable::Yes));
     initialized = true;
 
     return code;
 }
 
-ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
+ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes, FastTable fast_table)
 {
     CanonicalCode code;
 
+    if (fast_table == FastTable::Yes) {
+        // FastTableEntry::symbol only has room for the DEFLATE alphabets.
+        VERIFY(bytes.size() <= max_fast_table_alphabet_size);
+        TRY(code.m_fast_table.try_resize(1 << fast_table_bits));
+    }
+
     auto non_zero_symbols = 0;
     auto last_non_zero = -1;
     for (size_t i = 0; i < bytes.size(); i++) {
@@ -139,12 +147,57 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
 
+    if (fast_table == FastTable::No)
+        return code;
+
+    for (size_t symbol = 0; symbol < code.m_bit_codes.size(); ++symbol) {
+        auto code_length = code.m_bit_code_lengths[symbol];
+        if (code_length == 0 || code_length > fast_table_bits)
+            continue;
+
+        for (size_t index = code.m_bit_codes[symbol]; index < code.m_fast_table.size(); index += 1u << code_length) {
+            auto& entry = code.m_fast_table[index];
+            entry.symbol = symbol;
+            entry.symbol_count = 1;
+            entry.code_length = code_length;
+        }
+    }
+
+    // Only literals can directly follow each other without any extra bits in between.
+    // We pair up entries from the top down, as the entry that decodes the second literal always has a lower index.
+    if (bytes.size() > 256) {
+        for (size_t index = code.m_fast_table.size(); index-- > 0;) {
+            auto& entry = code.m_fast_table[index];
+            if (entry.symbol_count != 1 || entry.symbol >= 256)
+                continue;
+
+            auto next_entry = code.m_fast_table[index >> entry.code_length];
+            if (next_entry.symbol_count != 1 || next_entry.symbol >= 256 || entry.code_length + next_entry.code_length > fast_table_bits)
+                continue;
+
+            entry.second_literal = next_entry.symbol;
+            entry.symbol_count = 2;
+            entry.code_length = entry.code_length + next_entry.code_length;
+        }
+    }
+
     return code;
 }
 
 ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
 {
-    auto prefix = TRY(stream.peek_bits<size_t>(m_max_prefixed_code_length));
+    auto prefix_or_error = stream.peek_bits<size_t>(m_max_prefixed_code_length);
+    if (prefix_or_error.is_error()) {
+        // The last symbol of a stream can be shorter than the prefix we would like to peek at, so go bit by bit instead.
+        size_t prefix = 0;
+        for (size_t i = 0; i < m_max_prefixed_code_length; ++i) {
+            prefix |= TRY(stream.read_bits<size_t>(1)) << i;
+            if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length == i + 1)
+                return symbol_value;
+        }
+        return prefix_or_error.release_error();
+    }
+    auto prefix = prefix_or_error.release_value();
 
     if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length != 0) {
         stream.discard_previously_peeked_bits(code_length);
@@ -186,6 +239,11 @@ ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
+    if (TRY(try_read_more_fast()))
+        return true;
+    if (m_eof)
+        return false;
+
     auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
 
     if (symbol >= 286)
@@ -220,6 +278,117 @@ ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
     return true;
 }
 
+// Decodes as many symbols as possible straight out of a window of the input bits, while both the input and the output have room
+// to spare. Anything out of the ordinary (the end of the input, long or invalid codes) is left to the symbol-by-symbol path.
+ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more_fast()
+{
+    static constexpr size_t bits_per_window = 56;
+    // Codes in the fast tables are at most fast_table_bits long, so a length/distance pair including its extra bits fits into this.
+    static constexpr size_t max_back_reference_bits = CanonicalCode::fast_table_bits + 5 + CanonicalCode::fast_table_bits + 13;
+    static constexpr size_t literal_batch_size = 64;
+
+    auto& input_stream = *m_decompressor.m_input_stream;
+    auto& output_buffer = m_decompressor.m_output_buffer;
+
+    Array<u8, literal_batch_size> literals;
+    size_t literal_count = 0;
+    bool made_progress = false;
+
+    auto flush_literals = [&] {
+        if (literal_count == 0)
+            return;
+        auto written_bytes = output_buffer.write(literals.span().trim(literal_count));
+        VERIFY(written_bytes == literal_count);
+        literal_count = 0;
+        made_progress = true;
+    };
+
+    auto has_output_space = [&] {
+        return output_buffer.empty_space() >= literal_count + max_back_reference_length;
+    };
+
+    bool should_stop = false;
+    while (!should_stop && has_output_space()) {
+        auto window_or_error = input_stream.peek_bits<u64>(bits_per_window);
+        if (window_or_error.is_error())
+            break;
+        auto window = window_or_error.release_value();
+        size_t bits_used = 0;
+
+        while (bits_used + CanonicalCode::fast_table_bits <= bits_per_window && has_output_space()) {
+            auto const bits = window >> bits_used;
+            auto const entry = m_literal_codes.fast_table_entry(bits);
+            if (entry.symbol_count == 0) {
+                should_stop = true;
+                break;
+            }
+
+            if (entry.symbol < 256) {
+                if (literal_count + 2 > literals.size())
+                    flush_literals();
+                literals[literal_count++] = entry.symbol;
+                if (entry.symbol_count == 2)
+                    literals[literal_count++] = entry.second_literal;
+                bits_used += entry.code_length;
+                continue;
+            }
+
+            if (entry.symbol == 256) {
+                bits_used += entry.code_length;
+                m_eof = true;
+                should_stop = true;
+                break;
+            }
+
+            if (entry.symbol >= 286 || !m_distance_codes.has_value()) {
+                should_stop = true;
+                break;
+            }
+
+            if (bits_used + max_back_reference_bits > bits_per_window)
+                break;
+
+            u32 symbol = entry.symbol;
+            size_t symbol_bits = entry.code_length;
+
+            u32 length = max_back_reference_length;
+            if (symbol <= 264) {
+                length = symbol - 254;
+            } else if (symbol <= 284) {
+                auto extra_bits = (symbol - 261) / 4;
+                length = (((symbol - 265) % 4 + 4) << extra_bits) + 3 + ((bits >> symbol_bits) & ((1u << extra_bits) - 1));
+                symbol_bits += extra_bits;
+            }
+
+            auto const distance_entry = m_distance_codes->fast_table_entry(bits >> symbol_bits);
+            if (distance_entry.symbol_count == 0 || distance_entry.symbol >= 30) {
+                should_stop = true;
+                break;
+            }
+            u32 distance_symbol = distance_entry.symbol;
+            symbol_bits += distance_entry.code_length;
+
+            u32 distance = distance_symbol + 1;
+            if (distance_symbol > 3) {
+                auto extra_bits = (distance_symbol / 2) - 1;
+                distance = ((distance_symbol % 2 + 2) << extra_bits) + 1 + ((bits >> symbol_bits) & ((1u << extra_bits) - 1));
+                symbol_bits += extra_bits;
+            }
+
+            flush_literals();
+            auto copied_length = TRY(output_buffer.copy_from_seekback(distance, length));
+            VERIFY(copied_length == length);
+            bits_used += symbol_bits;
+            made_progress = true;
+        }
+
+        input_stream.discard_previously_peeked_bits(bits_used);
+    }
+
+    flush_literals();
+    return made_progress;
+}
+
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
     : m_decompressor(decompressor)
     , m_bytes_remaining(length)
@@ -453,7 +622,7 @@ ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Opt
         return Error::from_string_literal("Number of code lengths does not match the sum of codes");
 
     // Now we extract the code that was used to encode literals and lengths in the block.
-    literal_code = TRY(CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count)));
+    literal_code = TRY(CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count), CanonicalCode::FastTable::Yes));
 
     // Now we extract the code that was used to encode distances in the block.
 
@@ -466,7 +635,7 @@ ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Opt
             return Error::from_string_literal("Length for a single distance code is longer than 1");
     }
 
-    distance_code = TRY(CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count)));
+    distance_code = TRY(CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count), CanonicalCode::FastTable::Yes));
 
     return {};
 }
@@ -576,8 +745,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
-            break; // outside the window
+        if (start - candidate > max_distance)
+            break; // too far back to be encoded, and the rest of the chain is even further
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
 
@@ -703,13 +872,17 @@ void DeflateCompressor::lz77_compress_block()
         m_distance_frequencies[distance_to_base(distance)]++;
     };
 
+    // make the tail of the previously compressed input available for matching, but make sure we don't hash past the end of the data
+    auto block_end = block_size + m_pending_block_size;
+    for (auto position = block_size - m_history_size; position < block_size && position + min_match_length <= block_end; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
     VERIFY(m_compression_constants.great_match_length <= max_match_length);
 
     // our block starts at block_size and is m_pending_block_size in length
-    auto block_end = block_size + m_pending_block_size;
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -1022,12 +1195,15 @@ ErrorOr<void> DeflateCompressor::flush()
         TRY(m_output_stream->align_to_byte_boundary());
 
     // reset all block specific members
-    m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+
+    // keep the most recent block_size bytes of input right before the pending block, so the next block can match against them
+    auto history_size = min(block_size, m_history_size + m_pending_block_size);
+    memmove(m_rolling_window + block_size - history_size, m_rolling_window + block_size + m_pending_block_size - history_size, history_size);
+    m_history_size = history_size;
+    m_pending_block_size = 0;
 
     return {};
 }
@@ -1055,4 +1231,116 @@ ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compres
     return buffer;
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished);
+    VERIFY(m_pending_block_size == 0);
+
+    if (dictionary.size() > block_size)
+        dictionary = dictionary.slice(dictionary.size() - block_size);
+    dictionary.copy_to({ m_rolling_window + block_size - dictionary.size(), dictionary.size() });
+    m_history_size = dictionary.size();
+}
+
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    // an empty stored block ends on a byte boundary, so anything written after it starts on a fresh byte
+    TRY(m_output_stream->write_bits(0b0u, 1));  // not the final block
+    TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_all_parallel(ReadonlyBytes bytes, CompressionLevel compression_level, size_t thread_count, ChunkCallback on_chunk)
+{
+    auto chunk_count = parallel_chunk_count(bytes.size());
+    if (thread_count == 0)
+        thread_count = max<long>(sysconf(_SC_NPROCESSORS_ONLN), 1);
+    thread_count = min(thread_count, chunk_count);
+
+    Vector<ErrorOr<ByteBuffer>> compressed_chunks;
+    TRY(compressed_chunks.try_ensure_capacity(chunk_count));
+    for (size_t i = 0; i < chunk_count; ++i)
+        compressed_chunks.unchecked_append(ByteBuffer {});
+
+    auto compress_chunk = [&](size_t chunk_index) -> ErrorOr<ByteBuffer> {
+        auto chunk_offset = chunk_index * parallel_chunk_size;
+        auto chunk = bytes.slice(chunk_offset, min(parallel_chunk_size, bytes.size() - chunk_offset));
+        if (on_chunk)
+            on_chunk(chunk_index, chunk);
+
+        auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+        auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
+
+        // Letting each chunk refer back into the previous one keeps the compression ratio close to that of a single stream.
+        deflate_stream->set_dictionary(bytes.slice(0, chunk_offset));
+        TRY(deflate_stream->write_until_depleted(chunk));
+        if (chunk_index == chunk_count - 1) {
+            TRY(deflate_stream->final_flush());
+        } else {
+            // The next chunk continues this stream, so we must not write a final block here.
+            TRY(deflate_stream->sync_flush());
+            deflate_stream->m_finished = true;
+        }
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+        TRY(output_stream->read_until_filled(buffer));
+        return buffer;
+    };
+
+    Atomic<size_t> next_chunk_index { 0 };
+    auto compress_chunks = [&] {
+        for (;;) {
+            auto chunk_index = next_chunk_index.fetch_add(1);
+            if (chunk_index >= chunk_count)
+                return;
+            compressed_chunks[chunk_index] = compress_chunk(chunk_index);
+        }
+    };
+
+    // The calling thread takes part in the work as well, so we only need thread_count - 1 helpers.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    TRY(threads.try_ensure_capacity(thread_count));
+    for (size_t i = 1; i < thread_count; ++i) {
+        auto thread_or_error = Threading::Thread::try_create([&] {
+            compress_chunks();
+            return 0;
+        },
+            "Deflate worker"sv);
+        if (thread_or_error.is_error())
+            break;
+        auto thread = thread_or_error.release_value();
+        thread->start();
+        threads.unchecked_append(move(thread));
+    }
+
+    compress_chunks();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    size_t total_size = 0;
+    for (auto& compressed_chunk : compressed_chunks) {
+        if (compressed_chunk.is_error())
+            return compressed_chunk.release_error();
+        total_size += compressed_chunk.value().size();
+    }
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(total_size));
+    size_t offset = 0;
+    for (auto& compressed_chunk : compressed_chunks) {
+        auto const& chunk = compressed_chunk.value();
+        chunk.span().copy_to(buffer.span().slice(offset));
+        offset += chunk.size();
+    }
+
+    return buffer;
+}
+
 }
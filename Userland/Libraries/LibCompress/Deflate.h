@@ -11,6 +11,7 @@
 #include <AK/CircularBuffer.h>
 #include <AK/Endian.h>
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <AK/MaybeOwned.h>
 #include <AK/Stream.h>
 #include <AK/Vector.h>
@@ -27,7 +28,27 @@ public:
     static CanonicalCode const& fixed_literal_codes();
     static CanonicalCode const& fixed_distance_codes();
 
-    static ErrorOr<CanonicalCode> from_bytes(ReadonlyBytes);
+    // The fast table decodes every code of up to fast_table_bits bits with a single lookup. For the literal/length alphabet,
+    // an entry also holds a second literal if both codes fit into the lookup bits.
+    // It is only used by DeflateDecompressor, so other users of this class (the compressor, webp) don't pay for building it.
+    enum class FastTable {
+        No,
+        Yes,
+    };
+    static constexpr size_t fast_table_bits = 11;
+    static constexpr size_t max_fast_table_alphabet_size = 288;
+
+    static ErrorOr<CanonicalCode> from_bytes(ReadonlyBytes, FastTable = FastTable::No);
+
+    struct FastTableEntry {
+        u32 symbol : 9 { 0 };
+        u32 second_literal : 8 { 0 };
+        u32 symbol_count : 2 { 0 }; // 0 if the code is longer than fast_table_bits
+        u32 code_length : 5 { 0 };  // the combined length of all codes in this entry
+    };
+
+    // Only valid for codes created with FastTable::Yes.
+    ALWAYS_INLINE FastTableEntry fast_table_entry(u64 bits) const { return m_fast_table.data()[bits & ((1u << fast_table_bits) - 1)]; }
 
 private:
     static constexpr size_t max_allowed_prefixed_code_length = 8;
@@ -44,6 +65,9 @@ private:
     Array<PrefixTableEntry, 1 << max_allowed_prefixed_code_length> m_prefix_table {};
     size_t m_max_prefixed_code_length { 0 };
 
+    // Empty unless created with FastTable::Yes, in which case it has 1 << fast_table_bits entries.
+    Vector<FastTableEntry> m_fast_table;
+
     // Compression - indexed by symbol
     // Deflate uses a maximum of 288 symbols (maximum of 32 for distances),
     // but this is also used by webp, which can use up to 256 + 24 + (1 << 11) == 2328 symbols.
@@ -60,6 +84,8 @@ private:
         ErrorOr<bool> try_read_more();
 
     private:
+        ErrorOr<bool> try_read_more_fast();
+
         bool m_eof { false };
 
         DeflateDecompressor& m_decompressor;
@@ -129,6 +155,8 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_distance = 32 * KiB;
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -165,8 +193,21 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Primes the search window with data that precedes the stream, so that the first block can reference it.
+    // Only the last block_size bytes are kept. This must be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
+    // Ends the current block and pads the output to a byte boundary with an empty stored block, without ending the stream.
+    ErrorOr<void> sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Compresses parallel_chunk_size sized chunks of the input on separate threads and stitches the results into a single deflate stream.
+    // A thread_count of 0 uses one thread per processor. The callback is invoked once per chunk from the thread compressing it.
+    using ChunkCallback = Function<void(size_t chunk_index, ReadonlyBytes chunk)>;
+    static size_t parallel_chunk_count(size_t input_size) { return max<size_t>(ceil_div(input_size, parallel_chunk_size), 1); }
+    static ErrorOr<ByteBuffer> compress_all_parallel(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD, size_t thread_count = 0, ChunkCallback = {});
+
 private:
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
@@ -204,6 +245,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_history_size { 0 }; // bytes of previous input right before the pending block that matches may refer to
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
@@ -205,8 +205,9 @@ ErrorOr<size_t> GzipDecompressor::write_some(ReadonlyBytes)
     return Error::from_errno(EBADF);
 }
 
-GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream)
+GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream, size_t thread_count)
     : m_output_stream(move(stream))
+    , m_thread_count(thread_count)
 {
 }
 
@@ -226,12 +227,33 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
     TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
-    auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
-    TRY(compressed_stream->write_until_depleted(bytes));
-    TRY(compressed_stream->final_flush());
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32.digest()));
+
+    if (m_thread_count == 1) {
+        auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
+        TRY(compressed_stream->write_until_depleted(bytes));
+        TRY(compressed_stream->final_flush());
+        Crypto::Checksum::CRC32 crc32;
+        crc32.update(bytes);
+        TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32.digest()));
+        TRY(m_output_stream->write_value<LittleEndian<u32>>(bytes.size()));
+        return bytes.size();
+    }
+
+    // Each worker checksums the chunk it compresses, and we stitch the checksums together afterwards.
+    Vector<u32> chunk_checksums;
+    TRY(chunk_checksums.try_resize(DeflateCompressor::parallel_chunk_count(bytes.size())));
+    auto compressed_bytes = TRY(DeflateCompressor::compress_all_parallel(bytes, DeflateCompressor::CompressionLevel::GOOD, m_thread_count, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::CRC32 { chunk }.digest();
+    }));
+    TRY(m_output_stream->write_until_depleted(compressed_bytes));
+
+    u32 checksum = 0;
+    for (size_t i = 0; i < chunk_checksums.size(); ++i) {
+        auto chunk_offset = i * DeflateCompressor::parallel_chunk_size;
+        auto chunk_size = min(DeflateCompressor::parallel_chunk_size, bytes.size() - chunk_offset);
+        checksum = Crypto::Checksum::CRC32::combine(checksum, chunk_checksums[i], chunk_size);
+    }
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(checksum));
     TRY(m_output_stream->write_value<LittleEndian<u32>>(bytes.size()));
     return bytes.size();
 }
@@ -250,10 +272,10 @@ void GzipCompressor::close()
 {
 }
 
-ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
-    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream) };
+    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream), thread_count };
 
     TRY(gzip_stream.write_until_depleted(bytes));
 
@@ -262,7 +284,7 @@ ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return buffer;
 }
 
-ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream)
+ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream, size_t thread_count)
 {
     // We map the whole file instead of streaming to reduce size overhead (gzip header) and increase the deflate block size (better compression)
     // TODO: automatically fallback to buffered streaming for very large files
@@ -274,7 +296,7 @@ ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOw
         input_bytes = file->bytes();
     }
 
-    auto output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes));
+    auto output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes, thread_count));
     TRY(output_stream->write_until_depleted(output_bytes));
 
     return {};
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
+#include <AK/Array.h>
 #include <AK/IDAllocator.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
@@ -19,6 +21,12 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+// epoll lets the kernel keep track of the notifier set between waits, instead of
+// us handing it every file descriptor again on each pass through the loop.
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    define EVENT_LOOP_USES_EPOLL
+#endif
+
 namespace Core {
 
 struct ThreadData;
@@ -26,6 +34,17 @@ struct ThreadData;
 namespace {
 thread_local ThreadData* s_thread_data;
 
+#ifdef EVENT_LOOP_USES_EPOLL
+u32 notification_type_to_epoll_events(NotificationType type)
+{
+    u32 events = 0;
+    if (has_flag(type, NotificationType::Read))
+        events |= EPOLLIN;
+    if (has_flag(type, NotificationType::Write))
+        events |= EPOLLOUT;
+    return events;
+}
+#else
 short notification_type_to_poll_events(NotificationType type)
 {
     short events = 0;
@@ -35,6 +54,7 @@ short notification_type_to_poll_events(NotificationType type)
         events |= POLLOUT;
     return events;
 }
+#endif
 
 bool has_flag(int value, int flag)
 {
@@ -88,17 +108,75 @@ struct ThreadData {
         VERIFY(rc == 0);
 
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+#ifdef EVENT_LOOP_USES_EPOLL
+        if (epoll_fd != -1)
+            close(epoll_fd);
+        epoll_fd = MUST(System::epoll_create1(EPOLL_CLOEXEC));
+
+        VERIFY(notifiers_by_fd.is_empty());
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_pipe_fds[0];
+        MUST(System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+#else
         VERIFY(poll_fds.size() == 0);
         poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
         notifier_by_index.append(nullptr);
+#endif
+    }
+
+#ifdef EVENT_LOOP_USES_EPOLL
+    void update_epoll_interest(int fd, int op)
+    {
+        if (op == EPOLL_CTL_DEL)
+            always_ready_fds.remove(fd);
+        else if (always_ready_fds.contains(fd))
+            return;
+
+        epoll_event event {};
+        event.data.fd = fd;
+        if (auto it = notifiers_by_fd.find(fd); it != notifiers_by_fd.end()) {
+            for (auto* notifier : it->value)
+                event.events |= notification_type_to_epoll_events(notifier->type());
+        }
+
+        auto result = System::epoll_ctl(epoll_fd, op, fd, &event);
+        if (!result.is_error() || op == EPOLL_CTL_DEL)
+            return;
+
+        // The kernel forgets about an fd once it is closed, which may happen before its notifiers are unregistered.
+        // If the fd number was reused since, our idea of whether it is registered can be off in either direction.
+        if (result.error().code() == ENOENT && op == EPOLL_CTL_MOD)
+            result = System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        else if (result.error().code() == EEXIST && op == EPOLL_CTL_ADD)
+            result = System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+
+        // epoll refuses fds that can't block, like regular files. poll() reports those as always ready, so we do too.
+        if (result.is_error() && result.error().code() == EPERM) {
+            always_ready_fds.set(fd);
+            return;
+        }
+        if (result.is_error())
+            dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, result.error());
     }
+#endif
 
     // Each thread has its own timers, notifiers and a wake pipe.
     HashMap<int, NonnullOwnPtr<EventLoopTimer>> timers;
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    int epoll_fd { -1 };
+    // Several notifiers may watch the same fd (e.g. one for reading and one for writing),
+    // but epoll only accepts a single registration per fd.
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+    // Watched fds that epoll doesn't support. Every wait reports them as ready without blocking.
+    HashTable<int> always_ready_fds;
+    Array<epoll_event, 32> epoll_events;
+#else
     Vector<pollfd> poll_fds;
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -187,9 +265,20 @@ retry:
         }
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    if (!thread_data.always_ready_fds.is_empty()) {
+        should_wait_forever = false;
+        timeout = 0;
+    }
+#endif
+
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+#ifdef EVENT_LOOP_USES_EPOLL
+    ErrorOr<int> error_or_marked_fd_count = System::epoll_wait(thread_data.epoll_fd, thread_data.epoll_events, should_wait_forever ? -1 : timeout);
+#else
     ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+#endif
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
         if (error_or_marked_fd_count.error().code() == EINTR)
@@ -198,9 +287,16 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto ready_events = Span<epoll_event> { thread_data.epoll_events }.trim(error_or_marked_fd_count.value());
+    bool woke_up = any_of(ready_events, [&](auto& event) { return event.data.fd == thread_data.wake_pipe_fds[0]; });
+#else
+    bool woke_up = has_flag(thread_data.poll_fds[0].revents, POLLIN);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (woke_up) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -254,10 +350,50 @@ try_select_again:
         }
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    if (error_or_marked_fd_count.value() == 0 && thread_data.always_ready_fds.is_empty())
+        return;
+#else
     if (error_or_marked_fd_count.value() == 0)
         return;
+#endif
 
     // Handle file system notifiers by making them normal events.
+#ifdef EVENT_LOOP_USES_EPOLL
+    for (auto fd : thread_data.always_ready_fds) {
+        auto it = thread_data.notifiers_by_fd.find(fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+        for (auto* notifier : it->value) {
+            auto notifier_type = notifier->type() & (NotificationType::Read | NotificationType::Write);
+            if (notifier_type != NotificationType::None)
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), notifier_type));
+        }
+    }
+
+    for (auto& event : ready_events) {
+        if (event.data.fd == thread_data.wake_pipe_fds[0])
+            continue;
+        auto it = thread_data.notifiers_by_fd.find(event.data.fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+
+        NotificationType type = NotificationType::None;
+        if (has_flag(event.events, EPOLLIN))
+            type |= NotificationType::Read;
+        if (has_flag(event.events, EPOLLOUT))
+            type |= NotificationType::Write;
+        if (has_flag(event.events, EPOLLHUP))
+            type |= NotificationType::HangUp;
+        if (has_flag(event.events, EPOLLERR))
+            type |= NotificationType::Error;
+        for (auto* notifier : it->value) {
+            auto notifier_type = type & notifier->type();
+            if (notifier_type != NotificationType::None)
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), notifier_type));
+        }
+    }
+#else
     for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
         auto& revents = thread_data.poll_fds[i].revents;
         auto& notifier = *thread_data.notifier_by_index[i];
@@ -275,6 +411,7 @@ try_select_again:
         if (type != NotificationType::None)
             ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
     }
+#endif
 }
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -348,9 +485,14 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timers.clear();
+#ifdef EVENT_LOOP_USES_EPOLL
+    // The epoll instance is shared with the parent, so initialize_wake_pipe() replaces it with one of our own.
+    thread_data.notifiers_by_fd.clear();
+#else
     thread_data.poll_fds.clear();
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
+#endif
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -520,6 +662,11 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+    notifiers.append(&notifier);
+    thread_data.update_epoll_interest(notifier.fd(), notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+#else
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -527,12 +674,28 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
         .events = notification_type_to_poll_events(notifier.type()),
         .revents = 0,
     });
+#endif
 }
 
 void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+    VERIFY(it != thread_data.notifiers_by_fd.end());
+    auto& notifiers = it->value;
+    auto index = notifiers.find_first_index(&notifier);
+    VERIFY(index.has_value());
+    notifiers.remove(*index);
+
+    if (notifiers.is_empty()) {
+        thread_data.notifiers_by_fd.remove(it);
+        thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_DEL);
+    } else {
+        thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+    }
+#else
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -546,6 +709,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     }
     thread_data.poll_fds.take_last();
     thread_data.notifier_by_index.take_last();
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
@@ -6,43 +6,147 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BuiltinWrappers.h>
 
 namespace Crypto {
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
- * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * Complexity: O(N*M) where N is the number of words in the quotient and M the number of words in the denominator
+ * Division method (Knuth, "The Art of Computer Programming", Vol. 2, 4.3.1, Algorithm D):
+ * Long division, one word of the quotient at a time. Each quotient word is estimated from the top words
+ * of the remainder and the denominator, which is exact or one too large once the denominator is normalized
+ * so that its top bit is set. If it was too large, the denominator is added back to the remainder.
+ * temp_shift_result and temp_shift_plus hold the normalized numerator and denominator, the other temporaries are unused.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
     UnsignedBigInteger& temp_shift_result,
     UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift,
+    [[maybe_unused]] UnsignedBigInteger& temp_minus,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+
+    // Division by zero has no result, and the divisor may come from untrusted input (e.g. an RSA modulus).
+    if (denominator_length == 0) {
+        quotient.invalidate();
+        remainder.invalidate();
+        return;
+    }
+
+    if (numerator_length < denominator_length) {
+        quotient.set_to_0();
+        remainder.set_to(numerator);
+        return;
+    }
+
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(numerator_length - denominator_length + 1);
+    auto* quotient_words = quotient.m_words.data();
+
+    if (denominator_length == 1) {
+        DoubleWord divisor = denominator.m_words[0];
+        DoubleWord remainder_word = 0;
+        for (size_t i = numerator_length; i-- > 0;) {
+            DoubleWord dividend = (remainder_word << bits_in_word) | numerator.m_words[i];
+            quotient_words[i] = static_cast<Word>(dividend / divisor);
+            remainder_word = dividend % divisor;
+        }
+        quotient.clamp_to_trimmed_length();
+        remainder.set_to(static_cast<Word>(remainder_word));
+        return;
+    }
+
+    // Normalize, so that the top bit of the denominator is set.
+    auto shift = count_leading_zeroes(denominator.m_words[denominator_length - 1]);
+    auto shifted_word = [shift](Word high, Word low) -> Word {
+        if (shift == 0)
+            return high;
+        return (high << shift) | (low >> (bits_in_word - shift));
+    };
+
+    auto& normalized_denominator = temp_shift_plus;
+    normalized_denominator.set_to_0();
+    normalized_denominator.m_words.resize_and_keep_capacity(denominator_length);
+    auto* divisor = normalized_denominator.m_words.data();
+    for (size_t i = denominator_length - 1; i > 0; --i)
+        divisor[i] = shifted_word(denominator.m_words[i], denominator.m_words[i - 1]);
+    divisor[0] = shifted_word(denominator.m_words[0], 0);
+
+    auto& normalized_numerator = temp_shift_result;
+    normalized_numerator.set_to_0();
+    normalized_numerator.m_words.resize_and_keep_capacity(numerator_length + 1);
+    auto* dividend = normalized_numerator.m_words.data();
+    dividend[numerator_length] = shifted_word(0, numerator.m_words[numerator_length - 1]);
+    for (size_t i = numerator_length - 1; i > 0; --i)
+        dividend[i] = shifted_word(numerator.m_words[i], numerator.m_words[i - 1]);
+    dividend[0] = shifted_word(numerator.m_words[0], 0);
+
+    DoubleWord const word_base = static_cast<DoubleWord>(1) << bits_in_word;
+    DoubleWord const divisor_top = divisor[denominator_length - 1];
+    DoubleWord const divisor_second = divisor[denominator_length - 2];
+
+    for (size_t j = numerator_length - denominator_length + 1; j-- > 0;) {
+        // Estimate the quotient word from the top two words of the remainder, and correct it using the next word.
+        DoubleWord top = (static_cast<DoubleWord>(dividend[j + denominator_length]) << bits_in_word) | dividend[j + denominator_length - 1];
+        DoubleWord estimate = top / divisor_top;
+        DoubleWord estimate_remainder = top % divisor_top;
+        while (estimate >= word_base || estimate * divisor_second > ((estimate_remainder << bits_in_word) | dividend[j + denominator_length - 2])) {
+            --estimate;
+            estimate_remainder += divisor_top;
+            if (estimate_remainder >= word_base)
+                break;
+        }
+
+        // dividend[j..j+denominator_length] -= estimate * divisor
+        Word multiply_carry = 0;
+        Word borrow = 0;
+        for (size_t i = 0; i < denominator_length; ++i) {
+            DoubleWord product = estimate * divisor[i] + multiply_carry;
+            multiply_carry = static_cast<Word>(product >> bits_in_word);
+            DoubleWord difference = static_cast<DoubleWord>(dividend[i + j]) - static_cast<Word>(product) - borrow;
+            dividend[i + j] = static_cast<Word>(difference);
+            borrow = static_cast<Word>(difference >> bits_in_word) & 1;
+        }
+        DoubleWord difference = static_cast<DoubleWord>(dividend[j + denominator_length]) - multiply_carry - borrow;
+        dividend[j + denominator_length] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> bits_in_word) & 1;
+
+        if (borrow != 0) {
+            // The estimate was one too large, add the divisor back.
+            --estimate;
+            Word carry = 0;
+            for (size_t i = 0; i < denominator_length; ++i) {
+                DoubleWord sum = static_cast<DoubleWord>(dividend[i + j]) + divisor[i] + carry;
+                dividend[i + j] = static_cast<Word>(sum);
+                carry = static_cast<Word>(sum >> bits_in_word);
             }
+            dividend[j + denominator_length] += carry;
         }
+
+        quotient_words[j] = static_cast<Word>(estimate);
     }
+
+    // Undo the normalization on what's left of the dividend.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i) {
+        if (shift == 0)
+            remainder.m_words[i] = dividend[i];
+        else
+            remainder.m_words[i] = (dividend[i] >> shift) | (dividend[i + 1] << (bits_in_word - shift));
+    }
+
+    quotient.clamp_to_trimmed_length();
+    remainder.clamp_to_trimmed_length();
 }
 
 /**
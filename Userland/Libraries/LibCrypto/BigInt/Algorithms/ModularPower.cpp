@@ -70,52 +70,15 @@ ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
     return static_cast<u32>(-k0);
 }
 
-/**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
- */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
- */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
-{
-    UnsignedBigInteger::Word carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
-    }
-    return carry;
-}
-
 /**
  * Computes the "almost montgomery" product : x * y * 2 ^ (-num_words * BITS_IN_WORD) % modulo
  * [Note : that means that the result z satisfies z * 2^(num_words * BITS_IN_WORD) % modulo = x * y % modulo]
  * assuming :
  *  - x, y and modulo are all already padded to num_words
  *  - k = inverse_wrapped(modulo) (optimization to not recompute K each time)
+ * The product x * y is computed first (with Karatsuba for large numbers, and faster if x and y are the same number),
+ * then reduced one word at a time by adding multiples of the modulo that clear its lowest words.
+ * The result is smaller than 2^(num_words * BITS_IN_WORD), but not necessarily smaller than the modulo.
  * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
 void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allocation(
@@ -127,59 +90,75 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     size_t num_words,
     UnsignedBigInteger& result)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+
     VERIFY(x.length() >= num_words);
     VERIFY(y.length() >= num_words);
     VERIFY(modulo.length() >= num_words);
 
-    z.set_to(0);
-    z.resize_with_leading_zeros(num_words * 2);
+    // z holds the double-sized product, followed by the scratch space needed to compute it.
+    z.set_to_0();
+    z.m_words.resize_and_keep_capacity(2 * num_words + multiplication_scratch_size(num_words, num_words));
+    auto* product = z.m_words.data();
+    multiply_words(x.m_words.data(), num_words, y.m_words.data(), num_words, product, product + 2 * num_words);
 
-    UnsignedBigInteger::Word previous_double_carry { 0 };
+    auto const* modulo_words = modulo.m_words.data();
+    Word overflow = 0;
     for (size_t i = 0; i < num_words; ++i) {
-        // z[i->num_words+i] += x * y_i
-        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z, i, x, y.m_words[i], num_words);
-        // z[i->num_words+i] += modulo * (z_i * k)
-        UnsignedBigInteger::Word t = z.m_words[i] * k;
-        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z, i, modulo, t, num_words);
-
-        // Compute the carry by combining all of the carries of the previous computations
-        // Put it "right after" the range that we computed above
-        UnsignedBigInteger::Word temp_carry = previous_double_carry + carry_1;
-        UnsignedBigInteger::Word overall_carry = temp_carry + carry_2;
-        z.m_words[num_words + i] = overall_carry;
-
-        // Detect if there was a "double carry" for this word by checking if our carry results are smaller than their components
-        previous_double_carry = (temp_carry < carry_1 || overall_carry < carry_2) ? 1 : 0;
+        // product += (modulo * t) << (i * BITS_IN_WORD), with t chosen so that the i-th word of the product becomes zero.
+        DoubleWord t = static_cast<Word>(product[i] * k);
+        Word carry = 0;
+        for (size_t j = 0; j < num_words; ++j) {
+            DoubleWord sum = t * modulo_words[j] + product[i + j] + carry;
+            product[i + j] = static_cast<Word>(sum);
+            carry = static_cast<Word>(sum >> UnsignedBigInteger::BITS_IN_WORD);
+        }
+        DoubleWord top = static_cast<DoubleWord>(product[i + num_words]) + carry + overflow;
+        product[i + num_words] = static_cast<Word>(top);
+        overflow = static_cast<Word>(top >> UnsignedBigInteger::BITS_IN_WORD);
     }
 
-    if (previous_double_carry == 0) {
-        // Return the top num_words bytes of Z, which contains our result.
-        shift_right_by_n_words(z, num_words, result);
-        result.resize_with_leading_zeros(num_words);
+    // The result is the top half of the product, which is "one bigger" than we need it to be if there was an overflow.
+    result.set_to_0();
+    result.m_words.resize_and_keep_capacity(num_words);
+    auto* result_words = result.m_words.data();
+    if (overflow == 0) {
+        __builtin_memcpy(result_words, product + num_words, num_words * sizeof(Word));
         return;
     }
 
-    // We have a carry, so we're "one bigger" than we need to be.
-    // Subtract the modulo from the result (the top half of z), and write it to the bottom half of Z since we have space.
-    // (With carry, of course.)
-    UnsignedBigInteger::Word c { 0 };
+    // Subtract the modulo from the top half of the product (with borrow, of course).
+    Word borrow = 0;
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
-        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
-        UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
-        z.m_words[i] = new_z_digit;
-        // Detect if the subtraction underflowed - from "Hacker's Delight"
-        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+        DoubleWord difference = static_cast<DoubleWord>(product[num_words + i]) - modulo_words[i] - borrow;
+        result_words[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
     }
+}
 
-    // Return the bottom num_words bytes of Z (with the carry bit handled)
-    z.m_words.resize(num_words);
-    result.set_to(z);
-    result.resize_with_leading_zeros(num_words);
+/**
+ * Picks the window size that minimizes the number of multiplications for an exponent of the given size,
+ * taking into account the cost of precomputing the odd powers for the window.
+ */
+static size_t window_size_for_exponent(size_t exponent_bits)
+{
+    if (exponent_bits > 671)
+        return 6;
+    if (exponent_bits > 239)
+        return 5;
+    if (exponent_bits > 79)
+        return 4;
+    if (exponent_bits > 23)
+        return 3;
+    return 1;
 }
 
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
+ * Exponentiation method (sliding window):
+ * Scan the exponent from its most significant bit, squaring once per bit. Runs of up to window_size bits
+ * that start and end with a 1 bit are multiplied in at once, using a table of the odd powers of the base.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
@@ -197,9 +176,7 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
+    constexpr size_t max_window_size = 6;
 
     size_t num_words = modulo.trimmed_length();
     UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
@@ -220,39 +197,60 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
-    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
-
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
-    zz.set_to(0);
-    zz.resize_with_leading_zeros(num_words);
-
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+    size_t exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    size_t window_size = window_size_for_exponent(exponent_bits);
+
+    // Compute the montgomery odd powers of x, powers[i] = x^(2 * i + 1).
+    UnsignedBigInteger powers[1 << (max_window_size - 1)];
+    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[0]);
+    if (window_size > 1) {
+        almost_montgomery_multiplication_without_allocation(powers[0], powers[0], modulo, temp_z, k, num_words, zz);
+        for (size_t i = 1; i < (1u << (window_size - 1)); ++i)
+            almost_montgomery_multiplication_without_allocation(powers[i - 1], zz, modulo, temp_z, k, num_words, powers[i]);
+    }
+
+    // z = 1 (in montgomery form)
+    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, z);
+
+    auto const* exponent_words = exponent.m_words.data();
+    auto exponent_bit = [&](size_t index) {
+        return (exponent_words[index / UnsignedBigInteger::BITS_IN_WORD] >> (index % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    };
+
+    bool is_first_window = true;
+    ssize_t bit_index = static_cast<ssize_t>(exponent_bits) - 1;
+    while (bit_index >= 0) {
+        if (!exponent_bit(bit_index)) {
+            almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
+            swap(z, zz);
+            --bit_index;
+            continue;
+        }
+
+        // Find the longest window starting at bit_index that ends with a 1 bit.
+        ssize_t window_end = max(bit_index - static_cast<ssize_t>(window_size) + 1, static_cast<ssize_t>(0));
+        while (!exponent_bit(window_end))
+            ++window_end;
+
+        size_t window_value = 0;
+        for (ssize_t i = bit_index; i >= window_end; --i)
+            window_value = (window_value << 1) | exponent_bit(i);
+
+        auto& power = powers[window_value >> 1];
+        if (is_first_window) {
+            // z is still 1, so there's no need to square it or to multiply by it.
+            z.set_to(power);
+            is_first_window = false;
+        } else {
+            for (ssize_t i = bit_index; i >= window_end; --i) {
                 almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                swap(z, zz);
             }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
             almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
             swap(z, zz);
-
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
         }
+
+        bit_index = window_end - 1;
     }
 
     almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
@@ -9,38 +9,242 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words, the extra additions and subtractions of Karatsuba cost more than they save.
+static constexpr size_t karatsuba_threshold = 48;
+
+/**
+ * Adds the words of source into destination, rippling the carry through the rest of destination.
+ * Returns the carry out of the top word of destination.
+ */
+static Word add_words(Word* destination, size_t destination_length, Word const* source, size_t source_length)
+{
+    VERIFY(source_length <= destination_length);
+    Word carry = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(destination[i]) + source[i] + carry;
+        destination[i] = static_cast<Word>(sum);
+        carry = static_cast<Word>(sum >> UnsignedBigInteger::BITS_IN_WORD);
+    }
+    for (; carry != 0 && i < destination_length; ++i) {
+        destination[i] += carry;
+        carry = destination[i] == 0 ? 1 : 0;
+    }
+    return carry;
+}
+
+/**
+ * Subtracts the words of source from destination, which must be the larger of the two.
+ */
+static void subtract_words(Word* destination, size_t destination_length, Word const* source, size_t source_length)
+{
+    VERIFY(source_length <= destination_length);
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(destination[i]) - source[i] - borrow;
+        destination[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
+    }
+    for (; borrow != 0 && i < destination_length; ++i) {
+        borrow = destination[i] == 0 ? 1 : 0;
+        destination[i] -= 1;
+    }
+    VERIFY(borrow == 0);
+}
+
+/**
+ * Complexity: O(N*M) where N and M are the number of words in each number
+ * Multiplication method:
+ * Long multiplication, one word of left at a time.
+ */
+static void schoolbook_multiply(Word const* left, size_t left_length, Word const* right, size_t right_length, Word* output)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t i = 0; i < left_length; ++i) {
+        DoubleWord left_word = left[i];
+        Word carry = 0;
+        for (size_t j = 0; j < right_length; ++j) {
+            DoubleWord product = left_word * right[j] + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(product);
+            carry = static_cast<Word>(product >> UnsignedBigInteger::BITS_IN_WORD);
+        }
+        output[i + right_length] = carry;
+    }
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the number, but with about half as many word multiplications as schoolbook_multiply.
+ * Squaring method:
+ * Every cross product number[i] * number[j] with i != j appears twice in the square,
+ * so we only compute the ones with i < j, double their sum, and then add the squares of the individual words.
+ */
+static void schoolbook_square(Word const* number, size_t length, Word* output)
+{
+    __builtin_memset(output, 0, 2 * length * sizeof(Word));
+    for (size_t i = 0; i < length; ++i) {
+        DoubleWord word = number[i];
+        Word carry = 0;
+        for (size_t j = i + 1; j < length; ++j) {
+            DoubleWord product = word * number[j] + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(product);
+            carry = static_cast<Word>(product >> UnsignedBigInteger::BITS_IN_WORD);
+        }
+        output[i + length] = carry;
+    }
+
+    // output *= 2
+    Word top_bit = 0;
+    for (size_t i = 0; i < 2 * length; ++i) {
+        Word next_top_bit = output[i] >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+        output[i] = (output[i] << 1) | top_bit;
+        top_bit = next_top_bit;
+    }
+
+    // output += number[i]^2 << (2 * i * BITS_IN_WORD)
+    Word carry = 0;
+    for (size_t i = 0; i < length; ++i) {
+        DoubleWord square = static_cast<DoubleWord>(number[i]) * number[i] + output[2 * i] + carry;
+        output[2 * i] = static_cast<Word>(square);
+        DoubleWord high = static_cast<DoubleWord>(output[2 * i + 1]) + (square >> UnsignedBigInteger::BITS_IN_WORD);
+        output[2 * i + 1] = static_cast<Word>(high);
+        carry = static_cast<Word>(high >> UnsignedBigInteger::BITS_IN_WORD);
+    }
+    VERIFY(carry == 0);
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N^1.585) where N is the number of words in each number
+ * Multiplication method (Karatsuba):
+ * Split both numbers in a low and a high half, x = x1 * B + x0 and y = y1 * B + y0.
+ * Then x * y = x1y1 * B^2 + ((x0 + x1)(y0 + y1) - x0y0 - x1y1) * B + x0y0,
+ * which only needs three half-sized multiplications instead of four.
+ */
+static void karatsuba_multiply(Word const* left, Word const* right, size_t length, Word* output, Word* scratch)
+{
+    bool is_square = left == right;
+    size_t low_length = length / 2;
+    size_t high_length = length - low_length;
+
+    // output = x1y1 * B^2 + x0y0
+    UnsignedBigIntegerAlgorithms::multiply_words(left, low_length, right, low_length, output, scratch);
+    UnsignedBigIntegerAlgorithms::multiply_words(left + low_length, high_length, right + low_length, high_length, output + 2 * low_length, scratch);
+
+    size_t sum_length = high_length + 1;
+    Word* left_sum = scratch;
+    Word* right_sum = is_square ? left_sum : scratch + sum_length;
+    Word* middle = scratch + 2 * sum_length;
+    size_t middle_length = 2 * sum_length;
+
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(Word));
+    left_sum[high_length] = 0;
+    add_words(left_sum, sum_length, left, low_length);
+    if (!is_square) {
+        __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(Word));
+        right_sum[high_length] = 0;
+        add_words(right_sum, sum_length, right, low_length);
+    }
+
+    // middle = (x0 + x1)(y0 + y1) - x0y0 - x1y1
+    UnsignedBigIntegerAlgorithms::multiply_words(left_sum, sum_length, right_sum, sum_length, middle, middle + middle_length);
+    subtract_words(middle, middle_length, output, 2 * low_length);
+    subtract_words(middle, middle_length, output + 2 * low_length, 2 * high_length);
+
+    // The middle term is smaller than B^(2 * high_length), so the words we can't fit in output are all zero.
+    size_t output_length = 2 * length - low_length;
+    while (middle_length > output_length) {
+        VERIFY(middle[middle_length - 1] == 0);
+        --middle_length;
+    }
+    auto carry = add_words(output + low_length, output_length, middle, middle_length);
+    VERIFY(carry == 0);
+}
+
+/**
+ * Computes output = left * right, where output has room for left_length + right_length words,
+ * and scratch has room for at least multiplication_scratch_size(left_length, right_length) words.
+ * Neither output nor scratch may overlap the inputs.
+ */
+void UnsignedBigIntegerAlgorithms::multiply_words(Word const* left, size_t left_length, Word const* right, size_t right_length, Word* output, Word* scratch)
+{
+    if (left_length < right_length) {
+        swap(left, right);
+        swap(left_length, right_length);
+    }
+
+    if (right_length < karatsuba_threshold) {
+        if (left == right && left_length == right_length)
+            schoolbook_square(left, left_length, output);
+        else
+            schoolbook_multiply(left, left_length, right, right_length, output);
+        return;
+    }
+
+    if (left_length == right_length) {
+        karatsuba_multiply(left, right, left_length, output, scratch);
+        return;
+    }
+
+    // For unbalanced sizes, multiply right by each right_length-sized chunk of left, and sum up the partial products.
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t offset = 0; offset < left_length; offset += right_length) {
+        size_t chunk_length = min(right_length, left_length - offset);
+        Word* partial_product = scratch;
+        multiply_words(left + offset, chunk_length, right, right_length, partial_product, scratch + chunk_length + right_length);
+        add_words(output + offset, left_length + right_length - offset, partial_product, chunk_length + right_length);
+    }
+}
+
+size_t UnsignedBigIntegerAlgorithms::multiplication_scratch_size(size_t left_length, size_t right_length)
+{
+    if (left_length < right_length)
+        swap(left_length, right_length);
+
+    if (right_length < karatsuba_threshold)
+        return 0;
+
+    if (left_length == right_length) {
+        size_t sum_length = left_length - left_length / 2 + 1;
+        return 4 * sum_length + multiplication_scratch_size(sum_length, sum_length);
+    }
+
+    size_t size = 2 * right_length + multiplication_scratch_size(right_length, right_length);
+    if (auto last_chunk_length = left_length % right_length; last_chunk_length != 0)
+        size = max(size, last_chunk_length + right_length + multiplication_scratch_size(last_chunk_length, right_length));
+    return size;
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the larger number, or O(N^1.585) above karatsuba_threshold words
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Long multiplication for small numbers (see multiply_words), Karatsuba for large ones.
+ * temp_shift_result is used as scratch space for Karatsuba, the other temporaries are unused.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
     UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift_plus,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    auto left_length = left.trimmed_length();
+    auto right_length = right.trimmed_length();
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    output.set_to_0();
+    if (left_length == 0 || right_length == 0)
+        return;
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    temp_shift_result.set_to_0();
+    temp_shift_result.m_words.resize_and_keep_capacity(multiplication_scratch_size(left_length, right_length));
+    output.m_words.resize_and_keep_capacity(left_length + right_length);
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    multiply_words(left.m_words.data(), left_length, right.m_words.data(), right_length, output.m_words.data(), temp_shift_result.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+#if ARCH(X86_64)
+// Bits of ecx in cpuid[eax = 1]. The AES-NI code also relies on pshufb from SSSE3 to reorder key and block bytes.
+constexpr u32 cpuid_1_ecx_bit_pclmulqdq = 1 << 1;
+constexpr u32 cpuid_1_ecx_bit_ssse3 = 1 << 9;
+constexpr u32 cpuid_1_ecx_bit_sse4_1 = 1 << 19;
+constexpr u32 cpuid_1_ecx_bit_aes = 1 << 25;
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+
+// Bits of ebx in cpuid[eax = 7, ecx = 0].
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+constexpr u32 cpuid_7_ebx_bit_sha = 1 << 29;
+
+// The SSE and AVX state components in XCR0, both of which the kernel has to save for us to use AVX2.
+constexpr u64 xcr0_sse_and_avx_state = 0b110;
+
+static u64 read_xcr0()
+{
+    u32 eax, edx;
+    asm volatile("xgetbv"
+                 : "=a"(eax), "=d"(edx)
+                 : "c"(0));
+    return (static_cast<u64>(edx) << 32) | eax;
+}
+#endif
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+
+#if ARCH(X86_64)
+    u32 eax, ebx, ecx, edx;
+    __cpuid(1, eax, ebx, ecx, edx);
+
+    bool has_ssse3 = ecx & cpuid_1_ecx_bit_ssse3;
+    bool has_sse4_1 = ecx & cpuid_1_ecx_bit_sse4_1;
+    features.aes = has_ssse3 && (ecx & cpuid_1_ecx_bit_aes);
+    features.pclmulqdq = has_ssse3 && (ecx & cpuid_1_ecx_bit_pclmulqdq);
+
+    bool os_saves_avx_state = (ecx & cpuid_1_ecx_bit_osxsave) && (ecx & cpuid_1_ecx_bit_avx)
+        && (read_xcr0() & xcr0_sse_and_avx_state) == xcr0_sse_and_avx_state;
+
+    if (__get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        features.sha = has_sse4_1 && (ebx & cpuid_7_ebx_bit_sha);
+        features.avx2 = os_saves_avx_state && (ebx & cpuid_7_ebx_bit_avx2);
+    }
+#endif
+
+    return features;
+}
+
+static CPUFeatures& features()
+{
+    static CPUFeatures s_features = detect_cpu_features();
+    return s_features;
+}
+
+CPUFeatures const& cpu_features()
+{
+    return features();
+}
+
+void restrict_cpu_features(CPUFeatures const& allowed)
+{
+    auto detected = detect_cpu_features();
+    features().aes = detected.aes && allowed.aes;
+    features().pclmulqdq = detected.pclmulqdq && allowed.pclmulqdq;
+    features().sha = detected.sha && allowed.sha;
+    features().avx2 = detected.avx2 && allowed.avx2;
+}
+
+}
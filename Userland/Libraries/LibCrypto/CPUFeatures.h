@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+namespace Crypto {
+
+// Instruction set extensions that the accelerated implementations in LibCrypto can make use of.
+struct CPUFeatures {
+    bool aes { false };
+    bool pclmulqdq { false };
+    bool sha { false };
+    bool avx2 { false };
+
+    static constexpr CPUFeatures all() { return { .aes = true, .pclmulqdq = true, .sha = true, .avx2 = true }; }
+};
+
+CPUFeatures const& cpu_features();
+
+// Masks out detected features so that the portable implementations can be tested and benchmarked
+// on machines that would otherwise always take the accelerated paths. Features that the CPU
+// doesn't support stay disabled.
+void restrict_cpu_features(CPUFeatures const& allowed);
+
+}
@@ -12,6 +12,8 @@
 
 namespace Crypto::Checksum {
 
+static constexpr size_t ethernet_polynomial = 0xEDB88320;
+
 #if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
 
 void CRC32::update(ReadonlyBytes span)
@@ -47,8 +49,6 @@ void CRC32::update(ReadonlyBytes span)
 
 #else
 
-static constexpr size_t ethernet_polynomial = 0xEDB88320;
-
 #    if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 
 // This implements Intel's slicing-by-8 algorithm. Their original paper is no longer on their website,
@@ -171,4 +171,40 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Multiplies two polynomials modulo the CRC polynomial. Both are in the reflected bit order CRC32 uses, so x^0 is the top bit.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 bit = 1u << 31; bit != 0; bit >>= 1) {
+        if (a & bit)
+            product ^= b;
+        b = (b & 1) ? (b >> 1) ^ ethernet_polynomial : b >> 1;
+    }
+    return product;
+}
+
+static constexpr auto generate_powers_of_x()
+{
+    // powers[n] is x^(2^n) modulo the CRC polynomial.
+    Array<u32, 32> powers {};
+    powers[0] = 1u << 30;
+    for (size_t n = 1; n < powers.size(); ++n)
+        powers[n] = multiply_modulo_polynomial(powers[n - 1], powers[n - 1]);
+    return powers;
+}
+
+static constexpr auto powers_of_x = generate_powers_of_x();
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    // Appending n bytes to some data multiplies its (unconditioned) CRC by x^(8n), which we compute by square-and-multiply.
+    // The pre- and post-conditioning of both digests cancels out, so we can work with the digests directly.
+    u32 shift = 1u << 31;
+    for (size_t n = 3; second_length != 0; second_length >>= 1, ++n) {
+        if (second_length & 1)
+            shift = multiply_modulo_polynomial(powers_of_x[n % powers_of_x.size()], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_digest) ^ second_digest;
+}
+
 }
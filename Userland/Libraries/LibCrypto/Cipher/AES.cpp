@@ -4,10 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <LibCrypto/Cipher/AESNI.h>
+#endif
+
 namespace Crypto::Cipher {
 
 template<typename T>
@@ -198,6 +204,14 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes) {
+        auto const& aes_key = key();
+        AESNI::encrypt_blocks(aes_key.round_keys(), aes_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -287,6 +301,14 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes) {
+        auto const& aes_key = key();
+        AESNI::decrypt_blocks(aes_key.round_keys(), aes_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -374,6 +396,46 @@ void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
     // clang-format on
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % AESCipherBlock::block_size() == 0);
+    VERIFY(in.size() <= out.size());
+
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes) {
+        auto const& aes_key = key();
+        AESNI::encrypt_blocks(aes_key.round_keys(), aes_key.rounds(), in.data(), out.data(), in.size() / AESCipherBlock::block_size());
+        return;
+    }
+#endif
+
+    for (size_t offset = 0; offset < in.size(); offset += AESCipherBlock::block_size()) {
+        AESCipherBlock block { in.offset(offset), AESCipherBlock::block_size() };
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
+void AESCipher::decrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % AESCipherBlock::block_size() == 0);
+    VERIFY(in.size() <= out.size());
+
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes) {
+        auto const& aes_key = key();
+        AESNI::decrypt_blocks(aes_key.round_keys(), aes_key.rounds(), in.data(), out.data(), in.size() / AESCipherBlock::block_size());
+        return;
+    }
+#endif
+
+    for (size_t offset = 0; offset < in.size(); offset += AESCipherBlock::block_size()) {
+        AESCipherBlock block { in.offset(offset), AESCipherBlock::block_size() };
+        decrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
@@ -119,6 +119,10 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // Process a whole number of blocks at once, which lets the hardware implementation pipeline them.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+    void decrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
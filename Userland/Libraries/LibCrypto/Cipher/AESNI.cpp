@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <LibCrypto/Cipher/AESNI.h>
+#include <LibCrypto/Cipher/Cipher.h>
+
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
+namespace Crypto::Cipher::AESNI {
+
+#if ARCH(X86_64)
+
+static constexpr size_t max_round_count = 14;
+
+// aesenc and aesdec have a latency of several cycles but can be issued every cycle,
+// so we keep this many independent blocks in flight.
+static constexpr size_t interleaved_block_count = 8;
+
+[[gnu::target("aes,ssse3")]] static void load_round_keys(__m128i (&keys)[max_round_count + 1], u32 const* round_keys, size_t rounds)
+{
+    // AESCipherKey stores every round key as four big-endian words.
+    auto const swap_word_bytes = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    for (size_t i = 0; i <= rounds; ++i)
+        keys[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(round_keys + i * 4)), swap_word_bytes);
+}
+
+template<Intent intent, size_t BlockCount>
+[[gnu::target("aes,ssse3")]] ALWAYS_INLINE static void process_blocks(__m128i const (&keys)[max_round_count + 1], size_t rounds, u8 const* in, u8* out)
+{
+    __m128i state[BlockCount];
+
+    for (size_t i = 0; i < BlockCount; ++i)
+        state[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in) + i), keys[0]);
+
+    for (size_t round = 1; round < rounds; ++round) {
+        for (size_t i = 0; i < BlockCount; ++i) {
+            if constexpr (intent == Intent::Encryption)
+                state[i] = _mm_aesenc_si128(state[i], keys[round]);
+            else
+                state[i] = _mm_aesdec_si128(state[i], keys[round]);
+        }
+    }
+
+    for (size_t i = 0; i < BlockCount; ++i) {
+        if constexpr (intent == Intent::Encryption)
+            state[i] = _mm_aesenclast_si128(state[i], keys[rounds]);
+        else
+            state[i] = _mm_aesdeclast_si128(state[i], keys[rounds]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, state[i]);
+    }
+}
+
+template<Intent intent>
+[[gnu::target("aes,ssse3")]] static void process(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    VERIFY(rounds <= max_round_count);
+
+    __m128i keys[max_round_count + 1];
+    load_round_keys(keys, round_keys, rounds);
+
+    for (; block_count >= interleaved_block_count; block_count -= interleaved_block_count) {
+        process_blocks<intent, interleaved_block_count>(keys, rounds, in, out);
+        in += interleaved_block_count * 16;
+        out += interleaved_block_count * 16;
+    }
+
+    for (; block_count > 0; --block_count) {
+        process_blocks<intent, 1>(keys, rounds, in, out);
+        in += 16;
+        out += 16;
+    }
+}
+
+void encrypt_blocks(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    process<Intent::Encryption>(round_keys, rounds, in, out, block_count);
+}
+
+void decrypt_blocks(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    process<Intent::Decryption>(round_keys, rounds, in, out, block_count);
+}
+
+#else
+
+void encrypt_blocks(u32 const*, size_t, u8 const*, u8*, size_t)
+{
+    VERIFY_NOT_REACHED();
+}
+
+void decrypt_blocks(u32 const*, size_t, u8 const*, u8*, size_t)
+{
+    VERIFY_NOT_REACHED();
+}
+
+#endif
+
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Crypto::Cipher::AESNI {
+
+// These take the round keys exactly as AESCipherKey lays them out, and must only be called
+// when cpu_features().aes is set. Decryption expects the key from expand_decrypt_key(), which
+// already is the "equivalent inverse cipher" schedule that aesdec works with.
+void encrypt_blocks(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count);
+void decrypt_blocks(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count);
+
+}
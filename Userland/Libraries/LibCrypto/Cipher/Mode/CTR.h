@@ -170,6 +170,34 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // Ciphers that can encrypt several blocks in one go are handed a batch of counters at a time,
+        // so that a hardware implementation can keep all of them in flight together.
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t blocks_per_batch = 8;
+            u8 key_stream[blocks_per_batch * T::BlockType::block_size()];
+
+            while (length >= sizeof(key_stream)) {
+                for (size_t i = 0; i < blocks_per_batch; ++i) {
+                    __builtin_memcpy(key_stream + i * block_size, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ key_stream, sizeof(key_stream) }, { key_stream, sizeof(key_stream) });
+
+                VERIFY(offset + sizeof(key_stream) <= out.size());
+                auto* output = out.offset(offset);
+                if (in) {
+                    auto const* input = in->offset(offset);
+                    for (size_t i = 0; i < sizeof(key_stream); ++i)
+                        output[i] = input[i] ^ key_stream[i];
+                } else {
+                    __builtin_memcpy(output, key_stream, sizeof(key_stream));
+                }
+
+                length -= sizeof(key_stream);
+                offset += sizeof(key_stream);
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
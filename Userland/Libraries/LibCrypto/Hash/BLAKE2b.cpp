@@ -5,11 +5,79 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/Platform.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
 
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 constexpr static auto ROTRIGHT(u64 a, size_t b) { return (a >> b) | (a << (64 - b)); }
 
+#if ARCH(X86_64)
+// Keeps each row of the 4x4 work matrix in one register, so every mix() of a round
+// runs in parallel: first down the columns, then down the diagonals after rotating
+// rows b, c and d into place.
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static void mix_avx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i x, __m256i y)
+{
+    auto const rotate_right_24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+    auto const rotate_right_16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+    d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotate_right_24);
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+    d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotate_right_16);
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_xor_si256(b, c);
+    b = _mm256_or_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+}
+
+// Picks every other message word listed in `indices`, as the four mixes of a half round each take one of them.
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i gather_message_words(u64 const (&m)[16], u8 const* indices)
+{
+    return _mm256_setr_epi64x(static_cast<i64>(m[indices[0]]), static_cast<i64>(m[indices[2]]), static_cast<i64>(m[indices[4]]), static_cast<i64>(m[indices[6]]));
+}
+
+[[gnu::target("avx2")]] static void transform_avx2(u64 (&hash_state)[8], u8 const* block, u64 const (&message_byte_offset)[2], u64 is_at_last_block, u8 const (&sigma)[12][16])
+{
+    u64 m[16];
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = ByteReader::load64(block + i * sizeof(m[i]));
+
+    auto const* iv = SHA512Constants::InitializationHashes;
+    auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hash_state));
+    auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hash_state + 4));
+    auto c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(iv));
+    auto d = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(iv + 4)),
+        _mm256_setr_epi64x(static_cast<i64>(message_byte_offset[0]), static_cast<i64>(message_byte_offset[1]), static_cast<i64>(is_at_last_block), 0));
+
+    for (size_t i = 0; i < 12; ++i) {
+        auto const* s = sigma[i];
+        mix_avx2(a, b, c, d, gather_message_words(m, s), gather_message_words(m, s + 1));
+
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+
+        mix_avx2(a, b, c, d, gather_message_words(m, s + 8), gather_message_words(m, s + 9));
+
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    auto low = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(hash_state)), _mm256_xor_si256(a, c));
+    auto high = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(hash_state + 4)), _mm256_xor_si256(b, d));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hash_state), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hash_state + 4), high);
+}
+#endif
+
 void BLAKE2b::update(u8 const* in, size_t inlen)
 {
     if (inlen > 0) {
@@ -86,6 +154,13 @@ void BLAKE2b::mix(u64* work_array, u64 a, u64 b, u64 c, u64 d, u64 x, u64 y)
 
 void BLAKE2b::transform(u8 const* block)
 {
+#if ARCH(X86_64)
+    if (cpu_features().avx2) {
+        transform_avx2(m_internal_state.hash_state, block, m_internal_state.message_byte_offset, m_internal_state.is_at_last_block, BLAKE2bSigma);
+        return;
+    }
+#endif
+
     u64 m[16];
     u64 v[16];
 
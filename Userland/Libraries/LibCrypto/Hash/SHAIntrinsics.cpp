@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Platform.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibCrypto/Hash/SHAIntrinsics.h>
+
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
+namespace Crypto::Hash::SHAIntrinsics {
+
+#if ARCH(X86_64)
+
+// Every group of four rounds below consumes one vector of four message words. Once the first four vectors
+// have been loaded, the following ones are computed in place with the msg1/msg2 instructions, so only
+// four vectors are ever live at a time.
+
+[[gnu::target("sha,sse4.1")]] void sha1_transform(u32 (&state)[5], u8 const* blocks, size_t block_count)
+{
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    __m128i e1;
+
+    for (; block_count > 0; --block_count, blocks += 64) {
+        auto saved_abcd = abcd;
+        auto saved_e = e0;
+        __m128i message[4];
+
+#    pragma GCC unroll 20
+        for (size_t group = 0; group < 20; ++group) {
+            auto& current = message[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks + group * 16)), reverse_bytes);
+
+            // e alternates between two registers, as sha1rnds4 needs the old a for the next group's e.
+            auto& e = group % 2 == 0 ? e0 : e1;
+            auto& next_e = group % 2 == 0 ? e1 : e0;
+            if (group == 0)
+                e = _mm_add_epi32(e, current);
+            else
+                e = _mm_sha1nexte_epu32(e, current);
+            next_e = abcd;
+
+            if (group >= 3 && group <= 18)
+                message[(group + 1) % 4] = _mm_sha1msg2_epu32(message[(group + 1) % 4], current);
+
+            switch (group / 5) {
+            case 0:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+                break;
+            case 1:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+                break;
+            case 2:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+                break;
+            default:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+                break;
+            }
+
+            if (group >= 1 && group <= 16)
+                message[(group + 3) % 4] = _mm_sha1msg1_epu32(message[(group + 3) % 4], current);
+            if (group >= 2 && group <= 17)
+                message[(group + 2) % 4] = _mm_xor_si128(message[(group + 2) % 4], current);
+        }
+
+        e0 = _mm_sha1nexte_epu32(e0, saved_e);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<u32>(_mm_extract_epi32(e0, 3));
+}
+
+[[gnu::target("sha,sse4.1")]] void sha256_transform(u32 (&state)[8], u8 const* blocks, size_t block_count)
+{
+    auto const swap_word_bytes = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    // sha256rnds2 wants the state as (a, b, e, f) and (c, d, g, h).
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0xb1);
+    auto hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4)), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    auto cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+    for (; block_count > 0; --block_count, blocks += 64) {
+        auto saved_abef = abef;
+        auto saved_cdgh = cdgh;
+        __m128i message[4];
+
+#    pragma GCC unroll 16
+        for (size_t group = 0; group < 16; ++group) {
+            auto& current = message[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks + group * 16)), swap_word_bytes);
+
+            auto words = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[group * 4])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+
+            if (group >= 3 && group <= 14) {
+                auto& next = message[(group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, message[(group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(words, 0x0e));
+
+            if (group >= 1 && group <= 12)
+                message[(group + 3) % 4] = _mm_sha256msg1_epu32(message[(group + 3) % 4], current);
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+template<int Bits>
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i rotate_right(__m256i value)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(value, Bits), _mm256_slli_epi32(value, 32 - Bits));
+}
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i add(__m256i a, __m256i b)
+{
+    return _mm256_add_epi32(a, b);
+}
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static __m256i gather_lanes(u32 const (&states)[sha256_lane_count][8], size_t word)
+{
+    return _mm256_setr_epi32(
+        static_cast<int>(states[0][word]), static_cast<int>(states[1][word]), static_cast<int>(states[2][word]), static_cast<int>(states[3][word]),
+        static_cast<int>(states[4][word]), static_cast<int>(states[5][word]), static_cast<int>(states[6][word]), static_cast<int>(states[7][word]));
+}
+
+[[gnu::target("avx2")]] void sha256_transform_lanes(u32 (&states)[sha256_lane_count][8], u8 const* const (&blocks)[sha256_lane_count])
+{
+    __m256i w[64];
+    for (size_t i = 0; i < 16; ++i) {
+        u32 words[sha256_lane_count];
+        for (size_t lane = 0; lane < sha256_lane_count; ++lane)
+            words[lane] = AK::convert_between_host_and_big_endian(ByteReader::load32(blocks[lane] + i * 4));
+        w[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words));
+    }
+
+    for (size_t i = 16; i < 64; ++i) {
+        auto s0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<7>(w[i - 15]), rotate_right<18>(w[i - 15])), _mm256_srli_epi32(w[i - 15], 3));
+        auto s1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<17>(w[i - 2]), rotate_right<19>(w[i - 2])), _mm256_srli_epi32(w[i - 2], 10));
+        w[i] = add(add(s1, w[i - 7]), add(s0, w[i - 16]));
+    }
+
+    __m256i state[8];
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = gather_lanes(states, i);
+
+    auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto ep1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<6>(e), rotate_right<11>(e)), rotate_right<25>(e));
+        auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto temp0 = add(add(add(h, ep1), add(ch, w[i])), _mm256_set1_epi32(static_cast<int>(SHA256Constants::RoundConstants[i])));
+        auto ep0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right<2>(a), rotate_right<13>(a)), rotate_right<22>(a));
+        auto maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, temp0);
+        d = c;
+        c = b;
+        b = a;
+        a = add(temp0, add(ep0, maj));
+    }
+
+    __m256i const results[8] { add(state[0], a), add(state[1], b), add(state[2], c), add(state[3], d), add(state[4], e), add(state[5], f), add(state[6], g), add(state[7], h) };
+    for (size_t i = 0; i < 8; ++i) {
+        u32 words[sha256_lane_count];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), results[i]);
+        for (size_t lane = 0; lane < sha256_lane_count; ++lane)
+            states[lane][i] = words[lane];
+    }
+}
+
+#else
+
+void sha1_transform(u32 (&)[5], u8 const*, size_t)
+{
+    VERIFY_NOT_REACHED();
+}
+
+void sha256_transform(u32 (&)[8], u8 const*, size_t)
+{
+    VERIFY_NOT_REACHED();
+}
+
+void sha256_transform_lanes(u32 (&)[sha256_lane_count][8], u8 const* const (&)[sha256_lane_count])
+{
+    VERIFY_NOT_REACHED();
+}
+
+#endif
+
+}
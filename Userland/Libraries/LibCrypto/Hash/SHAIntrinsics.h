@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Crypto::Hash::SHAIntrinsics {
+
+// Compress `block_count` consecutive 64-byte blocks into the state with the SHA extensions.
+// Only call these when cpu_features().sha is set.
+void sha1_transform(u32 (&state)[5], u8 const* blocks, size_t block_count);
+void sha256_transform(u32 (&state)[8], u8 const* blocks, size_t block_count);
+
+// Compress one 64-byte block into each of eight independent SHA-256 states with AVX2,
+// with every message taking up one 32-bit lane. Only call this when cpu_features().avx2 is set.
+static constexpr size_t sha256_lane_count = 8;
+void sha256_transform_lanes(u32 (&states)[sha256_lane_count][8], u8 const* const (&blocks)[sha256_lane_count]);
+
+}
@@ -33,6 +33,9 @@ UnsignedBigInteger ModularInverse(UnsignedBigInteger const& a_, UnsignedBigInteg
 
 UnsignedBigInteger ModularPower(UnsignedBigInteger const& b, UnsignedBigInteger const& e, UnsignedBigInteger const& m)
 {
+    if (m == 0)
+        return UnsignedBigInteger::create_invalid();
+
     if (m == 1)
         return 0;
 
@@ -137,6 +137,10 @@ RSA::KeyPairType RSA::parse_rsa_key(ReadonlyBytes der)
                 return keypair;
             }
             auto modulus = modulus_result.release_value();
+            if (modulus == 0) {
+                dbgln_if(RSA_PARSE_DEBUG, "RSA PKCS#1 private key parse failed: Zero modulus");
+                return keypair;
+            }
 
             auto public_exponent_result = decoder.read<UnsignedBigInteger>();
             if (public_exponent_result.is_error()) {
@@ -233,6 +237,11 @@ void RSA::decrypt(ReadonlyBytes in, Bytes& out)
 
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
     auto exp = NumberTheory::ModularPower(in_integer, m_private_key.private_exponent(), m_private_key.modulus());
+    if (exp.is_invalid()) {
+        dbgln("invalid RSA key");
+        out = {};
+        return;
+    }
     auto size = exp.export_data(out);
 
     auto align = m_private_key.length();
@@ -247,6 +256,11 @@ void RSA::sign(ReadonlyBytes in, Bytes& out)
 {
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
     auto exp = NumberTheory::ModularPower(in_integer, m_private_key.private_exponent(), m_private_key.modulus());
+    if (exp.is_invalid()) {
+        dbgln("invalid RSA key");
+        out = {};
+        return;
+    }
     auto size = exp.export_data(out);
     out = out.slice(out.size() - size, size);
 }
@@ -255,6 +269,11 @@ void RSA::verify(ReadonlyBytes in, Bytes& out)
 {
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
     auto exp = NumberTheory::ModularPower(in_integer, m_public_key.public_exponent(), m_public_key.modulus());
+    if (exp.is_invalid()) {
+        dbgln("invalid RSA key");
+        out = {};
+        return;
+    }
     auto size = exp.export_data(out);
     out = out.slice(out.size() - size, size);
 }
@@ -57,4 +57,39 @@ void BasicBlock::grow(size_t additional_size)
     m_buffer.resize(m_buffer.size() + additional_size);
 }
 
+void BasicBlock::remove_instructions_if(Function<bool(Instruction const&)> const& predicate)
+{
+    Vector<u8> new_buffer;
+    new_buffer.ensure_capacity(m_buffer.size());
+
+    Optional<size_t> last_kept_offset;
+    Bytecode::InstructionStreamIterator it(instruction_stream());
+    while (!it.at_end()) {
+        auto& instruction = const_cast<Instruction&>(*it);
+        ++it;
+        if (predicate(instruction)) {
+            Instruction::destroy(instruction);
+            continue;
+        }
+        last_kept_offset = new_buffer.size();
+        new_buffer.append(reinterpret_cast<u8 const*>(&instruction), instruction.length());
+    }
+
+    // NOTE: Every instruction has either been destroyed or relocated into the new buffer,
+    //       so the old storage can be released without running any destructors.
+    m_buffer = move(new_buffer);
+    m_terminated = last_kept_offset.has_value() && reinterpret_cast<Instruction const*>(m_buffer.data() + *last_kept_offset)->is_terminator();
+}
+
+void BasicBlock::append_instructions_from(BasicBlock& other)
+{
+    VERIFY(&other != this);
+    m_buffer.append(other.m_buffer.data(), other.m_buffer.size());
+    m_terminated = other.m_terminated;
+
+    // NOTE: The instructions now live in our buffer, so the other block must not destroy them.
+    other.m_buffer.clear();
+    other.m_terminated = false;
+}
+
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <AK/Function.h>
 #include <AK/String.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Handle.h>
@@ -35,6 +36,11 @@ public:
 
     void grow(size_t additional_size);
 
+    // NOTE: These are used by the optimization passes to reshape blocks after code generation.
+    //       Kept instructions are relocated bytewise, dropped ones are destroyed.
+    void remove_instructions_if(Function<bool(Instruction const&)> const&);
+    void append_instructions_from(BasicBlock&);
+
     void terminate(Badge<Generator>) { m_terminated = true; }
     bool is_terminated() const { return m_terminated; }
 
@@ -95,18 +95,23 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, DeprecatedFlyString const& pro
         return Value { base_obj->indexed_properties().array_like_size() };
     }
 
-    // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
+    // OPTIMIZATION: If we've seen this shape here before, we can use the cached property offset.
     auto& shape = base_obj->shape();
-    if (&shape == cache.shape) {
-        return base_obj->get_direct(cache.property_offset.value());
+    if (auto const* entry = cache.find(shape)) {
+        ++cache.hit_count;
+        return base_obj->get_direct(entry->property_offset.value());
     }
 
+    ++cache.miss_count;
+
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(property, this_value, &cacheable_metadata));
 
     if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
+        auto& entry = cache.entry_for_update(shape);
+        entry = {};
+        entry.shape = shape;
+        entry.property_offset = cacheable_metadata.property_offset.value();
     }
 
     return value;
@@ -225,6 +230,60 @@ inline ThrowCompletionOr<Value> get_global(Bytecode::Interpreter& interpreter, D
     return vm.throw_completion<ReferenceError>(ErrorType::UnknownIdentifier, identifier);
 }
 
+// A cached put transition may only stand in for [[Set]] as long as nothing along the prototype chain could have
+// intercepted the store. Shapes that aren't dictionaries never change in place, so comparing them is enough.
+inline bool can_use_cached_put_transition(Object const& object, PropertyLookupCache::Entry const& entry)
+{
+    auto const* prototype = object.shape().prototype();
+    for (auto const& prototype_shape : entry.prototype_shapes) {
+        if (!prototype)
+            return !prototype_shape;
+        if (!prototype_shape || &prototype->shape() != prototype_shape)
+            return false;
+        prototype = prototype_shape->prototype();
+    }
+    return !prototype;
+}
+
+// If the [[Set]] we just performed did nothing but add a plain data property to an ordinary object,
+// remember the shape transition so that the next object with the same shape can skip straight to it.
+inline void cache_put_transition_if_possible(PropertyLookupCache& cache, Object& object, Shape& shape_before_set, PropertyKey const& name)
+{
+    auto& shape_after_set = object.shape();
+    if (&shape_after_set == &shape_before_set || !name.is_string())
+        return;
+    if (shape_before_set.is_dictionary() || shape_after_set.is_dictionary() || !shape_before_set.is_cacheable())
+        return;
+    if (object.may_interfere_with_indexed_property_access() || shape_after_set.property_count() != shape_before_set.property_count() + 1)
+        return;
+
+    auto metadata = shape_after_set.lookup(name.to_string_or_symbol());
+    if (!metadata.has_value() || metadata->offset != shape_before_set.property_count() || metadata->attributes != default_attributes)
+        return;
+
+    AK::Array<WeakPtr<Shape>, PropertyLookupCache::max_prototype_chain_length> prototype_shapes;
+    auto* prototype = shape_before_set.prototype();
+    for (size_t i = 0; prototype; ++i) {
+        if (i == PropertyLookupCache::max_prototype_chain_length)
+            return;
+        auto& prototype_shape = prototype->shape();
+        if (prototype->may_interfere_with_indexed_property_access() || prototype_shape.is_dictionary())
+            return;
+        if (prototype_shape.lookup(name.to_string_or_symbol()).has_value())
+            return;
+        prototype_shapes[i] = prototype_shape;
+        prototype = prototype_shape.prototype();
+    }
+
+    auto& entry = cache.entry_for_update(shape_before_set);
+    entry = {};
+    entry.shape = shape_before_set;
+    entry.property_offset = metadata->offset;
+    entry.is_transition = true;
+    entry.transition_shape = shape_after_set;
+    entry.prototype_shapes = move(prototype_shapes);
+}
+
 inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value this_value, Value value, PropertyKey name, Op::PropertyKind kind, PropertyLookupCache* cache = nullptr)
 {
     // Better error message than to_object would give
@@ -253,17 +312,37 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        if (cache) {
+            if (auto* entry = cache->find(object->shape())) {
+                if (!entry->is_transition) {
+                    ++cache->hit_count;
+                    object->put_direct(*entry->property_offset, value);
+                    return {};
+                }
+                if (!entry->transition_shape) {
+                    // The shape we would transition to has been collected, so this entry is useless now.
+                    *entry = {};
+                } else if (this_value.is_object() && &this_value.as_object() == object && can_use_cached_put_transition(*object, *entry)
+                    && object->put_direct_with_cached_transition(*entry->transition_shape, value)) {
+                    ++cache->hit_count;
+                    return {};
+                }
+            }
+            ++cache->miss_count;
         }
 
+        auto& shape_before_set = object->shape();
+
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
         if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+            auto& entry = cache->entry_for_update(object->shape());
+            entry = {};
+            entry.shape = object->shape();
+            entry.property_offset = cacheable_metadata.property_offset.value();
+        } else if (succeeded && cache && this_value.is_object() && &this_value.as_object() == object) {
+            cache_put_transition_if_possible(*cache, *object, shape_before_set, name);
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -6,6 +6,8 @@
 
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
 #include <LibJS/Bytecode/RegexTable.h>
 #include <LibJS/JIT/Compiler.h>
 #include <LibJS/JIT/NativeExecutable.h>
@@ -39,7 +41,11 @@ Executable::Executable(
     environment_variable_caches.resize(number_of_environment_variable_caches);
 }
 
-Executable::~Executable() = default;
+Executable::~Executable()
+{
+    if (g_dump_property_lookup_cache_statistics)
+        dump_property_lookup_cache_statistics();
+}
 
 void Executable::dump() const
 {
@@ -56,6 +62,55 @@ void Executable::dump() const
     }
 }
 
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    bool printed_header = false;
+    auto dump_site = [&](BasicBlock const& block, size_t offset, StringView op_name, IdentifierTableIndex property, u32 cache_index) {
+        auto const& cache = property_lookup_caches[cache_index];
+        auto lookups = cache.hit_count + cache.miss_count;
+        if (lookups == 0)
+            return;
+
+        if (!printed_header) {
+            dbgln("\033[33;1mJS::Bytecode::PropertyLookupCache\033[0m ({})", name);
+            printed_header = true;
+        }
+
+        dbgln("    {}:[{:4x}] {:<16} {:<24} {:>8} hits, {:>8} misses ({}% hit rate), {:>8} megamorphic",
+            block.name(),
+            offset,
+            op_name,
+            get_identifier(property),
+            cache.hit_count,
+            cache.miss_count,
+            cache.hit_count * 100 / lookups,
+            cache.megamorphic_miss_count);
+    };
+
+    for (auto const& block : basic_blocks) {
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            auto const& instruction = *it;
+            switch (instruction.type()) {
+#define __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE(op)                                                               \
+    case Instruction::Type::op: {                                                                               \
+        auto const& typed_instruction = static_cast<Op::op const&>(instruction);                                \
+        dump_site(*block, it.offset(), #op##sv, typed_instruction.property(), typed_instruction.cache_index()); \
+        break;                                                                                                  \
+    }
+                __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE(GetById)
+                __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE(GetByIdWithThis)
+                __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE(PutById)
+                __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE(PutByIdWithThis)
+#undef __BYTECODE_DUMP_PROPERTY_LOOKUP_CACHE
+            default:
+                break;
+            }
+            ++it;
+        }
+    }
+}
+
 JIT::NativeExecutable const* Executable::get_or_create_native_executable()
 {
     if (!m_did_try_jitting) {
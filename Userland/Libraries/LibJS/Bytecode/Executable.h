@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -26,16 +27,67 @@ class NativeExecutable;
 namespace JS::Bytecode {
 
 struct PropertyLookupCache {
-    static FlatPtr shape_offset() { return OFFSET_OF(PropertyLookupCache, shape); }
-    static FlatPtr property_offset_offset() { return OFFSET_OF(PropertyLookupCache, property_offset); }
-
-    WeakPtr<Shape> shape;
-    Optional<u32> property_offset;
+    static constexpr size_t max_number_of_shapes = 4;
+    static constexpr size_t max_prototype_chain_length = 4;
+
+    struct Entry {
+        static FlatPtr shape_offset() { return OFFSET_OF(Entry, shape); }
+        static FlatPtr property_offset_offset() { return OFFSET_OF(Entry, property_offset); }
+        static FlatPtr is_transition_offset() { return OFFSET_OF(Entry, is_transition); }
+
+        WeakPtr<Shape> shape;
+        Optional<u32> property_offset;
+
+        // Only set for stores that add a new property: the shape an object of `shape` moves to when the property is added,
+        // and the shapes its prototype chain had at the time. The transition can only be reused while none of those changed.
+        // property_offset is then the offset of the property that will be added, so an entry with is_transition set must
+        // never be used for a plain store, even after transition_shape has been garbage collected.
+        bool is_transition { false };
+        WeakPtr<Shape> transition_shape;
+        AK::Array<WeakPtr<Shape>, max_prototype_chain_length> prototype_shapes;
+    };
+
+    static FlatPtr entries_offset() { return OFFSET_OF(PropertyLookupCache, entries); }
+    static FlatPtr hit_count_offset() { return OFFSET_OF(PropertyLookupCache, hit_count); }
+
+    Entry* find(Shape const& shape)
+    {
+        for (auto& entry : entries) {
+            if (entry.shape == &shape)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    // Returns the entry to (re)populate for the given shape, evicting the oldest one once the cache is full.
+    Entry& entry_for_update(Shape const& shape)
+    {
+        if (auto* entry = find(shape))
+            return *entry;
+        for (auto& entry : entries) {
+            if (!entry.shape)
+                return entry;
+        }
+        ++megamorphic_miss_count;
+        auto& entry = entries[next_entry_to_evict];
+        next_entry_to_evict = (next_entry_to_evict + 1) % max_number_of_shapes;
+        return entry;
+    }
+
+    AK::Array<Entry, max_number_of_shapes> entries;
+    u64 hit_count { 0 };
+    u64 miss_count { 0 };
+    u64 megamorphic_miss_count { 0 };
+    u8 next_entry_to_evict { 0 };
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+struct GlobalVariableCache {
+    static FlatPtr shape_offset() { return OFFSET_OF(GlobalVariableCache, shape); }
+    static FlatPtr property_offset_offset() { return OFFSET_OF(GlobalVariableCache, property_offset); }
     static FlatPtr environment_serial_number_offset() { return OFFSET_OF(GlobalVariableCache, environment_serial_number); }
 
+    WeakPtr<Shape> shape;
+    Optional<u32> property_offset;
     u64 environment_serial_number { 0 };
 };
 
@@ -82,11 +134,15 @@ public:
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
 
     JIT::NativeExecutable const* get_or_create_native_executable();
     JIT::NativeExecutable const* native_executable() const { return m_native_executable; }
 
 private:
+    // Executables don't keep any references to other cells.
+    virtual bool class_has_write_barriers() const override { return true; }
+
     OwnPtr<JIT::NativeExecutable> m_native_executable;
     bool m_did_try_jitting { false };
 };
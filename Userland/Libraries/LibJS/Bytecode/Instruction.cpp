@@ -26,6 +26,69 @@ void Instruction::destroy(Instruction& instruction)
 #undef __BYTECODE_OP
 }
 
+bool Instruction::is_terminator() const
+{
+#define __BYTECODE_OP(op) \
+    case Type::op:        \
+        return Op::op::IsTerminator;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+void Instruction::visit_labels(Function<void(Label&)> const& visitor)
+{
+#define __BYTECODE_OP(op)                                       \
+    case Type::op:                                              \
+        static_cast<Op::op&>(*this).visit_labels_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+void Instruction::visit_registers(Function<void(Register&)> const& visitor)
+{
+#define __BYTECODE_OP(op)                                          \
+    case Type::op:                                                 \
+        static_cast<Op::op&>(*this).visit_registers_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+void Instruction::visit_register_ranges(Function<void(Register, u32)> const& visitor) const
+{
+#define __BYTECODE_OP(op)                                                      \
+    case Type::op:                                                             \
+        static_cast<Op::op const&>(*this).visit_register_ranges_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 UnrealizedSourceRange InstructionStreamIterator::source_range() const
 {
     VERIFY(m_executable);
@@ -7,8 +7,10 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <AK/Span.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 #include <LibJS/SourceRange.h>
 
@@ -135,10 +137,21 @@ public:
 
     Type type() const { return m_type; }
     size_t length() const { return m_length; }
+    bool is_terminator() const;
     ByteString to_byte_string(Bytecode::Executable const&) const;
     ThrowCompletionOr<void> execute(Bytecode::Interpreter&) const;
     static void destroy(Instruction&);
 
+    // Calls the visitor for every basic block reference held by this instruction.
+    void visit_labels(Function<void(Label&)> const&);
+
+    // Calls the visitor for every register operand of this instruction.
+    void visit_registers(Function<void(Register&)> const&);
+
+    // Calls the visitor for every window of consecutive registers that this instruction addresses
+    // through its first register only (call arguments, array elements).
+    void visit_register_ranges(Function<void(Register first, u32 count)> const&) const;
+
     // FIXME: Find a better way to organize this information
     void set_source_record(SourceRecord rec) { m_source_record = rec; }
     SourceRecord source_record() const { return m_source_record; }
@@ -150,6 +163,10 @@ protected:
     {
     }
 
+    void visit_labels_impl(Function<void(Label&)> const&) { }
+    void visit_registers_impl(Function<void(Register&)> const&) { }
+    void visit_register_ranges_impl(Function<void(Register, u32)> const&) const { }
+
 private:
     SourceRecord m_source_record {};
     Type m_type {};
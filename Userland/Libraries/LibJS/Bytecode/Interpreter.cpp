@@ -15,6 +15,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
 #include <LibJS/JIT/Compiler.h>
 #include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -40,6 +41,9 @@
 namespace JS::Bytecode {
 
 bool g_dump_bytecode = false;
+bool g_dump_bytecode_after_passes = false;
+bool g_optimizations_enabled = true;
+bool g_dump_property_lookup_cache_statistics = false;
 
 NonnullOwnPtr<CallFrame> CallFrame::create(size_t register_count)
 {
@@ -132,6 +136,7 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
             if (g_dump_bytecode)
                 executable->dump();
+            optimize(vm, *executable);
 
             // a. Set result to the result of evaluating script.
             auto result_or_error = run_and_return_frame(*executable, nullptr);
@@ -475,10 +480,41 @@ ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM& vm, ASTNode co
 
     if (Bytecode::g_dump_bytecode)
         bytecode_executable->dump();
+    optimize(vm, *bytecode_executable);
 
     return bytecode_executable;
 }
 
+PassManager& Interpreter::optimization_pipeline()
+{
+    if (!m_optimization_pipeline) {
+        auto pm = make<PassManager>();
+        pm->add<Passes::ThreadJumps>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::EliminateUnreachableBlocks>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::MergeBlocks>();
+        pm->add<Passes::EliminateRedundantMoves>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AllocateRegisters>();
+        m_optimization_pipeline = move(pm);
+    }
+    return *m_optimization_pipeline;
+}
+
+void optimize(VM& vm, Executable& executable)
+{
+    if (g_optimizations_enabled) {
+        auto& passes = vm.bytecode_interpreter().optimization_pipeline();
+        passes.perform(executable);
+        if (g_dump_bytecode_after_passes)
+            passes.dump_statistics(executable);
+    }
+
+    if (g_dump_bytecode_after_passes)
+        executable.dump();
+}
+
 Realm& Interpreter::realm()
 {
     return *m_vm.current_realm();
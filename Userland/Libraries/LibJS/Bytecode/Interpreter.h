@@ -54,6 +54,9 @@ public:
     Realm& realm();
     VM& vm() { return m_vm; }
 
+    // Every Interpreter builds its own pipeline, so the passes and their statistics are never shared between VMs.
+    PassManager& optimization_pipeline();
+
     ThrowCompletionOr<Value> run(Script&, JS::GCPtr<Environment> lexical_environment_override = nullptr);
     ThrowCompletionOr<Value> run(SourceTextModule&);
 
@@ -116,6 +119,7 @@ private:
 
     VM& m_vm;
     Vector<Variant<NonnullOwnPtr<CallFrame>, CallFrame*>> m_call_frames;
+    OwnPtr<PassManager> m_optimization_pipeline;
     Span<Value> m_current_call_frame;
     BasicBlock const* m_scheduled_jump { nullptr };
     Executable* m_current_executable { nullptr };
@@ -124,7 +128,13 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_dump_bytecode_after_passes;
+extern bool g_optimizations_enabled;
+extern bool g_dump_property_lookup_cache_statistics;
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const& no, JS::FunctionKind kind, DeprecatedFlyString const& name);
 
+// Runs the optimization pipeline over a freshly generated executable (if enabled), and dumps the result if requested.
+void optimize(VM&, Executable&);
+
 }
@@ -40,6 +40,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_src);
+    }
 
     Register src() const { return m_src; }
 
@@ -74,6 +78,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_dst);
+    }
 
     Register dst() const { return m_dst; }
 
@@ -116,6 +124,10 @@ private:
                                                                             \
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const; \
         ByteString to_byte_string_impl(Bytecode::Executable const&) const;  \
+        void visit_registers_impl(Function<void(Register&)> const& visitor) \
+        {                                                                   \
+            visitor(m_lhs_reg);                                             \
+        }                                                                   \
                                                                             \
         Register lhs() const { return m_lhs_reg; }                          \
                                                                             \
@@ -237,6 +249,12 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_from_object);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            visitor(m_excluded_names[i]);
+    }
 
     size_t length_impl(size_t excluded_names_count) const
     {
@@ -289,6 +307,19 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        if (m_element_count == 0)
+            return;
+        visitor(m_elements[0]);
+        visitor(m_elements[1]);
+    }
+    void visit_register_ranges_impl(Function<void(Register, u32)> const& visitor) const
+    {
+        if (m_element_count == 0)
+            return;
+        visitor(m_elements[0], m_elements[1].index() - m_elements[0].index() + 1);
+    }
 
     size_t length_impl(size_t element_count) const
     {
@@ -342,6 +373,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_lhs);
+    }
 
     Register lhs() const { return m_lhs; }
     bool is_spread() const { return m_is_spread; }
@@ -362,6 +397,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_specifier);
+        visitor(m_options);
+    }
 
     Register specifier() const { return m_specifier; }
     Register options() const { return m_options; }
@@ -392,6 +432,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_lhs);
+    }
 
     Register lhs() const { return m_lhs; }
 
@@ -526,6 +570,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_callee_reg);
+        visitor(m_this_reg);
+    }
 
     IdentifierTableIndex identifier() const { return m_identifier; }
     u32 cache_index() const { return m_cache_index; }
@@ -645,6 +694,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_this_value);
+    }
 
     IdentifierTableIndex property() const { return m_property; }
     Register this_value() const { return m_this_value; }
@@ -712,6 +765,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+    }
 
     Register base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -739,6 +796,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+        visitor(m_this_value);
+    }
 
     Register base() const { return m_base; }
     Register this_value() const { return m_this_value; }
@@ -766,6 +828,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+    }
 
     Register base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -804,6 +870,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_this_value);
+    }
 
     Register this_value() const { return m_this_value; }
     IdentifierTableIndex property() const { return m_property; }
@@ -823,6 +893,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+    }
 
     Register base() const { return m_base; }
 
@@ -841,6 +915,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+        visitor(m_this_value);
+    }
 
     Register base() const { return m_base; }
     Register this_value() const { return m_this_value; }
@@ -862,6 +941,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+        visitor(m_property);
+    }
 
     Register base() const { return m_base; }
     Register property() const { return m_property; }
@@ -886,6 +970,12 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+        visitor(m_property);
+        visitor(m_this_value);
+    }
 
     Register base() const { return m_base; }
     Register property() const { return m_property; }
@@ -909,6 +999,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+    }
 
     Register base() const { return m_base; }
 
@@ -930,6 +1024,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_base);
+        visitor(m_this_value);
+    }
 
 private:
     Register m_base;
@@ -956,6 +1055,13 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        if (m_true_target.has_value())
+            visitor(*m_true_target);
+        if (m_false_target.has_value())
+            visitor(*m_false_target);
+    }
 
     auto& true_target() const { return m_true_target; }
     auto& false_target() const { return m_false_target; }
@@ -1030,6 +1136,16 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_callee);
+        visitor(m_this_value);
+        visitor(m_first_argument);
+    }
+    void visit_register_ranges_impl(Function<void(Register, u32)> const& visitor) const
+    {
+        visitor(m_first_argument, m_argument_count);
+    }
 
 private:
     Register m_callee;
@@ -1059,6 +1175,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_callee);
+        visitor(m_this_value);
+    }
 
 private:
     Register m_callee;
@@ -1116,6 +1237,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        if (m_home_object.has_value())
+            visitor(*m_home_object);
+    }
 
     FunctionExpression const& function_node() const { return m_function_node; }
     Optional<IdentifierTableIndex> const& lhs_name() const { return m_lhs_name; }
@@ -1237,6 +1363,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        visitor(m_entry_point);
+    }
 
     auto& entry_point() const { return m_entry_point; }
 
@@ -1267,6 +1397,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        visitor(m_target);
+    }
 
 private:
     Label m_target;
@@ -1306,6 +1440,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        visitor(m_resume_target);
+    }
 
     auto& resume_target() const { return m_resume_target; }
 
@@ -1330,6 +1468,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        if (m_continuation_label.has_value())
+            visitor(*m_continuation_label);
+    }
 
     auto& continuation() const { return m_continuation_label; }
 
@@ -1349,6 +1492,10 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_labels_impl(Function<void(Label&)> const& visitor)
+    {
+        visitor(m_continuation_label);
+    }
 
     auto& continuation() const { return m_continuation_label; }
 
@@ -1384,6 +1531,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_object);
+        visitor(m_iterator_record);
+    }
 
     Register object() const { return m_object; }
     Register iterator_record() const { return m_iterator_record; }
@@ -1404,6 +1556,11 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+    void visit_registers_impl(Function<void(Register&)> const& visitor)
+    {
+        visitor(m_next_method);
+        visitor(m_iterator_record);
+    }
 
     Register next_method() const { return m_next_method; }
     Register iterator_record() const { return m_iterator_record; }
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Registers that an instruction overwrites without looking at their previous value.
+// Every other register operand is treated as a read, which can only make liveness more conservative.
+static void for_each_defined_register(Instruction const& instruction, Function<void(Register)> const& callback)
+{
+    switch (instruction.type()) {
+    case Instruction::Type::Store:
+        callback(static_cast<Op::Store const&>(instruction).dst());
+        break;
+    case Instruction::Type::GetCalleeAndThisFromEnvironment: {
+        auto const& op = static_cast<Op::GetCalleeAndThisFromEnvironment const&>(instruction);
+        callback(op.callee());
+        callback(op.this_());
+        break;
+    }
+    case Instruction::Type::GetObjectFromIteratorRecord:
+        callback(static_cast<Op::GetObjectFromIteratorRecord const&>(instruction).object());
+        break;
+    case Instruction::Type::GetNextMethodFromIteratorRecord:
+        callback(static_cast<Op::GetNextMethodFromIteratorRecord const&>(instruction).next_method());
+        break;
+    default:
+        break;
+    }
+}
+
+struct BlockLiveness {
+    HashTable<u32> uses;
+    HashTable<u32> defs;
+    HashTable<u32> live_in;
+    HashTable<u32> live_out;
+    Vector<size_t> successors;
+    Vector<size_t> unwind_successors;
+    size_t first_position { 0 };
+    size_t last_position { 0 };
+};
+
+struct LiveInterval {
+    size_t start { NumericLimits<size_t>::max() };
+    size_t end { 0 };
+
+    bool is_empty() const { return start > end; }
+    void extend(size_t position)
+    {
+        start = min(start, position);
+        end = max(end, position);
+    }
+    void extend(LiveInterval const& other)
+    {
+        if (other.is_empty())
+            return;
+        extend(other.start);
+        extend(other.end);
+    }
+};
+
+// A run of consecutive virtual registers that has to stay consecutive, e.g. the argument window of a Call.
+struct AllocationUnit {
+    u32 first_register { 0 };
+    u32 count { 0 };
+    LiveInterval interval;
+};
+
+void AllocateRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+    auto register_count = executable.executable.number_of_registers;
+
+    if (register_count <= Register::reserved_register_count) {
+        finished();
+        return;
+    }
+
+    HashMap<BasicBlock const*, size_t> block_indices;
+    for (size_t i = 0; i < basic_blocks.size(); ++i)
+        block_indices.set(basic_blocks[i].ptr(), i);
+
+    Vector<BlockLiveness> blocks;
+    blocks.resize(basic_blocks.size());
+
+    // Union-find over virtual registers, used to glue register windows together.
+    Vector<u32> window_parent;
+    window_parent.resize(register_count);
+    for (u32 i = 0; i < register_count; ++i)
+        window_parent[i] = i;
+    auto find_window = [&](u32 index) {
+        while (window_parent[index] != index) {
+            window_parent[index] = window_parent[window_parent[index]];
+            index = window_parent[index];
+        }
+        return index;
+    };
+
+    Vector<size_t> scheduled_jump_targets;
+    Vector<size_t> blocks_continuing_unwind;
+
+    // Pass 1: Number every instruction, collect per-block uses and definitions and the explicit successors.
+    size_t position = 0;
+    for (size_t block_index = 0; block_index < basic_blocks.size(); ++block_index) {
+        auto& block = *basic_blocks[block_index];
+        auto& liveness = blocks[block_index];
+
+        // Every block gets an entry position of its own, so even empty blocks have a place in the linear order.
+        liveness.first_position = position++;
+
+        if (auto const* handler = block.handler())
+            liveness.unwind_successors.append(block_indices.get(handler).value());
+        if (auto const* finalizer = block.finalizer())
+            liveness.unwind_successors.append(block_indices.get(finalizer).value());
+
+        InstructionStreamIterator it(block.instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+
+            auto read_register = [&](u32 index) {
+                if (index < Register::reserved_register_count)
+                    return;
+                if (!liveness.defs.contains(index))
+                    liveness.uses.set(index);
+            };
+
+            HashTable<u32> defined_here;
+            for_each_defined_register(instruction, [&](Register reg) {
+                defined_here.set(reg.index());
+            });
+
+            instruction.visit_registers([&](Register& reg) {
+                if (!defined_here.contains(reg.index()))
+                    read_register(reg.index());
+            });
+
+            bool has_reserved_window = false;
+            instruction.visit_register_ranges([&](Register first, u32 count) {
+                if (count == 0)
+                    return;
+                if (first.index() < Register::reserved_register_count) {
+                    has_reserved_window = true;
+                    return;
+                }
+                for (u32 i = 0; i < count; ++i) {
+                    read_register(first.index() + i);
+                    if (i > 0)
+                        window_parent[find_window(first.index() + i)] = find_window(first.index());
+                }
+            });
+
+            // Windows are only ever carved out of temporaries; if that ever changes, leave the executable alone.
+            if (has_reserved_window) {
+                finished();
+                return;
+            }
+
+            for (auto index : defined_here) {
+                if (index >= Register::reserved_register_count)
+                    liveness.defs.set(index);
+            }
+
+            switch (instruction.type()) {
+            case Instruction::Type::ScheduleJump:
+                scheduled_jump_targets.append(block_indices.get(&static_cast<Op::ScheduleJump const&>(instruction).target().block()).value());
+                break;
+            case Instruction::Type::ContinuePendingUnwind:
+                blocks_continuing_unwind.append(block_index);
+                break;
+            default:
+                break;
+            }
+
+            instruction.visit_labels([&](Label& label) {
+                liveness.successors.append(block_indices.get(&label.block()).value());
+            });
+
+            ++position;
+        }
+
+        liveness.last_position = position - 1;
+    }
+
+    // A scheduled jump only reaches its target after the finalizer has run, so whatever is live at the target
+    // must survive the finalizer too.
+    for (auto block_index : blocks_continuing_unwind)
+        blocks[block_index].successors.extend(scheduled_jump_targets);
+
+    // Pass 2: Standard backwards liveness. Control can leave a block for its handler or finalizer from any
+    // instruction, so whatever those need is live on entry to the block regardless of what the block defines.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = blocks.size(); i > 0; --i) {
+            auto& liveness = blocks[i - 1];
+
+            for (auto successor : liveness.successors) {
+                for (auto index : blocks[successor].live_in) {
+                    if (liveness.live_out.set(index) == HashSetResult::InsertedNewEntry)
+                        changed = true;
+                }
+            }
+
+            for (auto successor : liveness.unwind_successors) {
+                for (auto index : blocks[successor].live_in) {
+                    if (liveness.live_out.set(index) == HashSetResult::InsertedNewEntry)
+                        changed = true;
+                    if (liveness.live_in.set(index) == HashSetResult::InsertedNewEntry)
+                        changed = true;
+                }
+            }
+
+            for (auto index : liveness.uses) {
+                if (liveness.live_in.set(index) == HashSetResult::InsertedNewEntry)
+                    changed = true;
+            }
+
+            for (auto index : liveness.live_out) {
+                if (liveness.defs.contains(index))
+                    continue;
+                if (liveness.live_in.set(index) == HashSetResult::InsertedNewEntry)
+                    changed = true;
+            }
+        }
+    }
+
+    // Pass 3: Turn liveness into one conservative interval per register over the linear instruction order.
+    Vector<LiveInterval> intervals;
+    intervals.resize(register_count);
+    position = 0;
+    for (size_t block_index = 0; block_index < basic_blocks.size(); ++block_index) {
+        auto& liveness = blocks[block_index];
+        for (auto index : liveness.live_in)
+            intervals[index].extend(liveness.first_position);
+        for (auto index : liveness.live_out)
+            intervals[index].extend(liveness.last_position);
+
+        position = liveness.first_position + 1;
+        InstructionStreamIterator it(basic_blocks[block_index]->instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            instruction.visit_registers([&](Register& reg) {
+                intervals[reg.index()].extend(position);
+            });
+            instruction.visit_register_ranges([&](Register first, u32 count) {
+                for (u32 i = 0; i < count; ++i)
+                    intervals[first.index() + i].extend(position);
+            });
+            ++position;
+        }
+    }
+
+    // Pass 4: Group registers into allocation units, ordered by where they become live.
+    Vector<AllocationUnit> units;
+    HashMap<u32, size_t> unit_for_window;
+    for (u32 index = Register::reserved_register_count; index < register_count; ++index) {
+        if (intervals[index].is_empty())
+            continue;
+
+        auto unit_index = unit_for_window.ensure(find_window(index), [&] {
+            units.append({ .first_register = index, .count = 0, .interval = {} });
+            return units.size() - 1;
+        });
+        auto& unit = units[unit_index];
+        // Window members are glued to their neighbours only, so each group is a consecutive run of registers.
+        VERIFY(unit.first_register + unit.count == index);
+        ++unit.count;
+        unit.interval.extend(intervals[index]);
+    }
+
+    quick_sort(units, [](auto const& a, auto const& b) {
+        if (a.interval.start != b.interval.start)
+            return a.interval.start < b.interval.start;
+        return a.first_register < b.first_register;
+    });
+
+    // Pass 5: Linear scan. A physical register is free once the last interval assigned to it has ended.
+    Vector<u32> mapping;
+    mapping.resize(register_count);
+    for (u32 i = 0; i < register_count; ++i)
+        mapping[i] = i;
+
+    Vector<Optional<size_t>> busy_until;
+    auto is_free = [&](size_t slot, size_t start) {
+        return slot >= busy_until.size() || !busy_until[slot].has_value() || busy_until[slot].value() < start;
+    };
+
+    for (auto const& unit : units) {
+        if (unit.interval.is_empty())
+            continue;
+
+        size_t slot = 0;
+        while (true) {
+            size_t free_run = 0;
+            while (free_run < unit.count && is_free(slot + free_run, unit.interval.start))
+                ++free_run;
+            if (free_run == unit.count)
+                break;
+            slot += free_run + 1;
+        }
+
+        if (busy_until.size() < slot + unit.count)
+            busy_until.resize(slot + unit.count);
+        for (u32 i = 0; i < unit.count; ++i) {
+            busy_until[slot + i] = unit.interval.end;
+            mapping[unit.first_register + i] = Register::reserved_register_count + slot + i;
+        }
+    }
+
+    auto new_register_count = Register::reserved_register_count + busy_until.size();
+    if (new_register_count >= register_count) {
+        finished();
+        return;
+    }
+
+    for (auto& block : basic_blocks) {
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            instruction.visit_registers([&](Register& reg) {
+                if (reg.index() >= Register::reserved_register_count)
+                    reg = Register(mapping[reg.index()]);
+            });
+        }
+    }
+
+    executable.executable.number_of_registers = new_register_count;
+
+    finished();
+}
+
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    // Collect every register that is referenced by something other than a plain store.
+    // A store into any other register can never be observed, as the reserved registers
+    // are the only ones touched implicitly by the interpreter.
+    HashTable<u32> observed_registers;
+    for (auto& block : executable.executable.basic_blocks) {
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            if (instruction.type() == Instruction::Type::Store)
+                continue;
+            instruction.visit_registers([&](Register& reg) {
+                observed_registers.set(reg.index());
+            });
+            instruction.visit_register_ranges([&](Register first, u32 count) {
+                for (u32 i = 0; i < count; ++i)
+                    observed_registers.set(first.index() + i);
+            });
+        }
+    }
+
+    for (auto& block : executable.executable.basic_blocks) {
+        block->remove_instructions_if([&](auto const& instruction) {
+            if (instruction.type() != Instruction::Type::Store)
+                return false;
+            auto index = static_cast<Op::Store const&>(instruction).dst().index();
+            return index >= Register::reserved_register_count && !observed_registers.contains(index);
+        });
+    }
+
+    finished();
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static bool is_accumulator_load(Instruction const& instruction)
+{
+    return instruction.type() == Instruction::Type::Load || instruction.type() == Instruction::Type::LoadImmediate;
+}
+
+static Optional<Register> stored_register(Instruction const& instruction)
+{
+    if (instruction.type() != Instruction::Type::Store)
+        return {};
+    return static_cast<Op::Store const&>(instruction).dst();
+}
+
+static Optional<Register> loaded_register(Instruction const& instruction)
+{
+    if (instruction.type() != Instruction::Type::Load)
+        return {};
+    return static_cast<Op::Load const&>(instruction).src();
+}
+
+// Finds moves between the accumulator and registers that don't change any observable state.
+// None of the instructions considered here can throw, so looking at adjacent pairs is enough.
+static HashTable<Instruction const*> find_redundant_moves(BasicBlock const& block)
+{
+    HashTable<Instruction const*> redundant_instructions;
+    Instruction const* previous = nullptr;
+
+    InstructionStreamIterator it(block.instruction_stream());
+    while (!it.at_end()) {
+        auto const& instruction = *it;
+        ++it;
+
+        // Load acc / Store acc
+        if (loaded_register(instruction) == Register::accumulator() || stored_register(instruction) == Register::accumulator()) {
+            redundant_instructions.set(&instruction);
+            continue;
+        }
+
+        if (previous) {
+            // Store $x, Load $x: The accumulator already holds the value of $x.
+            if (auto reg = loaded_register(instruction); reg.has_value() && stored_register(*previous) == reg) {
+                redundant_instructions.set(&instruction);
+                continue;
+            }
+
+            // Load $x, Store $x: $x already holds the value of the accumulator.
+            if (auto reg = stored_register(instruction); reg.has_value() && loaded_register(*previous) == reg) {
+                redundant_instructions.set(&instruction);
+                continue;
+            }
+
+            // Load $x, Load $y: The first load is overwritten before anyone can observe it.
+            if (is_accumulator_load(*previous) && is_accumulator_load(instruction))
+                redundant_instructions.set(previous);
+
+            // Store $x, Store $x: Same for the first store.
+            if (auto reg = stored_register(instruction); reg.has_value() && stored_register(*previous) == reg)
+                redundant_instructions.set(previous);
+        }
+
+        previous = &instruction;
+    }
+
+    return redundant_instructions;
+}
+
+void EliminateRedundantMoves::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks) {
+        // Removing a move can make its neighbours adjacent, which may expose more redundant moves.
+        for (;;) {
+            auto redundant_instructions = find_redundant_moves(*block);
+            if (redundant_instructions.is_empty())
+                break;
+            block->remove_instructions_if([&](auto const& instruction) {
+                return redundant_instructions.contains(&instruction);
+            });
+        }
+    }
+
+    finished();
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateUnreachableBlocks::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.cfg.has_value());
+
+    auto& blocks = executable.executable.basic_blocks;
+    if (blocks.is_empty()) {
+        finished();
+        return;
+    }
+
+    HashTable<BasicBlock const*> reachable_blocks;
+    Vector<BasicBlock const*> worklist;
+    worklist.append(blocks.first().ptr());
+    reachable_blocks.set(blocks.first().ptr());
+
+    while (!worklist.is_empty()) {
+        auto const* block = worklist.take_last();
+        auto successors = executable.cfg->get(block);
+        if (!successors.has_value())
+            continue;
+        for (auto const* successor : *successors) {
+            if (reachable_blocks.contains(successor))
+                continue;
+            reachable_blocks.set(successor);
+            worklist.append(successor);
+        }
+    }
+
+    auto removed_any = blocks.remove_all_matching([&](auto& block) {
+        return !reachable_blocks.contains(block.ptr());
+    });
+
+    // The CFG refers to the removed blocks, so it has to be regenerated before the next pass can use it.
+    if (removed_any) {
+        executable.cfg.clear();
+        executable.inverted_cfg.clear();
+        executable.exported_blocks.clear();
+    }
+
+    finished();
+}
+
+}
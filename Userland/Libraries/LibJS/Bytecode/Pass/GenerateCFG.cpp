@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static bool is_jump(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+    case Instruction::Type::Jump:
+    case Instruction::Type::JumpConditional:
+    case Instruction::Type::JumpNullish:
+    case Instruction::Type::JumpUndefined:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void GenerateCFG::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    executable.cfg = HashMap<BasicBlock const*, HashTable<BasicBlock const*>> {};
+    executable.inverted_cfg = HashMap<BasicBlock const*, HashTable<BasicBlock const*>> {};
+    executable.exported_blocks = HashTable<BasicBlock const*> {};
+
+    for (auto& block : executable.executable.basic_blocks)
+        executable.inverted_cfg->set(block.ptr(), {});
+
+    for (auto& block : executable.executable.basic_blocks) {
+        auto& successors = executable.cfg->ensure(block.ptr());
+
+        // NOTE: Exported blocks are reachable through something other than a plain jump
+        //       (exception handlers, finalizers, generator continuations, scheduled jumps),
+        //       so their identity has to be preserved by the passes that reshape blocks.
+        auto add_edge = [&](BasicBlock const& target, bool exported) {
+            successors.set(&target);
+            executable.inverted_cfg->ensure(&target).set(block.ptr());
+            if (exported)
+                executable.exported_blocks->set(&target);
+        };
+
+        if (auto const* handler = block->handler())
+            add_edge(*handler, true);
+        if (auto const* finalizer = block->finalizer())
+            add_edge(*finalizer, true);
+
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            auto exported = !is_jump(instruction);
+            instruction.visit_labels([&](Label& label) {
+                add_edge(label.block(), exported);
+            });
+            ++it;
+        }
+    }
+
+    finished();
+}
+
+}
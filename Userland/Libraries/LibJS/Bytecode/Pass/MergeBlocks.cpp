@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static Op::Jump const* unconditional_jump_terminator(BasicBlock const& block)
+{
+    Instruction const* last_instruction = nullptr;
+    InstructionStreamIterator it(block.instruction_stream());
+    while (!it.at_end()) {
+        last_instruction = &*it;
+        ++it;
+    }
+
+    if (!last_instruction || last_instruction->type() != Instruction::Type::Jump)
+        return nullptr;
+
+    auto const& jump = static_cast<Op::Jump const&>(*last_instruction);
+    if (jump.false_target().has_value())
+        return nullptr;
+    return &jump;
+}
+
+void MergeBlocks::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.cfg.has_value());
+    VERIFY(executable.inverted_cfg.has_value());
+    VERIFY(executable.exported_blocks.has_value());
+
+    auto& blocks = executable.executable.basic_blocks;
+    if (blocks.is_empty()) {
+        finished();
+        return;
+    }
+
+    auto const* entry_block = blocks.first().ptr();
+    HashTable<BasicBlock const*> merged_blocks;
+
+    for (auto& block : blocks) {
+        if (merged_blocks.contains(block.ptr()))
+            continue;
+
+        // Keep pulling successors into this block for as long as the chain allows it.
+        for (;;) {
+            auto const* jump = unconditional_jump_terminator(*block);
+            if (!jump)
+                break;
+
+            auto& successor = const_cast<BasicBlock&>(jump->true_target()->block());
+            if (&successor == block.ptr() || &successor == entry_block)
+                break;
+            if (executable.exported_blocks->contains(&successor))
+                break;
+            if (executable.inverted_cfg->get(&successor)->size() != 1)
+                break;
+            if (successor.handler() != block->handler() || successor.finalizer() != block->finalizer())
+                break;
+
+            block->remove_instructions_if([&](auto const& instruction) {
+                return &instruction == jump;
+            });
+            block->append_instructions_from(successor);
+            merged_blocks.set(&successor);
+
+            // The successor's outgoing edges now belong to this block.
+            auto successors_of_successor = executable.cfg->take(&successor).release_value();
+            for (auto const* next : successors_of_successor) {
+                auto& predecessors = executable.inverted_cfg->ensure(next);
+                predecessors.remove(&successor);
+                predecessors.set(block.ptr());
+            }
+            executable.cfg->set(block.ptr(), move(successors_of_successor));
+            executable.inverted_cfg->remove(&successor);
+        }
+    }
+
+    blocks.remove_all_matching([&](auto& block) {
+        return merged_blocks.contains(block.ptr());
+    });
+
+    finished();
+}
+
+}
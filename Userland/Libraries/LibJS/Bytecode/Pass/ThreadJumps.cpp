@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// A block that consists of nothing but an unconditional jump can be skipped over by anyone jumping into it.
+static BasicBlock const* trampoline_target(BasicBlock const& block)
+{
+    InstructionStreamIterator it(block.instruction_stream());
+    if (it.at_end())
+        return nullptr;
+
+    auto const& instruction = *it;
+    if (instruction.type() != Instruction::Type::Jump)
+        return nullptr;
+
+    auto const& jump = static_cast<Op::Jump const&>(instruction);
+    if (jump.false_target().has_value())
+        return nullptr;
+
+    ++it;
+    if (!it.at_end())
+        return nullptr;
+
+    return &jump.true_target()->block();
+}
+
+void ThreadJumps::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    static_assert(sizeof(Op::Jump) == sizeof(Op::JumpConditional));
+    static_assert(sizeof(Op::Jump) == sizeof(Op::JumpNullish));
+    static_assert(sizeof(Op::Jump) == sizeof(Op::JumpUndefined));
+
+    auto block_count = executable.executable.basic_blocks.size();
+    bool changed = false;
+
+    for (auto& block : executable.executable.basic_blocks) {
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+
+            switch (instruction.type()) {
+            case Instruction::Type::Jump:
+            case Instruction::Type::JumpConditional:
+            case Instruction::Type::JumpNullish:
+            case Instruction::Type::JumpUndefined:
+                break;
+            default:
+                continue;
+            }
+
+            instruction.visit_labels([&](Label& label) {
+                auto const* target = &label.block();
+                // NOTE: The step limit guards against chains of trampolines that loop back onto themselves.
+                for (size_t steps = 0; steps < block_count; ++steps) {
+                    auto const* next = trampoline_target(*target);
+                    if (!next || next == target)
+                        break;
+                    target = next;
+                }
+                if (target != &label.block()) {
+                    label = Label { *target };
+                    changed = true;
+                }
+            });
+
+            // A conditional jump whose both arms lead to the same place doesn't need to test anything.
+            auto& jump = static_cast<Op::Jump&>(instruction);
+            if (jump.false_target().has_value() && &jump.true_target()->block() == &jump.false_target()->block()) {
+                auto target = *jump.true_target();
+                auto source_record = jump.source_record();
+                Instruction::destroy(jump);
+                auto* replacement = new (&jump) Op::Jump(target);
+                replacement->set_source_record(source_record);
+                changed = true;
+            }
+        }
+    }
+
+    // Redirected jumps change the shape of the CFG.
+    if (changed) {
+        executable.cfg.clear();
+        executable.inverted_cfg.clear();
+        executable.exported_blocks.clear();
+    }
+
+    finished();
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode {
+
+static size_t count_instructions(Executable const& executable)
+{
+    size_t count = 0;
+    for (auto const& block : executable.basic_blocks) {
+        InstructionStreamIterator it(block->instruction_stream());
+        while (!it.at_end()) {
+            ++count;
+            ++it;
+        }
+    }
+    return count;
+}
+
+void PassManager::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    m_statistics.clear_with_capacity();
+    for (auto& pass : m_passes) {
+        PassStatistics statistics {
+            .name = pass->name(),
+            .instructions_before = count_instructions(executable.executable),
+            .blocks_before = executable.executable.basic_blocks.size(),
+            .registers_before = executable.executable.number_of_registers,
+        };
+
+        pass->perform(executable);
+
+        statistics.instructions_after = count_instructions(executable.executable);
+        statistics.blocks_after = executable.executable.basic_blocks.size();
+        statistics.registers_after = executable.executable.number_of_registers;
+        statistics.elapsed_microseconds = pass->elapsed();
+        m_statistics.append(statistics);
+    }
+
+    finished();
+}
+
+void PassManager::dump_statistics(Executable const& executable) const
+{
+    dbgln("\033[33;1mJS::Bytecode::PassManager\033[0m ({}) took {}us", executable.name, elapsed());
+    for (auto const& statistics : m_statistics) {
+        dbgln("    {:<28} {:>6} -> {:<6} instructions, {:>4} -> {:<4} blocks, {:>4} -> {:<4} registers, {}us",
+            statistics.name,
+            statistics.instructions_before,
+            statistics.instructions_after,
+            statistics.blocks_before,
+            statistics.blocks_after,
+            statistics.registers_before,
+            statistics.registers_after,
+            statistics.elapsed_microseconds);
+    }
+}
+
+}
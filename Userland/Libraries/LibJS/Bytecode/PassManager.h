@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
+
+namespace JS::Bytecode {
+
+struct PassPipelineExecutable {
+    Executable& executable;
+    Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> cfg {};
+    Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> inverted_cfg {};
+    Optional<HashTable<BasicBlock const*>> exported_blocks {};
+};
+
+class Pass {
+public:
+    Pass() = default;
+    virtual ~Pass() = default;
+
+    virtual StringView name() const = 0;
+    virtual void perform(PassPipelineExecutable&) = 0;
+
+    void started()
+    {
+        m_timer.start();
+    }
+    void finished()
+    {
+        m_time_difference = m_timer.elapsed_time();
+    }
+
+    u64 elapsed() const { return m_time_difference.to_microseconds(); }
+
+protected:
+    Core::ElapsedTimer m_timer;
+    Duration m_time_difference {};
+};
+
+class PassManager : public Pass {
+public:
+    struct PassStatistics {
+        StringView name;
+        size_t instructions_before { 0 };
+        size_t instructions_after { 0 };
+        size_t blocks_before { 0 };
+        size_t blocks_after { 0 };
+        size_t registers_before { 0 };
+        size_t registers_after { 0 };
+        u64 elapsed_microseconds { 0 };
+    };
+
+    PassManager() = default;
+    ~PassManager() override = default;
+
+    void add(NonnullOwnPtr<Pass> pass) { m_passes.append(move(pass)); }
+
+    template<typename PassT, typename... Args>
+    void add(Args&&... args) { m_passes.append(make<PassT>(forward<Args>(args)...)); }
+
+    virtual StringView name() const override { return "PassManager"sv; }
+
+    void perform(Executable& executable)
+    {
+        PassPipelineExecutable pipeline_executable { executable };
+        perform(pipeline_executable);
+    }
+
+    virtual void perform(PassPipelineExecutable& executable) override;
+
+    Vector<PassStatistics> const& statistics() const { return m_statistics; }
+    void dump_statistics(Executable const&) const;
+
+private:
+    Vector<NonnullOwnPtr<Pass>> m_passes;
+    Vector<PassStatistics> m_statistics;
+};
+
+namespace Passes {
+
+class GenerateCFG final : public Pass {
+public:
+    GenerateCFG() = default;
+    ~GenerateCFG() override = default;
+
+private:
+    virtual StringView name() const override { return "GenerateCFG"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class EliminateUnreachableBlocks final : public Pass {
+public:
+    EliminateUnreachableBlocks() = default;
+    ~EliminateUnreachableBlocks() override = default;
+
+private:
+    virtual StringView name() const override { return "EliminateUnreachableBlocks"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class ThreadJumps final : public Pass {
+public:
+    ThreadJumps() = default;
+    ~ThreadJumps() override = default;
+
+private:
+    virtual StringView name() const override { return "ThreadJumps"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class MergeBlocks final : public Pass {
+public:
+    MergeBlocks() = default;
+    ~MergeBlocks() override = default;
+
+private:
+    virtual StringView name() const override { return "MergeBlocks"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class EliminateRedundantMoves final : public Pass {
+public:
+    EliminateRedundantMoves() = default;
+    ~EliminateRedundantMoves() override = default;
+
+private:
+    virtual StringView name() const override { return "EliminateRedundantMoves"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class EliminateDeadStores final : public Pass {
+public:
+    EliminateDeadStores() = default;
+    ~EliminateDeadStores() override = default;
+
+private:
+    virtual StringView name() const override { return "EliminateDeadStores"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class AllocateRegisters final : public Pass {
+public:
+    AllocateRegisters() = default;
+    ~AllocateRegisters() override = default;
+
+private:
+    virtual StringView name() const override { return "AllocateRegisters"sv; }
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+}
+
+}
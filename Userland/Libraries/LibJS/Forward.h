@@ -311,6 +311,8 @@ class Executable;
 class Generator;
 class Instruction;
 class Interpreter;
+class Label;
+class PassManager;
 class RegexTable;
 class Register;
 }
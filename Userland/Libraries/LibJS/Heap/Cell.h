@@ -34,12 +34,28 @@ public:
     virtual void initialize(Realm&);
     virtual ~Cell() = default;
 
-    bool is_marked() const { return m_mark; }
-    void set_marked(bool b) { m_mark = b; }
+    // Mark bits live in a bitmap in the cell's HeapBlock, see HeapBlock.h.
+    bool is_marked() const;
+    void set_marked(bool);
 
-    enum class State : bool {
+    // Cells that survive a garbage collection are promoted to the old generation.
+    // Young generation collections neither trace through nor sweep old cells.
+    bool is_old() const { return m_old; }
+    void set_old(bool b) { m_old = b; }
+
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(bool b) { m_remembered = b; }
+
+    // Cached from class_has_write_barriers() when the cell is allocated.
+    bool has_write_barriers() const { return m_has_write_barriers; }
+    void set_has_write_barriers(Badge<Heap>, bool b) { m_has_write_barriers = b; }
+
+    enum class State : u8 {
         Live,
+        // Unreachable since the last collection, but not destroyed until its HeapBlock is swept.
         Dead,
+        // Destroyed and on its HeapBlock's freelist.
+        Free,
     };
 
     State state() const { return m_state; }
@@ -101,18 +117,43 @@ public:
 
     bool overrides_must_survive_garbage_collection(Badge<Heap>) const { return m_overrides_must_survive_garbage_collection; }
 
+    // Stores through the assignment operators of GCPtr and NonnullGCPtr members reach the write barrier on their own.
+    // Classes that return true here promise to call write_barrier() after storing any other reference that visit_edges()
+    // reports, like a Value member, an element of a Vector or the contents of an Optional or Variant. Subclasses inherit
+    // the promise.
+    // Cells of all other classes are never promoted to the old generation, so young generation collections trace them
+    // whenever they're reachable, and incremental marking leaves tracing them to its final pause.
+    virtual bool class_has_write_barriers() const { return false; }
+
+    // Cells that return true here are destroyed whenever their HeapBlock is next swept, instead of during the collection
+    // that found them dead. Their destructors must not have any observable effect, like revoking weak pointers.
+    // Every class opts in on its own after its destructor has been checked, so overrides in classes that are not final
+    // compare class_name() to make sure the opt-in is not inherited by subclasses.
+    virtual bool may_be_destroyed_lazily() const { return false; }
+
     ALWAYS_INLINE Heap& heap() const { return HeapBlockBase::from_cell(this)->heap(); }
     ALWAYS_INLINE VM& vm() const { return bit_cast<HeapBase*>(&heap())->vm(); }
 
+    // Must be called after storing a reference into this cell that the GCPtr write barrier can't see, like a Value.
+    ALWAYS_INLINE void write_barrier()
+    {
+        if (!m_remembered && m_has_write_barriers && (m_old || (is_marked() && bit_cast<HeapBase*>(&heap())->is_marking_incrementally()))) [[unlikely]]
+            remember();
+    }
+
 protected:
     Cell() = default;
 
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
-    bool m_mark : 1 { false };
+    void remember();
+
     bool m_overrides_must_survive_garbage_collection : 1 { false };
-    State m_state : 1 { State::Live };
+    State m_state : 2 { State::Live };
+    bool m_old : 1 { false };
+    bool m_remembered : 1 { false };
+    bool m_has_write_barriers : 1 { false };
 };
 
 }
@@ -23,6 +23,9 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     if (!m_list_node.is_in_list())
         heap.register_cell_allocator({}, *this);
 
+    while (m_usable_blocks.is_empty() && !m_unswept_blocks.is_empty())
+        sweep_block(*m_unswept_blocks.first());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, *this, m_cell_size, m_class_name);
         m_usable_blocks.append(*block.leak_ptr());
@@ -31,6 +34,8 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     auto& block = *m_usable_blocks.last();
     auto* cell = block.allocate();
     VERIFY(cell);
+    if (!block.has_young_cells())
+        heap.did_allocate_first_young_cell_in_block({}, block);
     if (block.is_full())
         m_full_blocks.append(*m_usable_blocks.last());
     return cell;
@@ -38,10 +43,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
 
 void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
 {
-    block.m_list_node.remove();
-    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
-    block.~HeapBlock();
-    m_block_allocator.deallocate_block(&block);
+    destroy_block(block);
 }
 
 void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
@@ -50,4 +52,38 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::block_did_get_dead_cells(Badge<Heap>, HeapBlock& block)
+{
+    if (block.needs_sweep())
+        return;
+    block.set_needs_sweep(true);
+    m_unswept_blocks.append(block);
+}
+
+void CellAllocator::sweep_all_blocks(Badge<Heap>)
+{
+    while (!m_unswept_blocks.is_empty())
+        sweep_block(*m_unswept_blocks.first());
+}
+
+void CellAllocator::sweep_block(HeapBlock& block)
+{
+    VERIFY(block.needs_sweep());
+    // NOTE: The block stays in m_unswept_blocks until destroy_block() or append() below unlinks it.
+    if (!block.sweep()) {
+        destroy_block(block);
+        return;
+    }
+    // Sweeping freed at least one cell, so the block can't be full.
+    m_usable_blocks.append(block);
+}
+
+void CellAllocator::destroy_block(HeapBlock& block)
+{
+    block.m_list_node.remove();
+    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
+    block.~HeapBlock();
+    m_block_allocator.deallocate_block(&block);
+}
+
 }
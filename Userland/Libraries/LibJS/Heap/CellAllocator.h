@@ -41,11 +41,19 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_unswept_blocks) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    void block_did_get_dead_cells(Badge<Heap>, HeapBlock&);
+
+    void sweep_all_blocks(Badge<Heap>);
+    size_t unswept_block_count() const { return m_unswept_blocks.size_slow(); }
 
     IntrusiveListNode<CellAllocator> m_list_node;
     using List = IntrusiveList<&CellAllocator::m_list_node>;
@@ -53,6 +61,9 @@ public:
     BlockAllocator& block_allocator() { return m_block_allocator; }
 
 private:
+    void sweep_block(HeapBlock&);
+    void destroy_block(HeapBlock&);
+
     char const* const m_class_name { nullptr };
     size_t const m_cell_size;
 
@@ -61,6 +72,9 @@ private:
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+
+    // Blocks with dead cells that haven't been destroyed yet. They are swept when we run out of usable blocks.
+    BlockList m_unswept_blocks;
 };
 
 template<typename T>
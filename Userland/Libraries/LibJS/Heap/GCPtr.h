@@ -8,6 +8,7 @@
 
 #include <AK/Traits.h>
 #include <AK/Types.h>
+#include <LibJS/Heap/Internals.h>
 
 namespace JS {
 
@@ -38,17 +39,28 @@ public:
     {
     }
 
+    NonnullGCPtr(NonnullGCPtr const&) = default;
+
+    NonnullGCPtr& operator=(NonnullGCPtr const& other)
+    {
+        m_ptr = other.m_ptr;
+        write_barrier(this, m_ptr);
+        return *this;
+    }
+
     template<typename U>
     NonnullGCPtr& operator=(NonnullGCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = static_cast<T*>(other.ptr());
+        write_barrier(this, m_ptr);
         return *this;
     }
 
     NonnullGCPtr& operator=(T& other)
     {
         m_ptr = &other;
+        write_barrier(this, m_ptr);
         return *this;
     }
 
@@ -57,6 +69,7 @@ public:
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = &static_cast<T&>(other);
+        write_barrier(this, m_ptr);
         return *this;
     }
 
@@ -113,17 +126,28 @@ public:
     {
     }
 
+    GCPtr(GCPtr const&) = default;
+
+    GCPtr& operator=(GCPtr const& other)
+    {
+        m_ptr = other.m_ptr;
+        write_barrier(this, m_ptr);
+        return *this;
+    }
+
     template<typename U>
     GCPtr& operator=(GCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = static_cast<T*>(other.ptr());
+        write_barrier(this, m_ptr);
         return *this;
     }
 
     GCPtr& operator=(NonnullGCPtr<T> const& other)
     {
         m_ptr = other.ptr();
+        write_barrier(this, m_ptr);
         return *this;
     }
 
@@ -132,12 +156,14 @@ public:
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = static_cast<T*>(other.ptr());
+        write_barrier(this, m_ptr);
         return *this;
     }
 
     GCPtr& operator=(T& other)
     {
         m_ptr = &other;
+        write_barrier(this, m_ptr);
         return *this;
     }
 
@@ -146,12 +172,14 @@ public:
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = &static_cast<T&>(other);
+        write_barrier(this, m_ptr);
         return *this;
     }
 
     GCPtr& operator=(T* other)
     {
         m_ptr = other;
+        write_barrier(this, m_ptr);
         return *this;
     }
 
@@ -160,6 +188,7 @@ public:
     requires(IsConvertible<U*, T*>)
     {
         m_ptr = static_cast<T*>(other);
+        write_barrier(this, m_ptr);
         return *this;
     }
 
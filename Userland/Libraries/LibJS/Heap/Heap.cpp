@@ -74,15 +74,24 @@ void Heap::will_allocate(size_t size)
 {
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(collection_type_for_allocation());
     } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(collection_type_for_allocation());
     }
 
     m_allocated_bytes_since_last_gc += size;
 }
 
+Heap::CollectionType Heap::collection_type_for_allocation() const
+{
+    // Most cells die young, so allocation pressure is normally relieved by a young generation collection.
+    // Old cells are only reclaimed by full collections, which we run whenever the old generation has doubled.
+    if (m_statistics.old_generation_bytes > m_old_generation_bytes_threshold)
+        return CollectionType::CollectGarbage;
+    return CollectionType::CollectYoungGeneration;
+}
+
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
 {
     if constexpr (sizeof(FlatPtr*) == sizeof(Value)) {
@@ -273,21 +282,32 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    Core::ElapsedTimer collection_measurement_timer(true);
+    collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
+    if (collection_type != CollectionType::CollectEverything) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
+            if (collection_type == CollectionType::CollectGarbage)
+                m_collection_type_when_deferral_ends = CollectionType::CollectGarbage;
             return;
         }
-        HashMap<Cell*, HeapRoot> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
+        if (is_marking_incrementally()) {
+            // A young generation collection would sweep with the mark bits of a full collection, so finish the full one instead.
+            collection_type = CollectionType::CollectGarbage;
+            finish_incremental_marking();
+        } else {
+            HashMap<Cell*, HeapRoot> roots;
+            gather_roots(roots);
+            mark_live_cells(roots, collection_type);
+        }
+    } else if (is_marking_incrementally()) {
+        abort_incremental_marking();
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    forget_remembered_cells();
+    finalize_unmarked_cells(collection_type);
+    sweep_dead_cells(collection_type, print_report, collection_measurement_timer);
+    remember_cells_referencing_young_cells();
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -387,28 +407,75 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    enum class IsIncremental {
+        No,
+        Yes,
+    };
+
+    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots, Heap::CollectionType collection_type, IsIncremental is_incremental = IsIncremental::No)
         : m_heap(heap)
+        , m_only_young_cells(collection_type == Heap::CollectionType::CollectYoungGeneration)
+        , m_defers_cells_without_write_barriers(is_incremental == IsIncremental::Yes)
+    {
+        update_live_heap_blocks();
+        visit_roots(roots);
+    }
+
+    // Blocks are only ever freed by sweeping, but incremental marking lets the mutator allocate new ones between marking steps.
+    void update_live_heap_blocks()
     {
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
+        m_all_live_heap_blocks.clear();
         m_heap.for_each_block([&](auto& block) {
             m_all_live_heap_blocks.set(&block);
             return IterationDecision::Continue;
         });
+    }
 
+    void visit_roots(HashMap<Cell*, HeapRoot> const& roots)
+    {
         for (auto* root : roots.keys()) {
             visit(root);
         }
     }
 
+    // Traces the references of a cell that is already marked.
+    void visit_edges_of(Cell& cell)
+    {
+        m_current_cell = &cell;
+        cell.visit_edges(*this);
+        m_current_cell = nullptr;
+    }
+
     virtual void visit_impl(Cell& cell) override
+    {
+        note_reference_to(cell);
+        if (m_only_young_cells && cell.is_old())
+            return;
+        mark(cell);
+    }
+
+    // Cells without write barriers can change between incremental marking steps without anyone noticing,
+    // so while they're deferred, they are only marked, and traced once the mutator can't get in between anymore.
+    void mark(Cell& cell)
     {
         if (cell.is_marked())
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
-        m_work_queue.append(cell);
+        if (m_defers_cells_without_write_barriers && !cell.has_write_barriers())
+            m_deferred_cells.append(cell);
+        else
+            m_work_queue.append(cell);
+    }
+
+    void stop_deferring_cells_without_write_barriers()
+    {
+        m_defers_cells_without_write_barriers = false;
+        for (auto& cell : m_deferred_cells)
+            m_work_queue.append(cell);
+        m_deferred_cells.clear();
     }
 
     virtual void visit_possible_values(ReadonlyBytes bytes) override
@@ -420,44 +487,202 @@ public:
             add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
 
         for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
-            if (cell->is_marked())
-                return;
             if (cell->state() != Cell::State::Live)
                 return;
-            cell->set_marked(true);
-            m_work_queue.append(*cell);
+            note_reference_to(*cell);
+            if (m_only_young_cells && cell->is_old())
+                return;
+            mark(*cell);
         });
     }
 
     void mark_all_live_cells()
     {
         while (!m_work_queue.is_empty()) {
-            m_work_queue.take_last().visit_edges(*this);
+            visit_edges_of(m_work_queue.take_last());
+        }
+    }
+
+    // Returns whether the work queue ran dry before the budget was used up.
+    bool mark_live_cells_until_budget_is_spent(Core::ElapsedTimer const& timer, Duration budget)
+    {
+        // Reading the clock is not free, so only check it every so often.
+        static constexpr size_t cells_between_budget_checks = 256;
+        size_t visited_cells = 0;
+        while (!m_work_queue.is_empty()) {
+            visit_edges_of(m_work_queue.take_last());
+            if (++visited_cells % cells_between_budget_checks == 0 && timer.elapsed_time() >= budget)
+                return m_work_queue.is_empty();
         }
+        return true;
     }
 
 private:
+    void note_reference_to(Cell const& cell)
+    {
+        // Cells without write barriers stay young, so whoever points at them has to stay in the remembered set once promoted.
+        if (!m_current_cell || cell.has_write_barriers() || !m_current_cell->has_write_barriers())
+            return;
+        if (m_heap.m_cells_referencing_young_cells.is_empty() || m_heap.m_cells_referencing_young_cells.last() != m_current_cell)
+            m_heap.m_cells_referencing_young_cells.append(m_current_cell);
+    }
+
     Heap& m_heap;
+    bool m_only_young_cells { false };
+    bool m_defers_cells_without_write_barriers { false };
+    Cell* m_current_cell { nullptr };
     Vector<Cell&> m_work_queue;
+    Vector<Cell&> m_deferred_cells;
     HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
     FlatPtr m_max_block_address;
 };
 
-void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
+void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots, CollectionType collection_type)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    MarkingVisitor visitor(*this, roots, collection_type);
+
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        // Old cells are not traced by a young generation collection, so any reference from an old cell
+        // to a young one has to be found through the remembered set.
+        for (auto* cell : m_remembered_cells)
+            visitor.visit_edges_of(*cell);
+    }
 
     vm().bytecode_interpreter().visit_edges(visitor);
 
     visitor.mark_all_live_cells();
 
-    for (auto& inverse_root : m_uprooted_cells)
+    m_uprooted_cells.remove_all_matching([&](auto& inverse_root) {
+        // Old cells are only ever collected by a full collection, so keep them uprooted until then.
+        if (collection_type == CollectionType::CollectYoungGeneration && inverse_root->is_old())
+            return false;
         inverse_root->set_marked(false);
+        return true;
+    });
+}
+
+bool Heap::should_start_incremental_marking() const
+{
+    // Start marking once the old generation has grown halfway towards forcing a full collection,
+    // which leaves plenty of idle periods to get the marking done before it does.
+    return m_statistics.old_generation_bytes + m_allocated_bytes_since_last_gc > m_old_generation_bytes_threshold / 4 * 3;
+}
+
+void Heap::start_incremental_marking()
+{
+    dbgln_if(HEAP_DEBUG, "start_incremental_marking:");
+
+    VERIFY(!m_incremental_marking_visitor);
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    m_incremental_marking_visitor = make<MarkingVisitor>(*this, roots, CollectionType::CollectGarbage, MarkingVisitor::IsIncremental::Yes);
+    vm().bytecode_interpreter().visit_edges(*m_incremental_marking_visitor);
+    m_is_marking_incrementally = true;
+}
+
+bool Heap::perform_incremental_marking_step(Duration budget)
+{
+    if (m_gc_deferrals || m_collecting_garbage)
+        return is_marking_incrementally();
+    if (!is_marking_incrementally() && !should_start_incremental_marking())
+        return false;
+
+    Core::ElapsedTimer step_measurement_timer(true);
+    step_measurement_timer.start();
+
+    bool marked_all_cells;
+    {
+        TemporaryChange change(m_collecting_garbage, true);
+        if (!is_marking_incrementally())
+            start_incremental_marking();
+        m_incremental_marking_visitor->update_live_heap_blocks();
+        marked_all_cells = m_incremental_marking_visitor->mark_live_cells_until_budget_is_spent(step_measurement_timer, budget);
+    }
+
+    Duration const time_spent = step_measurement_timer.elapsed_time();
+    ++m_statistics.incremental_marking_steps;
+    m_statistics.time_spent_in_incremental_marking_steps += time_spent;
+    m_statistics.longest_pause = max(m_statistics.longest_pause, time_spent);
+    m_statistics.record_pause(time_spent);
+
+    if (marked_all_cells)
+        collect_garbage(CollectionType::CollectGarbage);
+    return is_marking_incrementally();
+}
 
+void Heap::finish_incremental_marking()
+{
+    dbgln_if(HEAP_DEBUG, "finish_incremental_marking:");
+
+    auto& visitor = *m_incremental_marking_visitor;
+    visitor.update_live_heap_blocks();
+
+    // The mutator ran between marking steps. Storing a GCPtr into a marked cell marked the stored cell right away,
+    // and any other store into a marked cell left it in the remembered set. So only the roots and those remembered cells
+    // have to be traced again.
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    visitor.visit_roots(roots);
+    vm().bytecode_interpreter().visit_edges(visitor);
+
+    for (auto* cell : m_remembered_cells) {
+        if (cell->is_marked())
+            visitor.visit_edges_of(*cell);
+    }
+
+    visitor.stop_deferring_cells_without_write_barriers();
+    visitor.mark_all_live_cells();
+
+    for (auto& inverse_root : m_uprooted_cells)
+        inverse_root->set_marked(false);
     m_uprooted_cells.clear();
+
+    m_incremental_marking_visitor = nullptr;
+    m_is_marking_incrementally = false;
+}
+
+void Heap::abort_incremental_marking()
+{
+    for_each_block([&](auto& block) {
+        block.clear_marks();
+        return IterationDecision::Continue;
+    });
+    m_cells_referencing_young_cells.clear();
+
+    m_incremental_marking_visitor = nullptr;
+    m_is_marking_incrementally = false;
+}
+
+void Heap::did_store_reference_while_marking(Cell& owner, Cell& cell)
+{
+    // An unmarked owner will be traced later on and see the new reference then. A marked one may have been traced
+    // already, so mark the cell it now points at before it can hide there.
+    if (!owner.is_marked())
+        return;
+    if (!cell.has_write_barriers() && (m_cells_referencing_young_cells.is_empty() || m_cells_referencing_young_cells.last() != &owner))
+        m_cells_referencing_young_cells.append(&owner);
+    m_incremental_marking_visitor->mark(cell);
+}
+
+void Heap::forget_remembered_cells()
+{
+    for (auto* cell : m_remembered_cells)
+        cell->set_remembered(false);
+    m_remembered_cells.clear();
+}
+
+void Heap::remember_cells_referencing_young_cells()
+{
+    // Everything on this list was marked, so it survived the collection. Young cells with write barriers got promoted
+    // by it, while those that are still young will be traced by the next collection anyway.
+    for (auto* cell : m_cells_referencing_young_cells) {
+        if (cell->is_old() && !cell->is_remembered())
+            remember_cell(*cell);
+    }
+    m_cells_referencing_young_cells.clear();
 }
 
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
@@ -467,8 +692,18 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
+void Heap::finalize_unmarked_cells(CollectionType collection_type)
 {
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        for (auto* block : m_blocks_with_young_cells) {
+            block->for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+                if (!cell->is_old() && !cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
+                    cell->finalize();
+            });
+        }
+        return;
+    }
+
     for_each_block([&](auto& block) {
         block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
@@ -478,39 +713,84 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
     Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    Vector<HeapBlock*, 32> blocks_with_dead_cells;
+
+    bool only_young_cells = collection_type == CollectionType::CollectYoungGeneration;
+
+    // When the heap goes away, everything has to be destroyed right now.
+    bool may_destroy_cells_lazily = collection_type != CollectionType::CollectEverything;
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
 
-    for_each_block([&](auto& block) {
+    Vector<HeapBlock*> blocks_with_young_cells;
+
+    auto sweep_block = [&](HeapBlock& block) {
         bool block_has_live_cells = false;
+        bool block_has_young_cells = false;
+        bool block_has_dead_cells = block.needs_sweep();
         bool block_was_full = block.is_full();
-        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+        block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (only_young_cells && cell->is_old()) {
+                block_has_live_cells = true;
+                return;
+            }
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
+                if (may_destroy_cells_lazily && cell->may_be_destroyed_lazily()) {
+                    cell->set_state(Cell::State::Dead);
+                    block_has_dead_cells = true;
+                } else {
+                    block.deallocate(cell);
+                }
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
             } else {
-                cell->set_marked(false);
+                // Every surviving cell with write barriers is promoted. Without them, we would never find out
+                // about young cells that get stored into it, so the others stay young forever.
+                if (!cell->is_old()) {
+                    if (cell->has_write_barriers()) {
+                        cell->set_old(true);
+                        promoted_cell_bytes += block.cell_size();
+                    } else {
+                        block_has_young_cells = true;
+                    }
+                }
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
             }
         });
-        if (!block_has_live_cells)
+        block.clear_marks();
+        block.set_has_young_cells(block_has_young_cells);
+        if (block_has_young_cells)
+            blocks_with_young_cells.append(&block);
+        if (block_has_dead_cells)
+            blocks_with_dead_cells.append(&block);
+        else if (!block_has_live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
             full_blocks_that_became_usable.append(&block);
-        return IterationDecision::Continue;
-    });
+    };
+
+    if (only_young_cells) {
+        for (auto* block : m_blocks_with_young_cells)
+            sweep_block(*block);
+    } else {
+        for_each_block([&](auto& block) {
+            sweep_block(block);
+            return IterationDecision::Continue;
+        });
+    }
+    m_blocks_with_young_cells = move(blocks_with_young_cells);
 
     for (auto& weak_container : m_weak_containers)
         weak_container.remove_dead_cells({});
@@ -525,6 +805,18 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         block->cell_allocator().block_did_become_usable({}, *block);
     }
 
+    // Blocks with dead cells are swept once their CellAllocator runs out of usable blocks, which keeps running
+    // destructors and rebuilding freelists out of the collection pause.
+    for (auto* block : blocks_with_dead_cells) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock needs sweep @ {}: cell_size={}", block, block->cell_size());
+        block->cell_allocator().block_did_get_dead_cells({}, *block);
+    }
+
+    if (!may_destroy_cells_lazily) {
+        for (auto& allocator : m_all_cell_allocators)
+            allocator.sweep_all_blocks({});
+    }
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -532,10 +824,25 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    Duration const time_spent = measurement_timer.elapsed_time();
+    m_statistics.promoted_bytes += promoted_cell_bytes;
+    m_statistics.longest_pause = max(m_statistics.longest_pause, time_spent);
+    m_statistics.record_pause(time_spent);
+
+    if (only_young_cells) {
+        // The young generation collection only saw a part of the heap, so we keep the allocation threshold from the last full collection.
+        m_statistics.old_generation_bytes += promoted_cell_bytes;
+        ++m_statistics.young_generation_collections;
+        m_statistics.time_spent_in_young_generation_collections += time_spent;
+    } else {
+        m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+        m_old_generation_bytes_threshold = max(live_cell_bytes * 2, GC_MIN_BYTES_THRESHOLD);
+        m_statistics.old_generation_bytes = live_cell_bytes;
+        ++m_statistics.full_collections;
+        m_statistics.time_spent_in_full_collections += time_spent;
+    }
 
     if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
         size_t live_block_count = 0;
         for_each_block([&](auto&) {
             ++live_block_count;
@@ -544,15 +851,65 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
+        dbgln("     Collection: {}", only_young_cells ? "young generation"sv : "full"sv);
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln(" Promoted cells: {} bytes", promoted_cell_bytes);
+        dbgln(" Old generation: {} bytes", m_statistics.old_generation_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        size_t unswept_block_count = 0;
+        for (auto& allocator : m_all_cell_allocators)
+            unswept_block_count += allocator.unswept_block_count();
+        dbgln(" Unswept blocks: {}", unswept_block_count);
+        dbgln("    Collections: {} young generation ({} ms), {} full ({} ms)",
+            m_statistics.young_generation_collections, m_statistics.time_spent_in_young_generation_collections.to_milliseconds(),
+            m_statistics.full_collections, m_statistics.time_spent_in_full_collections.to_milliseconds());
+        dbgln("  Marking steps: {} ({} ms)", m_statistics.incremental_marking_steps, m_statistics.time_spent_in_incremental_marking_steps.to_milliseconds());
+        dbgln("  Longest pause: {} ms", m_statistics.longest_pause.to_milliseconds());
+        dbgln("   Pause p50/99: <{} us / <{} us", m_statistics.pause_percentile(50).to_microseconds(), m_statistics.pause_percentile(99).to_microseconds());
+        dbgln("Pause histogram:");
+        for (size_t i = 0; i < Statistics::pause_histogram_bucket_count; ++i) {
+            if (m_statistics.pause_histogram[i] == 0)
+                continue;
+            if (i == Statistics::pause_histogram_bucket_count - 1)
+                dbgln("   >= {:>8} us: {}", 1ull << (i - 1), m_statistics.pause_histogram[i]);
+            else
+                dbgln("    < {:>8} us: {}", 1ull << i, m_statistics.pause_histogram[i]);
+        }
         dbgln("=============================================");
     }
 }
 
+void Heap::Statistics::record_pause(Duration pause)
+{
+    auto microseconds = static_cast<u64>(max<i64>(pause.to_microseconds(), 0));
+    size_t bucket = 0;
+    while (bucket < pause_histogram_bucket_count - 1 && microseconds >= (1ull << bucket))
+        ++bucket;
+    ++pause_histogram[bucket];
+}
+
+Duration Heap::Statistics::pause_percentile(size_t percent) const
+{
+    size_t pause_count = 0;
+    for (auto count : pause_histogram)
+        pause_count += count;
+    if (pause_count == 0)
+        return {};
+
+    // This is the upper bound of the bucket that the percentile falls into, so it overestimates by up to a factor of two.
+    size_t pauses_to_skip = (pause_count * percent + 99) / 100;
+    size_t seen_pauses = 0;
+    for (size_t i = 0; i < pause_histogram_bucket_count; ++i) {
+        seen_pauses += pause_histogram[i];
+        if (seen_pauses >= pauses_to_skip)
+            return Duration::from_microseconds(1ll << i);
+    }
+    VERIFY_NOT_REACHED();
+}
+
 void Heap::defer_gc()
 {
     ++m_gc_deferrals;
@@ -565,7 +922,7 @@ void Heap::undefer_gc()
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage(exchange(m_collection_type_when_deferral_ends, CollectionType::CollectYoungGeneration));
         m_should_gc_when_deferral_ends = false;
     }
 }
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -27,6 +30,8 @@
 
 namespace JS {
 
+class MarkingVisitor;
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -41,6 +46,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        memory->set_has_write_barriers({}, memory->class_has_write_barriers());
         undefer_gc();
         return *static_cast<T*>(memory);
     }
@@ -51,6 +57,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        memory->set_has_write_barriers({}, memory->class_has_write_barriers());
         undefer_gc();
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
@@ -59,10 +66,37 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
+
+    // Marks live cells for at most the given time budget, starting a new incremental marking first if a full
+    // collection is coming up. Once everything has been marked, the collection is finished in the same call.
+    // Returns whether incremental marking is still in progress afterwards.
+    bool perform_incremental_marking_step(Duration budget);
+
+    struct Statistics {
+        size_t young_generation_collections { 0 };
+        size_t full_collections { 0 };
+        size_t incremental_marking_steps { 0 };
+        Duration time_spent_in_young_generation_collections;
+        Duration time_spent_in_full_collections;
+        Duration time_spent_in_incremental_marking_steps;
+        Duration longest_pause;
+        size_t promoted_bytes { 0 };
+        size_t old_generation_bytes { 0 };
+
+        // Bucket i counts pauses that took less than 2^i microseconds (and at least 2^(i-1)), the last bucket counts all longer pauses.
+        static constexpr size_t pause_histogram_bucket_count = 24;
+        AK::Array<size_t, pause_histogram_bucket_count> pause_histogram {};
+
+        void record_pause(Duration);
+        Duration pause_percentile(size_t percent) const;
+    };
+
+    Statistics const& statistics() const { return m_statistics; }
     AK::JsonObject dump_graph();
 
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
@@ -81,6 +115,10 @@ public:
     void did_destroy_execution_context(Badge<ExecutionContext>, ExecutionContext&);
 
     void register_cell_allocator(Badge<CellAllocator>, CellAllocator&);
+    void did_allocate_first_young_cell_in_block(Badge<CellAllocator>, HeapBlock&);
+
+    void remember_cell(Badge<Cell>, Cell& cell) { remember_cell(cell); }
+    void did_store_reference(Badge<HeapBlockBase>, Cell& owner, Cell const& cell);
 
     void uproot_cell(Cell* cell);
 
@@ -112,9 +150,20 @@ private:
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
-    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells, CollectionType);
+    void remember_cell(Cell&);
+    void forget_remembered_cells();
+    void remember_cells_referencing_young_cells();
+    void did_store_reference_while_marking(Cell& owner, Cell& cell);
+    void finalize_unmarked_cells(CollectionType);
+    void sweep_dead_cells(CollectionType, bool print_report, Core::ElapsedTimer const&);
+
+    bool should_start_incremental_marking() const;
+    void start_incremental_marking();
+    void finish_incremental_marking();
+    void abort_incremental_marking();
+
+    CollectionType collection_type_for_allocation() const;
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -140,6 +189,9 @@ private:
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
     size_t m_allocated_bytes_since_last_gc { 0 };
 
+    // A full collection is forced once the old generation has grown to this size.
+    size_t m_old_generation_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
+
     bool m_should_collect_on_every_allocation { false };
 
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
@@ -151,8 +203,26 @@ private:
 
     Vector<GCPtr<Cell>> m_uprooted_cells;
 
+    // Blocks that hold young cells, either allocated since the last collection or never promoted.
+    Vector<HeapBlock*> m_blocks_with_young_cells;
+
+    // Old cells with write barriers that have had a reference to a young cell stored into them since the last collection,
+    // and marked cells whose write_barrier() fired during incremental marking.
+    Vector<Cell*> m_remembered_cells;
+
+    // Cells with write barriers that the last marking found pointing at cells without them. Those are never promoted,
+    // so once the collection is done, these cells have to stay in the remembered set for as long as they're old.
+    Vector<Cell*> m_cells_referencing_young_cells;
+
+    // Only present while incremental marking is in progress, keeps the gray cells between marking steps,
+    // along with the marked cells without write barriers that are left for the final pause.
+    OwnPtr<MarkingVisitor> m_incremental_marking_visitor;
+
+    Statistics m_statistics;
+
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
+    CollectionType m_collection_type_when_deferral_ends { CollectionType::CollectYoungGeneration };
 
     bool m_collecting_garbage { false };
 };
@@ -198,4 +268,28 @@ inline void Heap::register_cell_allocator(Badge<CellAllocator>, CellAllocator& a
     m_all_cell_allocators.append(allocator);
 }
 
+inline void Heap::did_allocate_first_young_cell_in_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    block.set_has_young_cells(true);
+    m_blocks_with_young_cells.append(&block);
+}
+
+inline void Heap::remember_cell(Cell& cell)
+{
+    VERIFY(cell.has_write_barriers());
+    cell.set_remembered(true);
+    m_remembered_cells.append(&cell);
+}
+
+inline void Heap::did_store_reference(Badge<HeapBlockBase>, Cell& owner, Cell const& cell)
+{
+    // Remembered cells are traced again anyway, and cells without write barriers are never promoted.
+    if (owner.is_remembered() || !owner.has_write_barriers())
+        return;
+    if (is_marking_incrementally()) [[unlikely]]
+        did_store_reference_while_marking(owner, const_cast<Cell&>(cell));
+    if (owner.is_old() && !cell.is_old())
+        remember_cell(owner);
+}
+
 }
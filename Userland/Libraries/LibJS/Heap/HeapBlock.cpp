@@ -7,6 +7,8 @@
 #include <AK/Assertions.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Platform.h>
+#include <AK/Random.h>
+#include <AK/StackInfo.h>
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/HeapBlock.h>
 #include <stdio.h>
@@ -18,6 +20,35 @@
 
 namespace JS {
 
+// Random, so that nothing outside of a HeapBlock can be made to look like one by accident (or on purpose).
+FlatPtr const HeapBlockBase::s_cookie_key = get_random<FlatPtr>();
+
+static bool is_on_current_thread_stack(void const* address)
+{
+    static thread_local StackInfo const stack_info;
+    auto address_value = bit_cast<FlatPtr>(address);
+    return address_value >= stack_info.base() && address_value < stack_info.top();
+}
+
+void HeapBlockBase::did_store_reference(void const* slot, void const* cell)
+{
+    // The barrier computes the cookie of the page around every slot it sees, and a copy of it spilled to the stack can
+    // end up at the very start of that page. Nothing else ever writes it outside of a HeapBlock, so only check for that.
+    if (is_on_current_thread_stack(slot))
+        return;
+
+    // Stores into the block's own bookkeeping, into free cells, and into cells that are being destroyed don't matter.
+    auto* owner = static_cast<HeapBlock*>(this)->cell_from_possible_pointer(bit_cast<FlatPtr>(slot));
+    if (!owner || owner->state() != Cell::State::Live)
+        return;
+
+    // The stored pointer may point into the middle of the cell, for classes that have other base classes before Cell.
+    auto* cell_block = HeapBlock::from_cell(static_cast<Cell const*>(cell));
+    auto* referenced_cell = cell_block->cell_from_possible_pointer(bit_cast<FlatPtr>(cell));
+    VERIFY(referenced_cell);
+    m_heap.did_store_reference({}, *owner, *referenced_cell);
+}
+
 NonnullOwnPtr<HeapBlock> HeapBlock::create_with_cell_size(Heap& heap, CellAllocator& cell_allocator, size_t cell_size, [[maybe_unused]] char const* class_name)
 {
 #ifdef AK_OS_SERENITY
@@ -47,12 +78,12 @@ void HeapBlock::deallocate(Cell* cell)
 {
     VERIFY(is_valid_cell_pointer(cell));
     VERIFY(!m_freelist || is_valid_cell_pointer(m_freelist));
-    VERIFY(cell->state() == Cell::State::Live);
+    VERIFY(cell->state() != Cell::State::Free);
     VERIFY(!cell->is_marked());
 
     cell->~Cell();
     auto* freelist_entry = new (cell) FreelistEntry();
-    freelist_entry->set_state(Cell::State::Dead);
+    freelist_entry->set_state(Cell::State::Free);
     freelist_entry->next = m_freelist;
     m_freelist = freelist_entry;
 
@@ -67,4 +98,17 @@ void HeapBlock::deallocate(Cell* cell)
 #endif
 }
 
+bool HeapBlock::sweep()
+{
+    bool has_live_cells = false;
+    for_each_cell([&](Cell* cell) {
+        if (cell->state() == Cell::State::Dead)
+            deallocate(cell);
+        else if (cell->state() == Cell::State::Live)
+            has_live_cells = true;
+    });
+    m_needs_sweep = false;
+    return has_live_cells;
+}
+
 }
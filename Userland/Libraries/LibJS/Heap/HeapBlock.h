@@ -58,6 +58,33 @@ public:
             callback(cell(i));
     }
 
+    // Destroys the cells that a collection found dead and left behind for lazy sweeping.
+    // Returns whether the block still contains any live cells.
+    bool sweep();
+
+    bool needs_sweep() const { return m_needs_sweep; }
+    void set_needs_sweep(bool b) { m_needs_sweep = b; }
+
+    bool is_marked(Cell const* cell) const
+    {
+        auto index = cell_index(cell);
+        return m_mark_bits[index / 64] & (1ull << (index % 64));
+    }
+
+    void set_marked(Cell const* cell, bool marked)
+    {
+        auto index = cell_index(cell);
+        if (marked)
+            m_mark_bits[index / 64] |= 1ull << (index % 64);
+        else
+            m_mark_bits[index / 64] &= ~(1ull << (index % 64));
+    }
+
+    void clear_marks()
+    {
+        __builtin_memset(m_mark_bits, 0, sizeof(m_mark_bits));
+    }
+
     template<Cell::State state, typename Callback>
     void for_each_cell_in_state(Callback callback)
     {
@@ -92,6 +119,10 @@ public:
 
     CellAllocator& cell_allocator() { return m_cell_allocator; }
 
+    // Whether cells have been allocated in this block since the last garbage collection.
+    bool has_young_cells() const { return m_has_young_cells; }
+    void set_has_young_cells(bool b) { m_has_young_cells = b; }
+
 private:
     HeapBlock(Heap&, CellAllocator&, size_t cell_size);
 
@@ -108,14 +139,36 @@ private:
         return reinterpret_cast<Cell*>(&m_storage[index * cell_size()]);
     }
 
+    size_t cell_index(Cell const* cell) const
+    {
+        return (reinterpret_cast<FlatPtr>(cell) - reinterpret_cast<FlatPtr>(m_storage)) / m_cell_size;
+    }
+
+    static constexpr size_t max_cell_count = block_size / sizeof(FreelistEntry);
+
     CellAllocator& m_cell_allocator;
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
+    bool m_has_young_cells { false };
+    bool m_needs_sweep { false };
     GCPtr<FreelistEntry> m_freelist;
+
+    // Keeping the mark bits out of the cells means marking doesn't dirty every live cell, and clearing them is a memset.
+    u64 m_mark_bits[ceil_div(max_cell_count, static_cast<size_t>(64))] {};
     alignas(__BIGGEST_ALIGNMENT__) u8 m_storage[];
 
 public:
     static constexpr size_t min_possible_cell_size = sizeof(FreelistEntry);
 };
 
+inline bool Cell::is_marked() const
+{
+    return HeapBlock::from_cell(this)->is_marked(this);
+}
+
+inline void Cell::set_marked(bool marked)
+{
+    HeapBlock::from_cell(this)->set_marked(this, marked);
+}
+
 }
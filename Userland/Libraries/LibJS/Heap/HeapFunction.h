@@ -38,6 +38,9 @@ private:
         visitor.visit_possible_values(m_function.raw_capture_range());
     }
 
+    // The captures are fixed once the function has been created.
+    virtual bool class_has_write_barriers() const override { return true; }
+
     Function<T> m_function;
 };
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibJS/Forward.h>
 
@@ -19,6 +20,8 @@ class HeapBase {
 public:
     VM& vm() { return m_vm; }
 
+    bool is_marking_incrementally() const { return m_is_marking_incrementally; }
+
 protected:
     HeapBase(VM& vm)
         : m_vm(vm)
@@ -26,6 +29,7 @@ protected:
     }
 
     VM& m_vm;
+    bool m_is_marking_incrementally { false };
 };
 
 class HeapBlockBase {
@@ -39,15 +43,53 @@ public:
         return reinterpret_cast<HeapBlockBase*>(bit_cast<FlatPtr>(cell) & ~(HeapBlockBase::block_size - 1));
     }
 
+    // Returns the block that the given address lies in, or nullptr if it's not inside a HeapBlock.
+    // NOTE: This looks at the start of the block-sized chunk around the address, which is mapped as long as the address is.
+    //       Whatever else lives there may not be ours to read, hence no ASAN.
+    // NOTE: A stack page can look like a block if a spilled cookie lands at its start, see did_store_reference().
+    NO_SANITIZE_ADDRESS static HeapBlockBase* from_possible_interior_pointer(void const* address)
+    {
+        auto* block = reinterpret_cast<HeapBlockBase*>(bit_cast<FlatPtr>(address) & ~(HeapBlockBase::block_size - 1));
+        if (block->m_cookie != cookie_for(block))
+            return nullptr;
+        return block;
+    }
+
     Heap& heap() { return m_heap; }
 
+    // Remembers the cell that `slot` lies in if the collector needs to know about the reference to `cell` stored there.
+    void did_store_reference(void const* slot, void const* cell);
+
 protected:
     HeapBlockBase(Heap& heap)
-        : m_heap(heap)
+        : m_cookie(cookie_for(this))
+        , m_heap(heap)
     {
     }
 
+private:
+    static FlatPtr cookie_for(HeapBlockBase const* block) { return bit_cast<FlatPtr>(block) ^ s_cookie_key; }
+
+    static FlatPtr const s_cookie_key;
+
+    // Must come first, see from_possible_interior_pointer().
+    FlatPtr m_cookie { 0 };
+
+protected:
     Heap& m_heap;
 };
 
+// Called after storing a reference to `cell` (or any address inside it) at `slot`. GCPtr and NonnullGCPtr call this
+// from their assignment operators, so stores into a cell's own members are seen by the garbage collector.
+// Stores anywhere else, like the stack or a Vector's buffer, are not interesting and get filtered out here.
+// NOTE: Value doesn't do this, as it's copied around the interpreter's registers and the stack far more often than
+//       it's stored into a cell. Cells call Cell::write_barrier() after storing into their Value members instead.
+ALWAYS_INLINE void write_barrier(void const* slot, void const* cell)
+{
+    if (!cell)
+        return;
+    if (auto* block = HeapBlockBase::from_possible_interior_pointer(slot))
+        block->did_store_reference(slot, cell);
+}
+
 }
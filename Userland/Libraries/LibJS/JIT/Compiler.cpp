@@ -1689,36 +1689,15 @@ void Compiler::compile_get_by_id(Bytecode::Op::GetById const& op)
             no_magical_length_property_case.link(m_assembler);
         }
 
-        // if (cache.shape != &object->shape()) goto slow_case;
+        // GPR1 = *cache.find(object->shape())->property_offset, or goto slow_case;
         m_assembler.mov(
             Assembler::Operand::Register(GPR2),
             Assembler::Operand::Mem64BaseAndOffset(GPR0, Object::shape_offset()));
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::shape_offset()));
-
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Condition::EqualTo,
-            Assembler::Operand::Imm(0),
-            slow_case);
-
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(GPR1, AK::WeakLink::ptr_offset()));
-
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR2),
-            Assembler::Condition::NotEqualTo,
-            Assembler::Operand::Register(GPR1),
-            slow_case);
+        probe_property_lookup_cache(GPR1, GPR2, ARG5, slow_case);
 
-        // return object->get_direct(*cache.property_offset);
+        // return object->get_direct(property_offset);
         // GPR0 = object
-        // GPR1 = *cache.property_offset * sizeof(Value)
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
+        // GPR1 = property_offset * sizeof(Value)
         m_assembler.mul32(
             Assembler::Operand::Register(GPR1),
             Assembler::Operand::Imm(sizeof(Value)),
@@ -1951,7 +1930,7 @@ void Compiler::compile_get_global(Bytecode::Op::GetGlobal const& op)
     // GPR2 = cache.shape.ptr()
     m_assembler.mov(
         Assembler::Operand::Register(GPR2),
-        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::PropertyLookupCache::shape_offset()));
+        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::GlobalVariableCache::shape_offset()));
     m_assembler.jump_if(
         Assembler::Operand::Register(GPR2),
         Assembler::Condition::EqualTo,
@@ -1976,7 +1955,7 @@ void Compiler::compile_get_global(Bytecode::Op::GetGlobal const& op)
         Assembler::Operand::Register(GPR1));
     m_assembler.mov(
         Assembler::Operand::Register(GPR1),
-        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
+        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::GlobalVariableCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
     m_assembler.mul32(
         Assembler::Operand::Register(GPR1),
         Assembler::Operand::Imm(sizeof(Value)),
@@ -2218,6 +2197,41 @@ void Compiler::compile_resolve_this_binding(Bytecode::Op::ResolveThisBinding con
     end.link(m_assembler);
 }
 
+static void cxx_object_write_barrier(VM&, Value base)
+{
+    base.as_object().write_barrier();
+}
+
+void Compiler::write_barrier_if_cell(Assembler::Reg owner, Assembler::Reg value, void* write_barrier_function)
+{
+    // if ((value >> TAG_SHIFT & IS_CELL_PATTERN) != IS_CELL_PATTERN) goto not_cell;
+    Assembler::Label not_cell;
+    m_assembler.mov(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Operand::Register(value));
+    m_assembler.shift_right(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.bitwise_and(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Operand::Imm(IS_CELL_PATTERN));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(IS_CELL_PATTERN),
+        not_cell);
+
+    // write_barrier_function(vm, owner);
+    if (owner != ARG1) {
+        m_assembler.mov(
+            Assembler::Operand::Register(ARG1),
+            Assembler::Operand::Register(owner));
+    }
+    native_call(write_barrier_function);
+
+    not_cell.link(m_assembler);
+}
+
 static Value cxx_put_by_id(VM& vm, Value base, DeprecatedFlyString const& property, Value value, Bytecode::Op::PropertyKind kind, Bytecode::PropertyLookupCache& cache)
 {
     TRY_OR_SET_EXCEPTION(Bytecode::put_by_property_key(vm, base, base, value, property, kind, &cache));
@@ -2238,6 +2252,60 @@ void Compiler::extract_object_pointer(Assembler::Reg dst_object, Assembler::Reg
         Assembler::Operand::Imm(16));
 }
 
+void Compiler::probe_property_lookup_cache(Assembler::Reg dst_offset, Assembler::Reg shape, Assembler::Reg cache, Assembler::Label& slow_case)
+{
+    Assembler::Label found;
+
+    for (size_t i = 0; i < Bytecode::PropertyLookupCache::max_number_of_shapes; ++i) {
+        auto entry_offset = Bytecode::PropertyLookupCache::entries_offset() + i * sizeof(Bytecode::PropertyLookupCache::Entry);
+        Assembler::Label next_entry;
+
+        // if (!entry.shape || entry.shape.ptr() != shape) goto next_entry;
+        m_assembler.mov(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::shape_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Condition::EqualTo,
+            Assembler::Operand::Imm(0),
+            next_entry);
+        m_assembler.mov(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Operand::Mem64BaseAndOffset(dst_offset, AK::WeakLink::ptr_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Register(shape),
+            next_entry);
+
+        // if (entry.is_transition) goto slow_case;
+        m_assembler.mov8(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::is_transition_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Imm(0),
+            slow_case);
+
+        // dst_offset = *entry.property_offset;
+        m_assembler.mov(
+            Assembler::Operand::Register(dst_offset),
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::property_offset_offset() + decltype(Bytecode::PropertyLookupCache::Entry::property_offset)::value_offset()));
+        m_assembler.jump(found);
+
+        next_entry.link(m_assembler);
+    }
+    m_assembler.jump(slow_case);
+
+    found.link(m_assembler);
+
+    // ++cache.hit_count;
+    m_assembler.add(
+        Assembler::Operand::Mem64BaseAndOffset(cache, Bytecode::PropertyLookupCache::hit_count_offset()),
+        Assembler::Operand::Imm(1));
+}
+
 void Compiler::compile_put_by_id(Bytecode::Op::PutById const& op)
 {
     auto& cache = m_bytecode_executable.property_lookup_caches[op.cache_index()];
@@ -2254,36 +2322,16 @@ void Compiler::compile_put_by_id(Bytecode::Op::PutById const& op)
         branch_if_object(ARG1, [&] {
             extract_object_pointer(GPR0, ARG1);
 
-            // if (cache.shape != &object->shape()) goto slow_case;
+            // GPR1 = *cache.find(object->shape())->property_offset, or goto slow_case;
+            // NOTE: Entries that add a new property are left to the slow case.
             m_assembler.mov(
                 Assembler::Operand::Register(GPR2),
                 Assembler::Operand::Mem64BaseAndOffset(GPR0, Object::shape_offset()));
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::shape_offset()));
+            probe_property_lookup_cache(GPR1, GPR2, ARG5, slow_case);
 
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Condition::EqualTo,
-                Assembler::Operand::Imm(0),
-                slow_case);
-
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(GPR1, AK::WeakLink::ptr_offset()));
-
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR2),
-                Assembler::Condition::NotEqualTo,
-                Assembler::Operand::Register(GPR1),
-                slow_case);
-
-            // object->put_direct(*cache.property_offset, value);
+            // object->put_direct(property_offset, value);
             // GPR0 = object
-            // GPR1 = *cache.property_offset * sizeof(Value)
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
+            // GPR1 = property_offset * sizeof(Value)
             m_assembler.mul32(
                 Assembler::Operand::Register(GPR1),
                 Assembler::Operand::Imm(sizeof(Value)),
@@ -2305,6 +2353,8 @@ void Compiler::compile_put_by_id(Bytecode::Op::PutById const& op)
                 Assembler::Operand::Mem64BaseAndOffset(GPR0, 0),
                 Assembler::Operand::Register(GPR1));
 
+            write_barrier_if_cell(ARG1, GPR1, (void*)cxx_object_write_barrier);
+
             m_assembler.jump(end);
         });
     }
@@ -2441,6 +2491,9 @@ void Compiler::compile_put_by_value(Bytecode::Op::PutByValue const& op)
 
             // accumulator = ARG3;
             store_accumulator(ARG3);
+
+            write_barrier_if_cell(ARG1, ARG3, (void*)cxx_object_write_barrier);
+
             m_assembler.jump(end);
         });
     });
@@ -2746,6 +2799,11 @@ void Compiler::compile_create_variable(Bytecode::Op::CreateVariable const& op)
     check_exception();
 }
 
+static void cxx_environment_write_barrier(VM&, Environment* environment)
+{
+    environment->write_barrier();
+}
+
 static Value cxx_set_variable(
     VM& vm,
     DeprecatedFlyString const& identifier,
@@ -2840,6 +2898,11 @@ void Compiler::compile_set_variable(Bytecode::Op::SetVariable const& op)
         Assembler::Operand::Imm(0),
         slow_case);
 
+    // ARG4 = environment, for the write barrier
+    m_assembler.mov(
+        Assembler::Operand::Register(ARG4),
+        Assembler::Operand::Register(GPR1));
+
     // GPR1 = environment->m_bindings.outline_buffer()
     m_assembler.mov(
         Assembler::Operand::Register(GPR1),
@@ -2879,6 +2942,8 @@ void Compiler::compile_set_variable(Bytecode::Op::SetVariable const& op)
         Assembler::Operand::Mem64BaseAndOffset(GPR1, DeclarativeEnvironment::Binding::value_offset()),
         Assembler::Operand::Register(ARG2));
 
+    write_barrier_if_cell(ARG4, ARG2, (void*)cxx_environment_write_barrier);
+
     Assembler::Label end;
     m_assembler.jump(end);
 
@@ -211,6 +211,8 @@ private:
     }
 
     void extract_object_pointer(Assembler::Reg dst_object, Assembler::Reg src_value);
+    void write_barrier_if_cell(Assembler::Reg owner, Assembler::Reg value, void* write_barrier_function);
+    void probe_property_lookup_cache(Assembler::Reg dst_offset, Assembler::Reg shape, Assembler::Reg cache, Assembler::Label& slow_case);
     void convert_to_double(Assembler::Reg dst, Assembler::Reg src, Assembler::Reg nan, Assembler::Reg temp, Assembler::Label& not_number);
 
     template<typename Codegen>
@@ -36,6 +36,9 @@ public:
         visitor.visit(m_setter);
     }
 
+    virtual bool class_has_write_barriers() const override { return true; }
+    virtual bool may_be_destroyed_lazily() const override { return true; }
+
 private:
     Accessor(FunctionObject* getter, FunctionObject* setter)
         : m_getter(getter)
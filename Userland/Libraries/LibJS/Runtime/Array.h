@@ -49,6 +49,9 @@ public:
 
     [[nodiscard]] bool length_is_writable() const { return m_length_writable; }
 
+    // ArrayPrototype inherits from us, but as an intrinsic it has not been checked for lazy destruction.
+    virtual bool may_be_destroyed_lazily() const override { return class_name() == "Array"sv; }
+
 protected:
     explicit Array(Object& prototype);
 
@@ -77,7 +77,11 @@ public:
     void set_data_block(DataBlock block) { m_data_block = move(block); }
 
     Value detach_key() const { return m_detach_key; }
-    void set_detach_key(Value detach_key) { m_detach_key = detach_key; }
+    void set_detach_key(Value detach_key)
+    {
+        m_detach_key = detach_key;
+        write_barrier();
+    }
 
     void detach_buffer() { m_data_block.byte_buffer = Empty {}; }
 
@@ -35,6 +35,9 @@ private:
     AsyncFunctionDriverWrapper(Realm&, NonnullGCPtr<GeneratorObject>, NonnullGCPtr<Promise> top_level_promise);
     ThrowCompletionOr<void> await(Value);
 
+    // The suspended execution context is written without write barriers.
+    virtual bool class_has_write_barriers() const override { return false; }
+
     NonnullGCPtr<GeneratorObject> m_generator_object;
     NonnullGCPtr<Promise> m_top_level_promise;
     GCPtr<Promise> m_current_promise { nullptr };
@@ -46,6 +46,9 @@ public:
 private:
     AsyncGenerator(Realm&, Object& prototype, NonnullOwnPtr<ExecutionContext>);
 
+    // The suspended execution context and call frame are written without write barriers.
+    virtual bool class_has_write_barriers() const override { return false; }
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     void execute(VM&, Completion completion);
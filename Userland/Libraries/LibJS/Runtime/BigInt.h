@@ -32,6 +32,9 @@ public:
 private:
     explicit BigInt(Crypto::SignedBigInteger);
 
+    virtual bool class_has_write_barriers() const override { return true; }
+    virtual bool may_be_destroyed_lazily() const override { return true; }
+
     Crypto::SignedBigInteger m_big_integer;
 };
 
@@ -133,6 +133,9 @@ protected:
 private:
     virtual bool is_declarative_environment() const override { return true; }
 
+    // FunctionEnvironment opts in on its own, ModuleEnvironment has not been checked for lazy destruction.
+    virtual bool may_be_destroyed_lazily() const override { return class_name() == "DeclarativeEnvironment"sv; }
+
     Vector<Binding> m_bindings;
     Vector<DisposableResource> m_disposable_resource_stack;
 
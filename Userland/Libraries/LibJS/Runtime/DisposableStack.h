@@ -34,6 +34,9 @@ private:
 
     virtual void visit_edges(Visitor& visitor) override;
 
+    // disposable_resource_stack() hands out the stack for writing without write barriers.
+    virtual bool class_has_write_barriers() const override { return false; }
+
     Vector<DisposableResource> m_disposable_resource_stack;
     DisposableState m_state { DisposableState::Pending };
 };
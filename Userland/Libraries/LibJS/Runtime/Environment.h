@@ -60,6 +60,9 @@ public:
     static FlatPtr is_permanently_screwed_by_eval_offset() { return OFFSET_OF(Environment, m_permanently_screwed_by_eval); }
     static FlatPtr outer_environment_offset() { return OFFSET_OF(Environment, m_outer_environment); }
 
+    // Bindings that don't live in a GCPtr member of the environment call write_barrier() after they're stored.
+    virtual bool class_has_write_barriers() const override { return true; }
+
 protected:
     explicit Environment(Environment* parent);
 
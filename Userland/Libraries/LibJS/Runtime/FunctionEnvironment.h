@@ -36,6 +36,7 @@ public:
     {
         VERIFY(!new_target.is_empty());
         m_new_target = new_target;
+        write_barrier();
     }
 
     // Abstract operations
@@ -49,6 +50,7 @@ private:
     explicit FunctionEnvironment(Environment* parent_environment);
 
     virtual bool is_function_environment() const override { return true; }
+    virtual bool may_be_destroyed_lazily() const override { return true; }
     virtual void visit_edges(Visitor&) override;
 
     Value m_this_value;                                                           // [[ThisValue]]
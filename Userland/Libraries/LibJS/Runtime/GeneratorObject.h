@@ -40,6 +40,9 @@ protected:
     virtual ThrowCompletionOr<Value> execute(VM&, JS::Completion const& completion);
 
 private:
+    // The suspended execution context and call frame are written without write barriers.
+    virtual bool class_has_write_barriers() const override { return false; }
+
     NonnullOwnPtr<ExecutionContext> m_execution_context;
     GCPtr<ECMAScriptFunctionObject> m_generating_function;
     Value m_previous_value;
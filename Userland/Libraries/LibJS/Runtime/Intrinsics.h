@@ -103,6 +103,7 @@ private:
     }
 
     virtual void visit_edges(Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
     ThrowCompletionOr<void> initialize_intrinsics(Realm&);
 
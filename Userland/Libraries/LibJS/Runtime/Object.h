@@ -201,14 +201,49 @@ public:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    // This only opts in plain objects. Subclasses inherit this override, so it checks the exact class, and each subclass
+    // has to opt in on its own once its destructor has been checked.
+    virtual bool may_be_destroyed_lazily() const override { return !m_has_intrinsic_accessors && class_name() == "Object"sv; }
+
+    // Property storage calls write_barrier() itself. Subclasses that keep references elsewhere have to do the same,
+    // or override this to opt out again.
+    virtual bool class_has_write_barriers() const override { return true; }
+
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        write_barrier();
+    }
+
+    // Non-standard: Adds the property that `new_shape` was created for by a put transition from our current shape.
+    //               This is used by inline caches to replay a transition they've observed before.
+    bool put_direct_with_cached_transition(Shape& new_shape, Value value)
+    {
+        if (!m_is_extensible)
+            return false;
+        VERIFY(new_shape.property_count() == m_storage.size() + 1);
+        m_shape = &new_shape;
+        m_storage.append(value);
+        write_barrier();
+        return true;
+    }
 
     static FlatPtr storage_offset() { return OFFSET_OF(Object, m_storage); }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
-    IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    // NOTE: This assumes that the caller is about to store into the indexed properties, and that it does so without
+    //       allocating any cells first, which could start a garbage collection that forgets about the barrier.
+    IndexedProperties& indexed_properties()
+    {
+        write_barrier();
+        return m_indexed_properties;
+    }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        m_indexed_properties = IndexedProperties(move(values));
+        write_barrier();
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -48,6 +48,7 @@ private:
     ObjectEnvironment(Object& binding_object, IsWithEnvironment, Environment* outer_environment);
 
     virtual void visit_edges(Visitor&) override;
+    virtual bool may_be_destroyed_lazily() const override { return true; }
 
     NonnullGCPtr<Object> m_binding_object;
     bool m_with_environment { false };
@@ -61,6 +61,9 @@ private:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    // Ropes are only ever flattened, which drops references instead of adding them.
+    virtual bool class_has_write_barriers() const override { return true; }
+
     enum class EncodingPreference {
         UTF8,
         UTF16,
@@ -211,6 +211,7 @@ void Promise::fulfill(Value value)
 
     // 3. Set promise.[[PromiseResult]] to value.
     m_result = value;
+    write_barrier();
 
     // 4. Set promise.[[PromiseFulfillReactions]] to undefined.
     // 5. Set promise.[[PromiseRejectReactions]] to undefined.
@@ -242,6 +243,7 @@ void Promise::reject(Value reason)
 
     // 3. Set promise.[[PromiseResult]] to reason.
     m_result = reason;
+    write_barrier();
 
     // 4. Set promise.[[PromiseFulfillReactions]] to undefined.
     // 5. Set promise.[[PromiseRejectReactions]] to undefined.
@@ -336,6 +338,7 @@ Value Promise::perform_then(Value on_fulfilled, Value on_rejected, GCPtr<Promise
 
         // b. Append rejectReaction as the last element of the List that is promise.[[PromiseRejectReactions]].
         m_reject_reactions.append(reject_reaction);
+        write_barrier();
         break;
     // 10. Else if promise.[[PromiseState]] is fulfilled, then
     case Promise::State::Fulfilled: {
@@ -50,7 +50,11 @@ public:
     }
 
     HostDefined* host_defined() { return m_host_defined; }
-    void set_host_defined(OwnPtr<HostDefined> host_defined) { m_host_defined = move(host_defined); }
+    void set_host_defined(OwnPtr<HostDefined> host_defined)
+    {
+        m_host_defined = move(host_defined);
+        write_barrier();
+    }
 
     void define_builtin(Bytecode::Builtin builtin, Value value)
     {
@@ -69,6 +73,7 @@ private:
     Realm() = default;
 
     virtual void visit_edges(Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
     GCPtr<Intrinsics> m_intrinsics;                // [[Intrinsics]]
     GCPtr<Object> m_global_object;                 // [[GlobalObject]]
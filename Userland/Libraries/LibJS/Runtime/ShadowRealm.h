@@ -30,6 +30,9 @@ private:
 
     virtual void visit_edges(Visitor&) override;
 
+    // The execution context is written without write barriers.
+    virtual bool class_has_write_barriers() const override { return false; }
+
     // 3.5 Properties of ShadowRealm Instances, https://tc39.es/proposal-shadowrealm/#sec-properties-of-shadowrealm-instances
     NonnullGCPtr<Realm> m_shadow_realm;                  // [[ShadowRealm]]
     NonnullOwnPtr<ExecutionContext> m_execution_context; // [[ExecutionContext]]
@@ -92,6 +92,7 @@ Shape* Shape::create_put_transition(StringOrSymbol const& property_key, Property
     if (!m_forward_transitions)
         m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
     m_forward_transitions->set(key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
@@ -104,6 +105,7 @@ Shape* Shape::create_configure_transition(StringOrSymbol const& property_key, Pr
     if (!m_forward_transitions)
         m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
     m_forward_transitions->set(key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
@@ -248,6 +250,7 @@ NonnullGCPtr<Shape> Shape::create_delete_transition(StringOrSymbol const& proper
     if (!m_delete_transitions)
         m_delete_transitions = make<HashMap<StringOrSymbol, WeakPtr<Shape>>>();
     m_delete_transitions->set(property_key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
@@ -94,6 +94,7 @@ private:
     Shape(Shape& previous_shape, Object* new_prototype);
 
     virtual void visit_edges(Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
     Shape* get_or_prune_cached_forward_transition(TransitionKey const&);
     Shape* get_or_prune_cached_prototype_transition(Object* prototype);
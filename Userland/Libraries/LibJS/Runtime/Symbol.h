@@ -30,6 +30,9 @@ public:
 private:
     Symbol(Optional<String>, bool);
 
+    virtual bool class_has_write_barriers() const override { return true; }
+    virtual bool may_be_destroyed_lazily() const override { return true; }
+
     Optional<String> m_description;
     bool m_is_global;
 };
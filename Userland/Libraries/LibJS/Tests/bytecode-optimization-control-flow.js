@@ -0,0 +1,97 @@
+// These exercise the control flow shapes that the bytecode optimization passes rewrite.
+
+test("empty branches and loop bodies", () => {
+    let counter = 0;
+    for (let i = 0; i < 10; ++i) {
+        if (i % 2) {
+        } else {
+        }
+        counter++;
+    }
+    while (counter < 20) {
+        if (counter++ > 100) {
+        }
+    }
+    expect(counter).toBe(20);
+});
+
+test("chains of jumps through nested loops", () => {
+    let counter = 0;
+    outer: for (let i = 0; i < 3; ++i) {
+        for (let j = 0; j < 3; ++j) {
+            for (let k = 0; k < 3; ++k) {
+                if (k === 1) continue outer;
+                counter++;
+            }
+        }
+    }
+    expect(counter).toBe(3);
+});
+
+test("unreachable code after control transfer", () => {
+    function f(x) {
+        if (x) {
+            return 1;
+            x = 2;
+        } else {
+            throw new Error("two");
+            x = 3;
+        }
+        return x;
+    }
+    expect(f(true)).toBe(1);
+    expect(() => f(false)).toThrowWithMessage(Error, "two");
+});
+
+test("blocks with exception handlers are kept apart", () => {
+    function f() {
+        let log = [];
+        for (let i = 0; i < 3; ++i) {
+            try {
+                log.push("try" + i);
+                if (i === 1) throw i;
+            } catch (e) {
+                log.push("catch" + e);
+                continue;
+            } finally {
+                log.push("finally" + i);
+            }
+            log.push("after" + i);
+        }
+        return log.join(",");
+    }
+    expect(f()).toBe("try0,finally0,after0,try1,catch1,finally1,try2,finally2,after2");
+});
+
+test("completion values survive move elimination", () => {
+    expect(eval("let a = 1; let b = 2; a; b")).toBe(2);
+    expect(eval("1; if (true) { 2; } else { 3; }")).toBe(2);
+    expect(eval("4; do { 5; } while (false)")).toBe(5);
+});
+
+test("values passed through temporaries", () => {
+    function f(a, b, c) {
+        const x = a + b;
+        const y = x;
+        const z = y * c;
+        return [x, y, z, [a, b, c]];
+    }
+    expect(f(1, 2, 3)).toEqual([3, 3, 9, [1, 2, 3]]);
+});
+
+test("generators resume into the right blocks", () => {
+    function* g() {
+        for (let i = 0; i < 3; ++i) {
+            if (i === 1) {
+            }
+            yield i;
+        }
+        return 42;
+    }
+    expect([...g()]).toEqual([0, 1, 2]);
+    const it = g();
+    it.next();
+    it.next();
+    it.next();
+    expect(it.next()).toEqual({ value: 42, done: true });
+});
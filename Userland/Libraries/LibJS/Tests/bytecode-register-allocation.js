@@ -0,0 +1,79 @@
+// These exercise values that have to stay live across the control flow the register allocator must respect.
+
+test("temporaries live across loop back edges", () => {
+    function f(n) {
+        const values = [];
+        let previous = 0;
+        for (let i = 0; i < n; ++i) {
+            const current = previous + i;
+            values.push([previous, current, i * 2]);
+            previous = current;
+        }
+        return values;
+    }
+    expect(f(4)).toEqual([
+        [0, 0, 0],
+        [0, 1, 2],
+        [1, 3, 4],
+        [3, 6, 6],
+    ]);
+});
+
+test("argument windows stay intact", () => {
+    function sum(...args) {
+        return args.reduce((a, b) => a + b, 0);
+    }
+    function f(a, b) {
+        return sum(a, b, sum(a, a), sum(b, b, b), [a, b].length) + sum(...[a, b]);
+    }
+    expect(f(1, 2)).toBe(1 + 2 + 2 + 6 + 2 + 3);
+});
+
+test("values survive finally blocks and scheduled jumps", () => {
+    function f() {
+        const log = [];
+        for (let i = 0; i < 3; ++i) {
+            const outer = "o" + i;
+            try {
+                if (i === 1) continue;
+                if (i === 2) break;
+                log.push(outer);
+            } finally {
+                const inner = ["f", i].join("");
+                log.push(inner);
+            }
+            log.push(outer + "!");
+        }
+        return log;
+    }
+    expect(f()).toEqual(["o0", "f0", "o0!", "f1", "f2"]);
+});
+
+test("values survive exceptions thrown mid-block", () => {
+    function f(shouldThrow) {
+        const before = { value: 1 };
+        try {
+            const temporary = [before.value, 2];
+            if (shouldThrow) throw temporary;
+            return temporary.length;
+        } catch (e) {
+            return before.value + e[1];
+        }
+    }
+    expect(f(false)).toBe(2);
+    expect(f(true)).toBe(3);
+});
+
+test("values survive across yield", () => {
+    function* g(a) {
+        const x = a * 2;
+        const y = yield x;
+        const z = [x, y];
+        yield z;
+        return x + y;
+    }
+    const it = g(5);
+    expect(it.next().value).toBe(10);
+    expect(it.next(7).value).toEqual([10, 7]);
+    expect(it.next()).toEqual({ value: 17, done: true });
+});
@@ -0,0 +1,101 @@
+test("young cells only referenced from old cells survive allocation-driven collections", () => {
+    const old = { array: [], map: new Map(), object: {} };
+    const symbols = [];
+    gc();
+
+    for (let i = 0; i < 50_000; ++i) {
+        old.array.push({ i });
+        old.map.set(i, "v" + i);
+        const symbol = Symbol();
+        symbols.push(symbol);
+        old.object[symbol] = i;
+
+        // Churn through enough garbage to trigger collections on the way.
+        let garbage = [];
+        for (let j = 0; j < 4; ++j) garbage.push({ j });
+    }
+
+    for (let i = 0; i < 50_000; ++i) {
+        expect(old.array[i].i).toBe(i);
+        expect(old.map.get(i)).toBe("v" + i);
+        expect(old.object[symbols[i]]).toBe(i);
+    }
+});
+
+test("accessors redefined on old objects keep their new functions alive", () => {
+    const objects = [];
+    for (let i = 0; i < 100; ++i) {
+        const object = {};
+        Object.defineProperty(object, "value", { get: () => -1, configurable: true });
+        objects.push(object);
+    }
+    gc();
+
+    const makeGetter = value => () => value;
+    for (let i = 0; i < 100; ++i) {
+        Object.defineProperty(objects[i], "value", { get: makeGetter(i), configurable: true });
+        let garbage = [];
+        for (let j = 0; j < 1000; ++j) garbage.push({ j });
+    }
+
+    for (let i = 0; i < 100; ++i) expect(objects[i].value).toBe(i);
+});
+
+test("young cells stored into the bindings and private fields of old cells survive", () => {
+    class Holder {
+        #value;
+        set(value) {
+            this.#value = value;
+        }
+        get() {
+            return this.#value;
+        }
+    }
+
+    let binding = null;
+    const setBinding = value => {
+        binding = value;
+    };
+    const holders = [];
+    const weakMap = new WeakMap();
+    const promise = new Promise(() => {});
+    for (let i = 0; i < 100; ++i) holders.push(new Holder());
+    gc();
+
+    const results = [];
+    for (let i = 0; i < 100; ++i) {
+        holders[i].set({ i });
+        weakMap.set(holders[i], { i });
+        setBinding({ i });
+        promise.then(() => i);
+
+        let garbage = [];
+        for (let j = 0; j < 1000; ++j) garbage.push({ j });
+        results.push(binding);
+    }
+
+    for (let i = 0; i < 100; ++i) {
+        expect(holders[i].get().i).toBe(i);
+        expect(weakMap.get(holders[i]).i).toBe(i);
+        expect(results[i].i).toBe(i);
+    }
+});
+
+test("young cells a promise is settled with after it got old survive", () => {
+    const resolvers = [];
+    const promises = [];
+    for (let i = 0; i < 100; ++i) promises.push(new Promise(resolve => resolvers.push(resolve)));
+    gc();
+
+    for (let i = 0; i < 100; ++i) {
+        resolvers[i]({ i });
+        let garbage = [];
+        for (let j = 0; j < 1000; ++j) garbage.push({ j });
+    }
+
+    const results = [];
+    for (let i = 0; i < 100; ++i) promises[i].then(value => results.push(value.i));
+    runQueuedPromiseJobs();
+
+    for (let i = 0; i < 100; ++i) expect(results[i]).toBe(i);
+});
@@ -0,0 +1,113 @@
+// These run the same property access sites over objects of different shapes, so that they go through the inline caches.
+
+test("polymorphic gets", () => {
+    function getX(o) {
+        return o.x;
+    }
+    const objects = [{ x: 1 }, { a: 0, x: 2 }, { b: 0, c: 0, x: 3 }, { d: 0, e: 0, f: 0, x: 4 }, { g: 0, x: 5 }, { y: 6 }];
+    let sum = 0;
+    for (let i = 0; i < 5; ++i) {
+        for (const o of objects) sum += getX(o) ?? 0;
+    }
+    expect(sum).toBe(5 * (1 + 2 + 3 + 4 + 5));
+});
+
+test("polymorphic stores to existing properties", () => {
+    function setX(o, value) {
+        o.x = value;
+    }
+    const objects = [{ x: 0 }, { a: 0, x: 0 }, { b: 0, c: 0, x: 0 }];
+    for (let i = 0; i < 3; ++i) {
+        for (const o of objects) setX(o, i);
+    }
+    expect(objects.map(o => o.x)).toEqual([2, 2, 2]);
+    expect(Object.keys(objects[1])).toEqual(["a", "x"]);
+});
+
+test("stores that add properties in constructors", () => {
+    function Point(x, y) {
+        this.x = x;
+        this.y = y;
+    }
+    const points = [];
+    for (let i = 0; i < 5; ++i) points.push(new Point(i, i * 2));
+    expect(points.map(p => p.x + p.y)).toEqual([0, 3, 6, 9, 12]);
+    expect(Object.keys(points[4])).toEqual(["x", "y"]);
+    expect(Object.getOwnPropertyDescriptor(points[4], "y")).toEqual({
+        value: 8,
+        writable: true,
+        enumerable: true,
+        configurable: true,
+    });
+});
+
+test("adding a property respects setters added to the prototype later", () => {
+    function Thing(value) {
+        this.value = value;
+    }
+    const before = [new Thing(1), new Thing(2)];
+    let setterCalls = 0;
+    Object.defineProperty(Thing.prototype, "value", {
+        set(v) {
+            setterCalls++;
+        },
+        get() {
+            return "from setter";
+        },
+    });
+    const after = new Thing(3);
+    expect(before.map(t => t.value)).toEqual([1, 2]);
+    expect(after.value).toBe("from setter");
+    expect(setterCalls).toBe(1);
+    expect(Object.hasOwn(after, "value")).toBeFalse();
+});
+
+test("adding a property respects read-only properties further up the chain", () => {
+    function Thing(value) {
+        "use strict";
+        this.value = value;
+    }
+    new Thing(1);
+    new Thing(2);
+    Object.defineProperty(Object.prototype, "value", { value: 0, writable: false, configurable: true });
+    try {
+        expect(() => new Thing(3)).toThrow(TypeError);
+    } finally {
+        delete Object.prototype.value;
+    }
+    expect(new Thing(4).value).toBe(4);
+});
+
+test("adding a property respects non-extensible objects", () => {
+    function addY(o) {
+        "use strict";
+        o.y = 1;
+    }
+    addY({ x: 0 });
+    addY({ x: 0 });
+    const frozen = Object.preventExtensions({ x: 0 });
+    expect(() => addY(frozen)).toThrow(TypeError);
+    expect(Object.hasOwn(frozen, "y")).toBeFalse();
+});
+
+test("cached property additions survive the target shape being collected", () => {
+    function setZ(o) {
+        o.z = 3;
+    }
+    function make() {
+        const o = {};
+        o.q = 1;
+        return o;
+    }
+    // Cache the transition from {q} to {q, z}, then let every object with the {q, z} shape die.
+    for (let i = 0; i < 3; ++i) setZ(make());
+    gc();
+    const objects = [];
+    for (let i = 0; i < 3; ++i) {
+        const o = make();
+        setZ(o);
+        objects.push(o);
+    }
+    expect(objects.map(o => o.q + o.z)).toEqual([4, 4, 4]);
+    expect(Object.keys(objects[2])).toEqual(["q", "z"]);
+});
@@ -91,6 +91,7 @@ int main(int argc, char** argv)
         false;
 #endif
     bool print_json = false;
+    bool disable_bytecode_optimizations = false;
     bool per_file = false;
     StringView specified_test_root;
     ByteString common_path;
@@ -118,6 +119,7 @@ int main(int argc, char** argv)
     args_parser.add_option(per_file, "Show detailed per-file results as JSON (implies -j)", "per-file", 0);
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(disable_bytecode_optimizations, "Disable bytecode optimization passes", "disable-bytecode-optimizations", {});
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -125,6 +127,8 @@ int main(int argc, char** argv)
     args_parser.add_positional_argument(common_path, "Path to tests-common.js", "common-path", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    JS::Bytecode::g_optimizations_enabled = !disable_bytecode_optimizations;
+
     if (per_file)
         print_json = true;
 
@@ -29,7 +29,11 @@ public:
     virtual Optional<double> convert_a_timeline_time_to_an_origin_relative_time(Optional<double>) { VERIFY_NOT_REACHED(); }
     virtual bool can_convert_a_timeline_time_to_an_origin_relative_time() const { return false; }
 
-    void associate_with_animation(JS::NonnullGCPtr<Animation> value) { m_associated_animations.set(value); }
+    void associate_with_animation(JS::NonnullGCPtr<Animation> value)
+    {
+        m_associated_animations.set(value);
+        write_barrier();
+    }
     void disassociate_with_animation(JS::NonnullGCPtr<Animation> value) { m_associated_animations.remove(value); }
     HashTable<JS::NonnullGCPtr<Animation>> const& associated_animations() const { return m_associated_animations; }
 
@@ -721,6 +721,7 @@ WebIDL::ExceptionOr<Vector<JS::Object*>> KeyframeEffect::get_keyframes()
 
             m_keyframe_objects.append(object);
         }
+        write_barrier();
     }
 
     return m_keyframe_objects;
@@ -34,6 +34,7 @@ public:
             return *it->value;
 
         create_web_namespace<NamespaceType>(*m_realm);
+        write_barrier();
         return *m_namespaces.find(namespace_name)->value;
     }
 
@@ -44,6 +45,7 @@ public:
             return *it->value;
 
         create_web_prototype_and_constructor<PrototypeType>(*m_realm);
+        write_barrier();
         return *m_prototypes.find(class_name)->value;
     }
 
@@ -54,6 +56,7 @@ public:
             return *it->value;
 
         create_web_prototype_and_constructor<PrototypeType>(*m_realm);
+        write_barrier();
         return *m_constructors.find(class_name)->value;
     }
 
@@ -62,6 +65,9 @@ public:
 private:
     virtual void visit_edges(JS::Cell::Visitor&) override;
 
+    // The ensure_*() functions call write_barrier() after creating the objects they cache.
+    virtual bool class_has_write_barriers() const override { return true; }
+
     template<typename NamespaceType>
     void create_web_namespace(JS::Realm& realm);
 
@@ -92,6 +92,7 @@ WebIDL::ExceptionOr<unsigned> CSSRuleList::insert_a_css_rule(Variant<StringView,
 
     // 7. Insert new rule into list at the zero-indexed position index.
     m_rules.insert(index, *new_rule);
+    write_barrier();
 
     // 8. Return index.
     if (on_change)
@@ -204,6 +204,7 @@ bool PropertyOwningCSSStyleDeclaration::set_a_css_declaration(PropertyID propert
                 return false;
             property.value = move(value);
             property.important = important;
+            write_barrier();
             return true;
         }
     }
@@ -213,6 +214,7 @@ bool PropertyOwningCSSStyleDeclaration::set_a_css_declaration(PropertyID propert
         .property_id = property_id,
         .value = move(value),
     });
+    write_barrier();
     return true;
 }
 
@@ -454,6 +456,7 @@ void PropertyOwningCSSStyleDeclaration::set_the_declarations(Vector<StylePropert
 {
     m_properties = move(properties);
     m_custom_properties = move(custom_properties);
+    write_barrier();
 }
 
 // https://drafts.csswg.org/cssom/#dom-cssstyledeclaration-csstext
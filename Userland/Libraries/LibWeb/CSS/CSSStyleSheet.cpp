@@ -190,6 +190,7 @@ void CSSStyleSheet::recalculate_namespaces()
             m_default_namespace_rule = namespace_rule;
 
         m_namespace_rules.set(namespace_rule.prefix(), namespace_rule);
+        write_barrier();
     }
 }
 
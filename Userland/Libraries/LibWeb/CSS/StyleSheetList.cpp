@@ -37,6 +37,7 @@ void StyleSheetList::add_sheet(CSSStyleSheet& sheet)
         if (!did_insert)
             m_sheets.prepend(sheet);
     }
+    write_barrier();
 
     if (sheet.rules().length() == 0) {
         // NOTE: If the added sheet has no rules, we don't have to invalidate anything.
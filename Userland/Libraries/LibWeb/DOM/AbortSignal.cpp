@@ -39,6 +39,7 @@ void AbortSignal::add_abort_algorithm(Function<void()> abort_algorithm)
 
     // 2. Append algorithm to signal’s abort algorithms.
     m_abort_algorithms.append(JS::create_heap_function(vm().heap(), move(abort_algorithm)));
+    write_barrier();
 }
 
 // https://dom.spec.whatwg.org/#abortsignal-signal-abort
@@ -53,6 +54,7 @@ void AbortSignal::signal_abort(JS::Value reason)
         m_abort_reason = reason;
     else
         m_abort_reason = WebIDL::AbortError::create(realm(), "Aborted without reason"_fly_string).ptr();
+    write_barrier();
 
     // 3. For each algorithm in signal’s abort algorithms: run algorithm.
     for (auto& algorithm : m_abort_algorithms)
@@ -55,6 +55,7 @@ void CustomEvent::init_custom_event(String const& type, bool bubbles, bool cance
 
     // 3. Set this’s detail attribute to detail.
     m_detail = detail;
+    write_barrier();
 }
 
 }
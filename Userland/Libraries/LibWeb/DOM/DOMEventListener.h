@@ -46,6 +46,7 @@ public:
 
 private:
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 };
 
 }
@@ -1577,6 +1577,7 @@ JS::NonnullGCPtr<HTML::HTMLScriptElement> Document::take_pending_parsing_blockin
 void Document::add_script_to_execute_when_parsing_has_finished(Badge<HTML::HTMLScriptElement>, HTML::HTMLScriptElement& script)
 {
     m_scripts_to_execute_when_parsing_has_finished.append(script);
+    write_barrier();
 }
 
 Vector<JS::Handle<HTML::HTMLScriptElement>> Document::take_scripts_to_execute_when_parsing_has_finished(Badge<HTML::HTMLParser>)
@@ -1591,6 +1592,7 @@ Vector<JS::Handle<HTML::HTMLScriptElement>> Document::take_scripts_to_execute_wh
 void Document::add_script_to_execute_as_soon_as_possible(Badge<HTML::HTMLScriptElement>, HTML::HTMLScriptElement& script)
 {
     m_scripts_to_execute_as_soon_as_possible.append(script);
+    write_barrier();
 }
 
 Vector<JS::Handle<HTML::HTMLScriptElement>> Document::take_scripts_to_execute_as_soon_as_possible(Badge<HTML::HTMLParser>)
@@ -1605,6 +1607,7 @@ Vector<JS::Handle<HTML::HTMLScriptElement>> Document::take_scripts_to_execute_as
 void Document::add_script_to_execute_in_order_as_soon_as_possible(Badge<HTML::HTMLScriptElement>, HTML::HTMLScriptElement& script)
 {
     m_scripts_to_execute_in_order_as_soon_as_possible.append(script);
+    write_barrier();
 }
 
 Vector<JS::Handle<HTML::HTMLScriptElement>> Document::take_scripts_to_execute_in_order_as_soon_as_possible(Badge<HTML::HTMLParser>)
@@ -1688,6 +1691,7 @@ void Document::adopt_node(Node& node)
             old_document.m_node_iterators.remove(&node_iterator);
             m_node_iterators.set(&node_iterator);
         }
+        write_barrier();
     }
 }
 
@@ -2401,6 +2405,7 @@ JS::NonnullGCPtr<TreeWalker> Document::create_tree_walker(Node& root, unsigned w
 void Document::register_node_iterator(Badge<NodeIterator>, NodeIterator& node_iterator)
 {
     auto result = m_node_iterators.set(&node_iterator);
+    write_barrier();
     VERIFY(result == AK::HashSetResult::InsertedNewEntry);
 }
 
@@ -2413,6 +2418,7 @@ void Document::unregister_node_iterator(Badge<NodeIterator>, NodeIterator& node_
 void Document::register_document_observer(Badge<DocumentObserver>, DocumentObserver& document_observer)
 {
     auto result = m_document_observers.set(document_observer);
+    write_barrier();
     VERIFY(result == AK::HashSetResult::InsertedNewEntry);
 }
 
@@ -2857,6 +2863,7 @@ JS::GCPtr<HTML::HTMLParser> Document::active_parser()
 void Document::set_browsing_context(HTML::BrowsingContext* browsing_context)
 {
     m_browsing_context = browsing_context;
+    write_barrier();
 }
 
 // https://html.spec.whatwg.org/multipage/document-lifecycle.html#unload-a-document
@@ -3134,6 +3141,7 @@ void Document::inform_all_viewport_clients_about_the_current_viewport_rect()
 void Document::register_intersection_observer(Badge<IntersectionObserver::IntersectionObserver>, IntersectionObserver::IntersectionObserver& observer)
 {
     auto result = m_intersection_observers.set(observer);
+    write_barrier();
     VERIFY(result == AK::HashSetResult::InsertedNewEntry);
 }
 
@@ -3702,6 +3710,7 @@ JS::NonnullGCPtr<Animations::DocumentTimeline> Document::timeline()
 void Document::associate_with_timeline(JS::NonnullGCPtr<Animations::AnimationTimeline> timeline)
 {
     m_associated_animation_timelines.set(timeline);
+    write_barrier();
 }
 
 void Document::disassociate_with_timeline(JS::NonnullGCPtr<Animations::AnimationTimeline> timeline)
@@ -3729,6 +3738,7 @@ void Document::element_with_id_was_added_or_removed(Badge<DOM::Element>)
 void Document::add_form_associated_element_with_form_attribute(HTML::FormAssociatedElement& form_associated_element)
 {
     m_form_associated_elements_with_form_attribute.append(&form_associated_element);
+    write_barrier();
 }
 
 void Document::remove_form_associated_element_with_form_attribute(HTML::FormAssociatedElement& form_associated_element)
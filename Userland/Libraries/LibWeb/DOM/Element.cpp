@@ -1059,6 +1059,7 @@ void Element::set_pseudo_element_node(Badge<Layout::TreeBuilder>, CSS::Selector:
     }
 
     (*m_pseudo_element_nodes)[to_underlying(pseudo_element)] = pseudo_element_node;
+    write_barrier();
 }
 
 JS::GCPtr<Layout::Node> Element::get_pseudo_element_node(CSS::Selector::PseudoElement::Type pseudo_element) const
@@ -2161,6 +2162,7 @@ void Element::register_intersection_observer(Badge<IntersectionObserver::Interse
     if (!m_registered_intersection_observers)
         m_registered_intersection_observers = make<Vector<IntersectionObserver::IntersectionObserverRegistration>>();
     m_registered_intersection_observers->append(move(registration));
+    write_barrier();
 }
 
 void Element::unregister_intersection_observer(Badge<IntersectionObserver::IntersectionObserver>, JS::NonnullGCPtr<IntersectionObserver::IntersectionObserver> observer)
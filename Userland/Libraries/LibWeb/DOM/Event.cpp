@@ -91,6 +91,7 @@ void Event::append_to_path(EventTarget& invocation_target, JS::GCPtr<EventTarget
     // shadow-adjusted target is shadowAdjustedTarget, relatedTarget is relatedTarget, touch target list is touchTargets, root-of-closed-tree is root-of-closed-tree,
     // and slot-in-closed-tree is slot-in-closed-tree.
     m_path.append({ invocation_target, invocation_target_in_shadow_tree, shadow_adjusted_target, related_target, touch_targets, root_of_closed_tree, slot_in_closed_tree, m_path.size() });
+    write_barrier();
 }
 
 void Event::set_cancelled_flag()
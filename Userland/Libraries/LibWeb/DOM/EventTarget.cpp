@@ -191,8 +191,10 @@ void EventTarget::add_an_event_listener(DOMEventListener& listener)
             && entry->callback->callback().callback == listener.callback->callback().callback
             && entry->capture == listener.capture;
     });
-    if (it == event_listener_list.end())
+    if (it == event_listener_list.end()) {
         event_listener_list.append(listener);
+        write_barrier();
+    }
 
     // 5. If listener’s signal is not null, then add the following abort steps to it:
     if (listener.signal) {
@@ -497,6 +499,7 @@ WebIDL::CallbackType* EventTarget::get_current_value_of_event_handler(FlyString
 
         // 12. Set eventHandler's value to the result of creating a Web IDL EventHandler callback function object whose object reference is function and whose callback context is settings object.
         event_handler->value = JS::GCPtr(realm.heap().allocate_without_realm<WebIDL::CallbackType>(*function, settings_object));
+        event_handler->write_barrier();
     }
 
     // 4. Return eventHandler's value.
@@ -539,12 +542,14 @@ void EventTarget::set_event_handler_attribute(FlyString const& name, WebIDL::Cal
         event_target->activate_event_handler(name, *new_event_handler);
 
         handler_map.set(name, new_event_handler);
+        event_target->write_barrier();
         return;
     }
 
     auto& event_handler = event_handler_iterator->value;
 
     event_handler->value = JS::GCPtr(value);
+    event_handler->write_barrier();
 
     //  4. Activate an event handler given eventTarget and name.
     //  NOTE: See the optimization comment above.
@@ -753,6 +758,7 @@ void EventTarget::element_event_handler_attribute_changed(FlyString const& local
         event_target->activate_event_handler(local_name, *new_event_handler);
 
         handler_map.set(local_name, new_event_handler);
+        event_target->write_barrier();
         return;
     }
 
@@ -47,6 +47,7 @@ public:
     void enqueue_record(Badge<Node>, JS::NonnullGCPtr<MutationRecord> mutation_record)
     {
         m_record_queue.append(*mutation_record);
+        write_barrier();
     }
 
 private:
@@ -84,6 +85,7 @@ protected:
     RegisteredObserver(MutationObserver& observer, MutationObserverInit const& options);
 
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
 private:
     JS::NonnullGCPtr<MutationObserver> m_observer;
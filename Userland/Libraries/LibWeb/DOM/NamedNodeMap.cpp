@@ -238,6 +238,7 @@ void NamedNodeMap::replace_attribute(Attr& old_attribute, Attr& new_attribute, s
     // 1. Replace oldAttr by newAttr in oldAttr’s element’s attribute list.
     m_attributes.remove(old_attribute_index);
     m_attributes.insert(old_attribute_index, new_attribute);
+    write_barrier();
 
     // 2. Set newAttr’s element to oldAttr’s element.
     new_attribute.set_owner_element(old_attribute.owner_element());
@@ -254,6 +255,7 @@ void NamedNodeMap::append_attribute(Attr& attribute)
 {
     // 1. Append attribute to element’s attribute list.
     m_attributes.append(attribute);
+    write_barrier();
 
     // 2. Set attribute’s element to element.
     attribute.set_owner_element(&associated_element());
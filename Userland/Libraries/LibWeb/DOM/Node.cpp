@@ -2004,6 +2004,7 @@ void Node::add_registered_observer(RegisteredObserver& registered_observer)
     if (!m_registered_observer_list)
         m_registered_observer_list = make<Vector<JS::NonnullGCPtr<RegisteredObserver>>>();
     m_registered_observer_list->append(registered_observer);
+    write_barrier();
 }
 
 }
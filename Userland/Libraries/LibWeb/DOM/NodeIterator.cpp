@@ -78,6 +78,7 @@ JS::ThrowCompletionOr<JS::GCPtr<Node>> NodeIterator::traverse(Direction directio
     // 1. Let node be iterator’s reference.
     // 2. Let beforeNode be iterator’s pointer before reference.
     m_traversal_pointer = m_reference;
+    write_barrier();
 
     JS::GCPtr<Node> candidate;
 
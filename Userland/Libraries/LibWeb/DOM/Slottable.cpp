@@ -171,6 +171,7 @@ void assign_slottables(JS::NonnullGCPtr<HTML::HTMLSlotElement> slot)
     // 3. Set slot’s assigned nodes to slottables.
     // NOTE: We do this step last so that we can move the slottables list.
     slot->set_assigned_nodes(move(slottables));
+    slot->write_barrier();
 }
 
 // https://dom.spec.whatwg.org/#assign-slotables-for-a-tree
@@ -155,6 +155,7 @@ private:
     explicit BrowsingContext(JS::NonnullGCPtr<Page>);
 
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
     void reset_cursor_blink_cycle();
 
@@ -47,6 +47,9 @@ class CustomElementDefinition : public JS::Cell {
     bool disable_internals() const { return m_disable_internals; }
     bool disable_shadow() const { return m_disable_shadow; }
 
+    // All references are kept in Handles, so there's nothing for the write barrier to see.
+    virtual bool class_has_write_barriers() const override { return true; }
+
 private:
     CustomElementDefinition(String const& name, String const& local_name, WebIDL::CallbackType& constructor, Vector<String>&& observed_attributes, LifecycleCallbacksStorage&& lifecycle_callbacks, bool form_associated, bool disable_internals, bool disable_shadow)
         : m_name(name)
@@ -29,6 +29,9 @@ public:
     virtual Optional<CSSPixels> intrinsic_height() const = 0;
     virtual Optional<CSSPixelFraction> intrinsic_aspect_ratio() const = 0;
 
+    // Subclasses only keep references in GCPtr members.
+    virtual bool class_has_write_barriers() const override { return true; }
+
 protected:
     DecodedImageData();
 };
@@ -34,6 +34,9 @@ public:
 
 private:
     virtual void visit_edges(Cell::Visitor&) override;
+
+    // Stores into the value variant call write_barrier() themselves.
+    virtual bool class_has_write_barriers() const override { return true; }
 };
 
 }
@@ -232,6 +232,15 @@ void EventLoop::process()
         //    perform the start an idle period algorithm for win with computeDeadline. [REQUESTIDLECALLBACK]
         for (auto& win : same_loop_windows())
             win->start_an_idle_period();
+
+        // NOTE: Spend a slice of the idle period marking the JS heap, so the next full garbage collection has less left to do
+        //       in its pause. Whatever marking is left over continues in the next idle period, or in the next collection.
+        auto idle_milliseconds_left = compute_deadline() - HighResolutionTime::unsafe_shared_current_time();
+        if (idle_milliseconds_left > 0) {
+            static constexpr auto max_incremental_marking_budget = Duration::from_milliseconds(5);
+            auto budget = min(Duration::from_microseconds(static_cast<i64>(idle_milliseconds_left * 1000)), max_incremental_marking_budget);
+            vm().heap().perform_incremental_marking_step(budget);
+        }
     }
 
     // FIXME: 14. If this is a worker event loop, then:
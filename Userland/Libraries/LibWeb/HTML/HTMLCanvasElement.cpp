@@ -138,6 +138,7 @@ HTMLCanvasElement::HasOrCreatedContext HTMLCanvasElement::create_2d_context()
         return m_context.has<JS::NonnullGCPtr<CanvasRenderingContext2D>>() ? HasOrCreatedContext::Yes : HasOrCreatedContext::No;
 
     m_context = CanvasRenderingContext2D::create(realm(), *this);
+    write_barrier();
     return HasOrCreatedContext::Yes;
 }
 
@@ -151,6 +152,7 @@ JS::ThrowCompletionOr<HTMLCanvasElement::HasOrCreatedContext> HTMLCanvasElement:
         return HasOrCreatedContext::No;
 
     m_context = JS::NonnullGCPtr<WebGL::WebGLRenderingContext>(*maybe_context);
+    write_barrier();
     return HasOrCreatedContext::Yes;
 }
 
@@ -339,6 +339,7 @@ void HTMLFormElement::reset()
 void HTMLFormElement::add_associated_element(Badge<FormAssociatedElement>, HTMLElement& element)
 {
     m_associated_elements.append(element);
+    write_barrier();
 }
 
 void HTMLFormElement::remove_associated_element(Badge<FormAssociatedElement>, HTMLElement& element)
@@ -456,6 +456,7 @@ void HTMLScriptElement::prepare_script()
             // 1. Let scripts be el's preparation-time document's set of scripts that will execute as soon as possible.
             // 2. Append el to scripts.
             m_preparation_time_document->scripts_to_execute_as_soon_as_possible().append(*this);
+            m_preparation_time_document->write_barrier();
 
             // 3. Set el's steps to run when the result is ready to the following:
             m_steps_to_run_when_the_result_is_ready = [this] {
@@ -474,6 +475,7 @@ void HTMLScriptElement::prepare_script()
             // 1. Let scripts be el's preparation-time document's list of scripts that will execute in order as soon as possible.
             // 2. Append el to scripts.
             m_preparation_time_document->scripts_to_execute_in_order_as_soon_as_possible().append(*this);
+            m_preparation_time_document->write_barrier();
 
             // 3. Set el's steps to run when the result is ready to the following:
             m_steps_to_run_when_the_result_is_ready = [this] {
@@ -565,6 +567,7 @@ void HTMLScriptElement::mark_as_ready(Result result)
 {
     // 1. Set el's result to result.
     m_result = move(result);
+    write_barrier();
 
     // 2. If el's steps to run when the result is ready are not null, then run them.
     if (m_steps_to_run_when_the_result_is_ready)
@@ -110,6 +110,7 @@ void HTMLSlotElement::assign(Vector<SlottableHandle> nodes)
 
     // 4. Set this's manually assigned nodes to nodesSet.
     m_manually_assigned_nodes = move(nodes_set);
+    write_barrier();
 
     // 5. Run assign slottables for a tree for this's root.
     assign_slottables_for_a_tree(root());
@@ -33,7 +33,11 @@ public:
     u64 m_index { 0 };
     u64 m_length { 0 };
 
-    void set_state(JS::Value s) { m_state = s; }
+    void set_state(JS::Value s)
+    {
+        m_state = s;
+        write_barrier();
+    }
 
 private:
     History(JS::Realm&, DOM::Document&);
@@ -61,6 +61,7 @@ public:
     SharedImageRequest const* shared_image_request() const { return m_shared_image_request; }
 
     virtual void visit_edges(JS::Cell::Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
 private:
     explicit ImageRequest(JS::NonnullGCPtr<Page>);
@@ -1944,6 +1944,7 @@ void Navigable::scroll_offset_did_change()
 
     // 3. Append doc to doc’s pending scroll event targets.
     doc->pending_scroll_event_targets().append(*doc);
+    doc->write_barrier();
 }
 
 CSSPixelRect Navigable::to_top_level_rect(CSSPixelRect const& a_rect)
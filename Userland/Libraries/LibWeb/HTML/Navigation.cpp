@@ -595,6 +595,7 @@ JS::NonnullGCPtr<NavigationAPIMethodTracker> Navigation::add_an_upcoming_travers
     // 4. Set navigation's upcoming traverse API method trackers[key] to apiMethodTracker.
     // FIXME: Fix spec typo key --> destinationKey
     m_upcoming_traverse_api_method_trackers.set(destination_key, api_method_tracker);
+    write_barrier();
 
     // 5. Return apiMethodTracker.
     return api_method_tracker;
@@ -1376,6 +1377,7 @@ void Navigation::initialize_the_navigation_api_entries_for_a_new_document(Vector
         // 3. Append newNHE to navigation's entry list.
         m_entry_list.append(new_nhe);
     }
+    write_barrier();
 
     // 5. Set navigation's current entry index to the result of getting the navigation API entry index of initialSHE within navigation.
     m_current_entry_index = get_the_navigation_api_entry_index(*initial_she);
@@ -1452,6 +1454,7 @@ void Navigation::update_the_navigation_api_entries_for_a_same_document_navigatio
             VERIFY(m_current_entry_index == static_cast<i64>(m_entry_list.size()));
             m_entry_list.append(new_nhe);
         }
+        write_barrier();
     }
 
     // 8. If navigation's ongoing API method tracker is non-null, then notify about the committed-to entry
@@ -30,6 +30,7 @@ JS::NonnullGCPtr<SharedImageRequest> SharedImageRequest::get_or_create(JS::Realm
         return *it->value;
     auto request = realm.heap().allocate<SharedImageRequest>(realm, page, url, *document);
     shared_image_requests.set(url, request);
+    document->write_barrier();
     return request;
 }
 
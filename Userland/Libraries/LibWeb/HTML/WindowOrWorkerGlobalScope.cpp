@@ -311,6 +311,7 @@ i32 WindowOrWorkerGlobalScopeMixin::run_timer_initialization_steps(TimerHandler
     // 12. Run steps after a timeout given global, "setTimeout/setInterval", timeout, completionStep, and id.
     auto timer = Timer::create(this_impl(), timeout, move(completion_step), id);
     m_timers.set(id, timer);
+    this_impl().write_barrier();
     timer->start();
 
     // 13. Return id.
@@ -378,8 +379,10 @@ void WindowOrWorkerGlobalScopeMixin::queue_performance_entry(JS::NonnullGCPtr<Pe
     auto should_add = new_entry->should_add_entry();
 
     // 9. If isBufferFull is false and shouldAdd is true, append newEntry to tuple's performance entry buffer.
-    if (!is_buffer_full && should_add == PerformanceTimeline::ShouldAddEntry::Yes)
+    if (!is_buffer_full && should_add == PerformanceTimeline::ShouldAddEntry::Yes) {
         tuple.performance_entry_buffer.append(new_entry);
+        this_impl().write_barrier();
+    }
 
     // 10. Queue the PerformanceObserver task with relevantGlobal as input.
     queue_the_performance_observer_task();
@@ -450,6 +453,7 @@ ErrorOr<Vector<JS::Handle<PerformanceTimeline::PerformanceEntry>>> WindowOrWorke
 void WindowOrWorkerGlobalScopeMixin::register_performance_observer(Badge<PerformanceTimeline::PerformanceObserver>, JS::NonnullGCPtr<PerformanceTimeline::PerformanceObserver> observer)
 {
     m_registered_performance_observer_objects.set(observer, AK::HashSetExistingEntryBehavior::Keep);
+    this_impl().write_barrier();
 }
 
 void WindowOrWorkerGlobalScopeMixin::unregister_performance_observer(Badge<PerformanceTimeline::PerformanceObserver>, JS::NonnullGCPtr<PerformanceTimeline::PerformanceObserver> observer)
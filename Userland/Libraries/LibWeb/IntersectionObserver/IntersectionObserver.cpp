@@ -105,6 +105,7 @@ void IntersectionObserver::observe(DOM::Element& target)
 
     // 4. Add target to observer’s internal [[ObservationTargets]] slot.
     m_observation_targets.append(target);
+    write_barrier();
 }
 
 // https://w3c.github.io/IntersectionObserver/#dom-intersectionobserver-unobserve
@@ -208,6 +209,7 @@ CSSPixelRect IntersectionObserver::root_intersection_rectangle() const
 void IntersectionObserver::queue_entry(Badge<DOM::Document>, JS::NonnullGCPtr<IntersectionObserverEntry> entry)
 {
     m_queued_entries.append(entry);
+    write_barrier();
 }
 
 }
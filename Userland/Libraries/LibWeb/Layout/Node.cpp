@@ -635,6 +635,7 @@ void NodeWithStyle::apply_style(const CSS::StyleProperties& computed_style)
     if (list_style_image->is_abstract_image()) {
         m_list_style_image = list_style_image->as_abstract_image();
         const_cast<CSS::AbstractImageStyleValue&>(*m_list_style_image).load_any_resources(document());
+        write_barrier();
     }
 
     if (auto list_style_position = computed_style.list_style_position(); list_style_position.has_value())
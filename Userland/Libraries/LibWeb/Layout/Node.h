@@ -172,6 +172,9 @@ public:
     u32 initial_quote_nesting_level() const { return m_initial_quote_nesting_level; }
     void set_initial_quote_nesting_level(u32 value) { m_initial_quote_nesting_level = value; }
 
+    // The tree links are GCPtrs, and the rest of the references call write_barrier() after they're stored.
+    virtual bool class_has_write_barriers() const override { return true; }
+
 protected:
     Node(DOM::Document&, DOM::Node*);
 
@@ -165,6 +165,7 @@ public:
 private:
     explicit Page(JS::NonnullGCPtr<PageClient>);
     virtual void visit_edges(Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 
     JS::GCPtr<HTML::HTMLMediaElement> media_context_menu_element();
 
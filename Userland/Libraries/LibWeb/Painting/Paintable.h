@@ -183,8 +183,10 @@ public:
 
     Layout::Box const* containing_block() const
     {
-        if (!m_containing_block.has_value())
+        if (!m_containing_block.has_value()) {
             m_containing_block = m_layout_node->containing_block();
+            const_cast<Paintable&>(*this).write_barrier();
+        }
         return *m_containing_block;
     }
 
@@ -200,6 +202,9 @@ public:
 
     CSSPixelPoint box_type_agnostic_position() const;
 
+    // The tree links are GCPtrs, and the rest of the references call write_barrier() after they're stored.
+    virtual bool class_has_write_barriers() const override { return true; }
+
 protected:
     explicit Paintable(Layout::Node const&);
 
@@ -271,9 +271,14 @@ public:
     void add_fragment(Layout::LineBoxFragment const& fragment)
     {
         m_fragments.append(PaintableFragment { fragment });
+        write_barrier();
     }
 
-    void set_fragments(Vector<PaintableFragment>&& fragments) { m_fragments = move(fragments); }
+    void set_fragments(Vector<PaintableFragment>&& fragments)
+    {
+        m_fragments = move(fragments);
+        write_barrier();
+    }
 
     template<typename Callback>
     void for_each_fragment(Callback callback) const
@@ -183,6 +183,7 @@ WebIDL::ExceptionOr<void> PerformanceObserver::observe(PerformanceObserverInit&
                 if (entry->should_add_entry(options) == ShouldAddEntry::Yes)
                     m_observer_buffer.append(*entry);
             }
+            write_barrier();
 
             // 3. Queue the PerformanceObserver task with relevantGlobal as input.
             relevant_global->queue_the_performance_observer_task();
@@ -226,6 +227,7 @@ void PerformanceObserver::unset_requires_dropped_entries(Badge<HTML::WindowOrWor
 void PerformanceObserver::append_to_observer_buffer(Badge<HTML::WindowOrWorkerGlobalScopeMixin>, JS::NonnullGCPtr<PerformanceTimeline::PerformanceEntry> entry)
 {
     m_observer_buffer.append(entry);
+    write_barrier();
 }
 
 }
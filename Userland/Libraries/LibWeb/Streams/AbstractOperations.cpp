@@ -1300,7 +1300,9 @@ void readable_stream_add_read_request(ReadableStream& stream, JS::NonnullGCPtr<R
     VERIFY(stream.state() == ReadableStream::State::Readable);
 
     // 3. Append readRequest to stream.[[reader]].[[readRequests]].
-    stream.reader()->get<JS::NonnullGCPtr<ReadableStreamDefaultReader>>()->read_requests().append(read_request);
+    auto reader = stream.reader()->get<JS::NonnullGCPtr<ReadableStreamDefaultReader>>();
+    reader->read_requests().append(read_request);
+    reader->write_barrier();
 }
 
 // https://streams.spec.whatwg.org/#readable-stream-add-read-into-request
@@ -1313,7 +1315,9 @@ void readable_stream_add_read_into_request(ReadableStream& stream, JS::NonnullGC
     VERIFY(stream.is_readable() || stream.is_closed());
 
     // 3. Append readRequest to stream.[[reader]].[[readIntoRequests]].
-    stream.reader()->get<JS::NonnullGCPtr<ReadableStreamBYOBReader>>()->read_into_requests().append(read_into_request);
+    auto reader = stream.reader()->get<JS::NonnullGCPtr<ReadableStreamBYOBReader>>();
+    reader->read_into_requests().append(read_into_request);
+    reader->write_barrier();
 }
 
 // https://streams.spec.whatwg.org/#readable-stream-reader-generic-cancel
@@ -1671,6 +1675,7 @@ void readable_byte_stream_controller_pull_into(ReadableByteStreamController& con
     if (!controller.pending_pull_intos().is_empty()) {
         // 1. Append pullIntoDescriptor to controller.[[pendingPullIntos]].
         controller.pending_pull_intos().append(pull_into_descriptor);
+        controller.write_barrier();
 
         // 2. Perform ! ReadableStreamAddReadIntoRequest(stream, readIntoRequest).
         readable_stream_add_read_into_request(*stream, read_into_request);
@@ -1726,6 +1731,7 @@ void readable_byte_stream_controller_pull_into(ReadableByteStreamController& con
 
     // 14. Append pullIntoDescriptor to controller.[[pendingPullIntos]].
     controller.pending_pull_intos().append(pull_into_descriptor);
+    controller.write_barrier();
 
     // 15. Perform ! ReadableStreamAddReadIntoRequest(stream, readIntoRequest).
     readable_stream_add_read_into_request(*stream, read_into_request);
@@ -2197,6 +2203,7 @@ WebIDL::ExceptionOr<void> readable_byte_stream_controller_respond(ReadableByteSt
 
     // 6. Set firstDescriptor’s buffer to ! TransferArrayBuffer(firstDescriptor’s buffer).
     first_descriptor.buffer = MUST(transfer_array_buffer(realm, *first_descriptor.buffer));
+    controller.write_barrier();
 
     // 7. Perform ? ReadableByteStreamControllerRespondInternal(controller, bytesWritten).
     return readable_byte_stream_controller_respond_internal(controller, bytes_written);
@@ -2250,6 +2257,7 @@ WebIDL::ExceptionOr<void> readable_byte_stream_controller_respond_with_new_view(
 
     // 11. Set firstDescriptor’s buffer to ? TransferArrayBuffer(view.[[ViewedArrayBuffer]]).
     first_descriptor.buffer = TRY(transfer_array_buffer(realm, *view.viewed_array_buffer()));
+    controller.write_barrier();
 
     // 12. Perform ? ReadableByteStreamControllerRespondInternal(controller, viewByteLength).
     TRY(readable_byte_stream_controller_respond_internal(controller, view_byte_length));
@@ -3078,6 +3086,7 @@ WebIDL::ExceptionOr<void> readable_byte_stream_controller_enqueue(ReadableByteSt
 
         // 4. Set firstPendingPullInto’s buffer to ! TransferArrayBuffer(firstPendingPullInto’s buffer).
         first_pending_pull_into.buffer = TRY(transfer_array_buffer(realm, first_pending_pull_into.buffer));
+        controller.write_barrier();
 
         // 5. If firstPendingPullInto’s reader type is "none", perform ? ReadableByteStreamControllerEnqueueDetachedPullIntoToQueue(controller, firstPendingPullInto).
         if (first_pending_pull_into.reader_type == ReaderType::None)
@@ -3279,6 +3288,7 @@ void readable_byte_stream_controller_enqueue_chunk_to_queue(ReadableByteStreamCo
         .byte_offset = byte_offset,
         .byte_length = byte_length,
     });
+    controller.write_barrier();
 
     // 2. Set controller.[[queueTotalSize]] to controller.[[queueTotalSize]] + byteLength.
     controller.set_queue_total_size(controller.queue_total_size() + byte_length);
@@ -3483,6 +3493,7 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<WebIDL::Promise>> writable_stream_add_write
 
     // 4. Append promise to stream.[[writeRequests]].
     TRY_OR_THROW_OOM(vm, stream.write_requests().try_append(promise));
+    stream.write_barrier();
 
     // 5. Return promise.
     return promise;
@@ -235,6 +235,7 @@ WebIDL::ExceptionOr<void> enqueue_value_with_size(T& container, JS::Value value,
 
     // 4. Append a new value-with-size with value value and size size to container.[[queue]].
     container.queue().append({ value, size });
+    container.write_barrier();
 
     // 5. Set container.[[queueTotalSize]] to container.[[queueTotalSize]] + size.
     container.set_queue_total_size(container.queue_total_size() + size);
@@ -65,13 +65,25 @@ public:
     WebIDL::ExceptionOr<ReadableStreamPair> tee();
 
     Optional<ReadableStreamController>& controller() { return m_controller; }
-    void set_controller(Optional<ReadableStreamController> value) { m_controller = move(value); }
+    void set_controller(Optional<ReadableStreamController> value)
+    {
+        m_controller = move(value);
+        write_barrier();
+    }
 
     JS::Value stored_error() const { return m_stored_error; }
-    void set_stored_error(JS::Value value) { m_stored_error = value; }
+    void set_stored_error(JS::Value value)
+    {
+        m_stored_error = value;
+        write_barrier();
+    }
 
     Optional<ReadableStreamReader> const& reader() const { return m_reader; }
-    void set_reader(Optional<ReadableStreamReader> value) { m_reader = move(value); }
+    void set_reader(Optional<ReadableStreamReader> value)
+    {
+        m_reader = move(value);
+        write_barrier();
+    }
 
     bool is_disturbed() const;
     void set_disturbed(bool value) { m_disturbed = value; }
@@ -71,13 +71,21 @@ public:
     void set_in_flight_close_request(JS::GCPtr<WebIDL::Promise> value) { m_in_flight_close_request = value; }
 
     Optional<PendingAbortRequest>& pending_abort_request() { return m_pending_abort_request; }
-    void set_pending_abort_request(Optional<PendingAbortRequest>&& value) { m_pending_abort_request = move(value); }
+    void set_pending_abort_request(Optional<PendingAbortRequest>&& value)
+    {
+        m_pending_abort_request = move(value);
+        write_barrier();
+    }
 
     State state() const { return m_state; }
     void set_state(State value) { m_state = value; }
 
     JS::Value stored_error() const { return m_stored_error; }
-    void set_stored_error(JS::Value value) { m_stored_error = value; }
+    void set_stored_error(JS::Value value)
+    {
+        m_stored_error = value;
+        write_barrier();
+    }
 
     JS::GCPtr<WritableStreamDefaultWriter const> writer() const { return m_writer; }
     JS::GCPtr<WritableStreamDefaultWriter> writer() { return m_writer; }
@@ -338,11 +338,11 @@ protected:
     }
 
 private:
-    T* m_parent { nullptr };
-    T* m_first_child { nullptr };
-    T* m_last_child { nullptr };
-    T* m_next_sibling { nullptr };
-    T* m_previous_sibling { nullptr };
+    JS::GCPtr<T> m_parent;
+    JS::GCPtr<T> m_first_child;
+    JS::GCPtr<T> m_last_child;
+    JS::GCPtr<T> m_next_sibling;
+    JS::GCPtr<T> m_previous_sibling;
 };
 
 template<typename T>
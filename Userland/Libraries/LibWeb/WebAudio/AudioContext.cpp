@@ -127,6 +127,7 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<JS::Promise>> AudioContext::resume()
     if (m_allowed_to_start) {
         TRY_OR_THROW_OOM(vm, m_pending_promises.try_append(promise));
         TRY_OR_THROW_OOM(vm, m_pending_resume_promises.try_append(promise));
+        write_barrier();
     }
 
     // 6. Set the [[control thread state]] on the AudioContext to running.
@@ -204,6 +205,7 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<JS::Promise>> AudioContext::suspend()
 
     // 4. Append promise to [[pending promises]].
     TRY_OR_THROW_OOM(vm, m_pending_promises.try_append(promise));
+    write_barrier();
 
     // 5. Set [[suspended by user]] to true.
     m_suspended_by_user = true;
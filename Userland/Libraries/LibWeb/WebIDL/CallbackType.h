@@ -36,6 +36,7 @@ public:
 
 private:
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual bool class_has_write_barriers() const override { return true; }
 };
 
 }
@@ -211,6 +211,7 @@ WebIDL::ExceptionOr<JS::Value> XMLHttpRequest::response()
         auto buffer = buffer_result.release_value();
         buffer->buffer().overwrite(0, m_received_bytes.data(), m_received_bytes.size());
         m_response_object = JS::NonnullGCPtr<JS::Object> { buffer };
+        write_barrier();
     }
     // 6. Otherwise, if this’s response type is "blob", set this’s response object to a new Blob object representing this’s received bytes with type set to the result of get a final MIME type for this.
     else if (m_response_type == Bindings::XMLHttpRequestResponseType::Blob) {
@@ -218,6 +219,7 @@ WebIDL::ExceptionOr<JS::Value> XMLHttpRequest::response()
         auto blob_part = FileAPI::Blob::create(realm(), m_received_bytes, move(mime_type_as_string));
         auto blob = FileAPI::Blob::create(realm(), Vector<FileAPI::BlobPart> { JS::make_handle(*blob_part) });
         m_response_object = JS::NonnullGCPtr<JS::Object> { blob };
+        write_barrier();
     }
     // 7. Otherwise, if this’s response type is "document", set a document response for this.
     else if (m_response_type == Bindings::XMLHttpRequestResponseType::Document) {
@@ -242,6 +244,7 @@ WebIDL::ExceptionOr<JS::Value> XMLHttpRequest::response()
 
         // 4. Set this’s response object to jsonObject.
         m_response_object = JS::NonnullGCPtr<JS::Object> { json_object_result.release_value().as_object() };
+        write_barrier();
     }
 
     // 9. Return this’s response object.
@@ -346,6 +349,7 @@ void XMLHttpRequest::set_document_response()
 
     // 12. Set xhr’s response object to document.
     m_response_object = JS::NonnullGCPtr<JS::Object> { *document };
+    write_barrier();
 }
 
 // https://xhr.spec.whatwg.org/#final-mime-type
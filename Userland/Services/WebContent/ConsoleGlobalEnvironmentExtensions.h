@@ -21,7 +21,11 @@ public:
     virtual void initialize(JS::Realm&) override;
     virtual ~ConsoleGlobalEnvironmentExtensions() override = default;
 
-    void set_most_recent_result(JS::Value result) { m_most_recent_result = move(result); }
+    void set_most_recent_result(JS::Value result)
+    {
+        m_most_recent_result = move(result);
+        write_barrier();
+    }
 
 private:
     virtual void visit_edges(Visitor&) override;
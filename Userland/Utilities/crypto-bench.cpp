@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/OwnPtr.h>
+#include <AK/Random.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCrypto/Authentication/GHash.h>
+#include <LibCrypto/CPUFeatures.h>
+#include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Hash/BLAKE2b.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibCrypto/PK/RSA.h>
+#include <LibMain/Main.h>
+
+using Crypto::Cipher::AESCipher;
+using Crypto::Cipher::Intent;
+
+struct Benchmark {
+    StringView name;
+    // Sets up the cipher for the currently enabled CPU features, and returns the function to be timed.
+    Function<Function<void()>()> prepare;
+};
+
+struct RSABenchmark {
+    StringView name;
+    size_t key_bits;
+    bool sign;
+};
+
+// Returns the number of runs per second.
+static double measure(Function<void()> const& run, Duration duration)
+{
+    size_t iterations = 0;
+    auto timer = Core::ElapsedTimer::start_new();
+    do {
+        run();
+        ++iterations;
+    } while (timer.elapsed_time() < duration);
+
+    auto seconds = static_cast<double>(timer.elapsed_time().to_nanoseconds()) / 1'000'000'000;
+    return static_cast<double>(iterations) / seconds;
+}
+
+// Returns the throughput in MiB/s.
+static double measure_throughput(Function<void()> const& run, size_t buffer_size, Duration duration)
+{
+    return measure(run, duration) * static_cast<double>(buffer_size) / MiB;
+}
+
+template<typename HashFunction>
+static Function<Function<void()>()> hash_benchmark(ByteBuffer const& input)
+{
+    return [&input]() -> Function<void()> {
+        return [&input] {
+            (void)HashFunction::hash(input.data(), input.size());
+        };
+    };
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    size_t buffer_size = 16 * KiB;
+    i64 milliseconds_per_benchmark = 1000;
+    StringView only_benchmark;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Compare the throughput of the portable and hardware-accelerated cipher and hash implementations, and measure RSA operations per second.");
+    args_parser.add_option(buffer_size, "Number of bytes processed per operation (default: 16384)", "size", 's', "bytes");
+    args_parser.add_option(milliseconds_per_benchmark, "Time spent on each measurement (default: 1000)", "time", 't', "milliseconds");
+    args_parser.add_positional_argument(only_benchmark, "Only run the benchmark with this name", "name", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (buffer_size == 0) {
+        warnln("Size must be greater than zero");
+        return 1;
+    }
+
+    auto duration = Duration::from_milliseconds(milliseconds_per_benchmark);
+
+    auto input = TRY(ByteBuffer::create_zeroed(buffer_size));
+    auto output = TRY(ByteBuffer::create_zeroed(buffer_size));
+    auto key = TRY(ByteBuffer::create_zeroed(32));
+    auto iv = TRY(ByteBuffer::create_zeroed(16));
+    auto aad = TRY(ByteBuffer::create_zeroed(13));
+    u8 tag[16];
+
+    auto ctr = [&](size_t key_bits) {
+        return [&, key_bits]() -> Function<void()> {
+            auto cipher = make<AESCipher::CTRMode>(key.bytes().trim(key_bits / 8), key_bits, Intent::Encryption);
+            return [&, cipher = move(cipher)] {
+                auto output_bytes = output.bytes();
+                cipher->encrypt(input, output_bytes, iv);
+            };
+        };
+    };
+
+    auto gcm = [&](size_t key_bits) {
+        return [&, key_bits]() -> Function<void()> {
+            auto cipher = make<AESCipher::GCMMode>(key.bytes().trim(key_bits / 8), key_bits, Intent::Encryption);
+            return [&, cipher = move(cipher)] {
+                cipher->encrypt(input, output.bytes(), iv, aad, { tag, sizeof(tag) });
+            };
+        };
+    };
+
+    auto cbc_decrypt = [&](size_t key_bits) {
+        return [&, key_bits]() -> Function<void()> {
+            auto cipher = make<AESCipher::CBCMode>(key.bytes().trim(key_bits / 8), key_bits, Intent::Decryption, Crypto::Cipher::PaddingMode::Null);
+            return [&, cipher = move(cipher)] {
+                auto output_bytes = output.bytes();
+                cipher->decrypt(input.bytes().trim(buffer_size - buffer_size % 16), output_bytes, iv);
+            };
+        };
+    };
+
+    // Many small independent messages, as when checksumming lots of files.
+    constexpr size_t many_message_count = 16;
+    Vector<ReadonlyBytes> many_messages;
+    for (size_t i = 0; i < many_message_count; ++i)
+        many_messages.append(input.bytes().slice(i * (buffer_size / many_message_count), buffer_size / many_message_count));
+    Vector<Crypto::Hash::SHA256::DigestType> many_digests;
+    many_digests.resize(many_message_count);
+
+    Benchmark benchmarks[] {
+        { "aes-128-ctr"sv, ctr(128) },
+        { "aes-256-ctr"sv, ctr(256) },
+        { "aes-128-gcm"sv, gcm(128) },
+        { "aes-256-gcm"sv, gcm(256) },
+        { "aes-128-cbc-decrypt"sv, cbc_decrypt(128) },
+        { "ghash"sv, [&]() -> Function<void()> {
+             return [&, ghash = Crypto::Authentication::GHash(key.bytes())]() mutable {
+                 (void)ghash.process(aad, input);
+             };
+         } },
+        { "sha1"sv, hash_benchmark<Crypto::Hash::SHA1>(input) },
+        { "sha256"sv, hash_benchmark<Crypto::Hash::SHA256>(input) },
+        { "sha256-many"sv, [&]() -> Function<void()> {
+             return [&] {
+                 Crypto::Hash::SHA256::hash_many(many_messages, many_digests);
+             };
+         } },
+        { "blake2b"sv, hash_benchmark<Crypto::Hash::BLAKE2b>(input) },
+    };
+
+    auto const detected = Crypto::cpu_features();
+    bool has_acceleration = detected.aes || detected.pclmulqdq || detected.sha || detected.avx2;
+    auto yes_or_no = [](bool value) { return value ? "yes"sv : "no"sv; };
+    outln("Hardware support: AES-NI {}, PCLMULQDQ {}, SHA {}, AVX2 {}", yes_or_no(detected.aes), yes_or_no(detected.pclmulqdq), yes_or_no(detected.sha), yes_or_no(detected.avx2));
+
+    bool printed_throughput_header = false;
+    for (auto& benchmark : benchmarks) {
+        if (!only_benchmark.is_empty() && benchmark.name != only_benchmark)
+            continue;
+
+        if (!printed_throughput_header) {
+            outln("{:<20} {:>14} {:>14} {:>8}", "benchmark", "portable MiB/s", "hardware MiB/s", "speedup");
+            printed_throughput_header = true;
+        }
+
+        Crypto::restrict_cpu_features({});
+        auto portable = measure_throughput(benchmark.prepare(), buffer_size, duration);
+
+        if (!has_acceleration) {
+            outln("{:<20} {:>14.1} {:>14} {:>8}", benchmark.name, portable, "-", "-");
+            continue;
+        }
+
+        Crypto::restrict_cpu_features(Crypto::CPUFeatures::all());
+        auto accelerated = measure_throughput(benchmark.prepare(), buffer_size, duration);
+        outln("{:<20} {:>14.1} {:>14.1} {:>7.1}x", benchmark.name, portable, accelerated, accelerated / portable);
+    }
+
+    // Public key operations have no hardware-accelerated implementation, so they are only measured once.
+    RSABenchmark rsa_benchmarks[] {
+        { "rsa-2048-sign"sv, 2048, true },
+        { "rsa-2048-verify"sv, 2048, false },
+        { "rsa-4096-sign"sv, 4096, true },
+        { "rsa-4096-verify"sv, 4096, false },
+    };
+
+    OwnPtr<Crypto::PK::RSA> rsa;
+    size_t rsa_key_bits = 0;
+    bool printed_rsa_header = false;
+    for (auto& benchmark : rsa_benchmarks) {
+        if (!only_benchmark.is_empty() && benchmark.name != only_benchmark)
+            continue;
+
+        if (!printed_rsa_header) {
+            if (printed_throughput_header)
+                outln();
+            outln("{:<20} {:>14}", "benchmark", "operations/s");
+            printed_rsa_header = true;
+        }
+
+        if (rsa_key_bits != benchmark.key_bits) {
+            warnln("Generating a {}-bit RSA key...", benchmark.key_bits);
+            auto key_pair = Crypto::PK::RSA::generate_key_pair(benchmark.key_bits);
+            rsa = make<Crypto::PK::RSA>(key_pair.public_key, key_pair.private_key);
+            rsa_key_bits = benchmark.key_bits;
+        }
+
+        // Any number smaller than the modulus will do, it doesn't have to be a valid padded message or signature.
+        auto message = TRY(ByteBuffer::create_uninitialized(benchmark.key_bits / 8 - 1));
+        fill_with_random(message);
+        auto result = TRY(ByteBuffer::create_zeroed(benchmark.key_bits / 8));
+
+        auto operations_per_second = measure([&] {
+            auto result_bytes = result.bytes();
+            if (benchmark.sign)
+                rsa->sign(message, result_bytes);
+            else
+                rsa->verify(message, result_bytes);
+        },
+            duration);
+        outln("{:<20} {:>14.1}", benchmark.name, operations_per_second);
+    }
+
+    return 0;
+}
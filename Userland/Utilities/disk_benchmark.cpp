@@ -5,8 +5,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/ByteBuffer.h>
 #include <AK/ByteString.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -15,6 +18,7 @@
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -40,6 +44,7 @@ static Result average_result(Vector<Result> const& results)
 }
 
 static ErrorOr<Result> benchmark(ByteString const& filename, int file_size, ByteBuffer& buffer, bool allow_cache);
+static ErrorOr<void> random_read_benchmark(ByteString const& filename, size_t file_size, size_t block_size, size_t thread_count, size_t queue_depth, bool allow_cache, Duration duration);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -50,6 +55,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<size_t> file_sizes;
     Vector<size_t> block_sizes;
     bool allow_cache = false;
+    size_t queue_depth = 0;
+    size_t thread_count = 0;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(allow_cache, "Allow using disk cache", "cache", 'c');
@@ -57,8 +64,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(time_per_benchmark_sec, "Time elapsed per benchmark (seconds)", "time-per-benchmark", 't', "time-per-benchmark");
     args_parser.add_option(file_sizes, "A comma-separated list of file sizes", "file-size", 'f', "file-size");
     args_parser.add_option(block_sizes, "A comma-separated list of block sizes", "block-size", 'b', "block-size");
+    args_parser.add_option(queue_depth, "Measure random reads, with this many requests in flight per thread", "qd", 0, "depth");
+    args_parser.add_option(thread_count, "Measure random reads from this many threads", "threads", 0, "count");
     args_parser.parse(arguments);
 
+    bool measure_random_reads = queue_depth > 0 || thread_count > 0;
+    if (measure_random_reads) {
+        queue_depth = max<size_t>(queue_depth, 1);
+        thread_count = max<size_t>(thread_count, 1);
+    }
+
     Duration const time_per_benchmark = Duration::from_seconds(time_per_benchmark_sec);
 
     if (file_sizes.size() == 0) {
@@ -75,6 +90,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             if (block_size > file_size)
                 continue;
 
+            if (measure_random_reads) {
+                outln("Running: file_size={} block_size={} threads={} qd={}", file_size, block_size, thread_count, queue_depth);
+                TRY(random_read_benchmark(filename, file_size, block_size, thread_count, queue_depth, allow_cache, time_per_benchmark));
+                sleep(1);
+                continue;
+            }
+
             auto buffer_result = ByteBuffer::create_uninitialized(block_size);
             if (buffer_result.is_error()) {
                 warnln("Not enough memory to allocate space for block size = {}", block_size);
@@ -143,3 +165,96 @@ ErrorOr<Result> benchmark(ByteString const& filename, int file_size, ByteBuffer&
     result.read_bps = (u64)(timer.elapsed_milliseconds() ? (file_size / timer.elapsed_milliseconds()) : file_size) * 1000;
     return result;
 }
+
+ErrorOr<void> random_read_benchmark(ByteString const& filename, size_t file_size, size_t block_size, size_t thread_count, size_t queue_depth, bool allow_cache, Duration duration)
+{
+    int flags = O_CREAT | O_TRUNC | O_RDWR;
+    if (!allow_cache)
+        flags |= O_DIRECT;
+
+    int fd = TRY(Core::System::open(filename, flags, 0644));
+    auto fd_cleanup = ScopeGuard([fd, filename] {
+        if (auto result = Core::System::close(fd); result.is_error())
+            warnln("{}", result.error());
+        if (auto result = Core::System::unlink(filename); result.is_error())
+            warnln("{}", result.error());
+    });
+
+    auto buffer = TRY(ByteBuffer::create_zeroed(block_size));
+    size_t block_count = file_size / block_size;
+    for (size_t i = 0; i < block_count; ++i)
+        TRY(Core::System::write(fd, buffer));
+    if (fsync(fd) < 0)
+        return Error::from_syscall("fsync"sv, -errno);
+
+    // NOTE: There is no asynchronous I/O, so every request in flight gets its own thread doing blocking reads.
+    struct Worker {
+        pthread_t thread;
+        int fd { -1 };
+        size_t block_size { 0 };
+        size_t block_count { 0 };
+        Atomic<bool>* should_stop { nullptr };
+        Vector<u64> latencies_in_microseconds;
+        int error { 0 };
+    };
+    Vector<Worker> workers;
+    TRY(workers.try_resize(thread_count * queue_depth));
+    Atomic<bool> should_stop { false };
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& worker : workers) {
+        worker.fd = fd;
+        worker.block_size = block_size;
+        worker.block_count = block_count;
+        worker.should_stop = &should_stop;
+        int rc = pthread_create(&worker.thread, nullptr, [](void* argument) -> void* {
+            auto& worker = *static_cast<Worker*>(argument);
+            auto buffer = ByteBuffer::create_uninitialized(worker.block_size).release_value_but_fixme_should_propagate_errors();
+            while (!worker.should_stop->load(AK::memory_order_relaxed)) {
+                auto offset = static_cast<off_t>(AK::get_random_uniform_64(worker.block_count) * worker.block_size);
+                auto start = MonotonicTime::now();
+                if (pread(worker.fd, buffer.data(), buffer.size(), offset) < 0) {
+                    worker.error = errno;
+                    break;
+                }
+                worker.latencies_in_microseconds.append((MonotonicTime::now() - start).to_microseconds());
+            }
+            return nullptr;
+        },
+            &worker);
+        if (rc != 0) {
+            should_stop.store(true, AK::memory_order_relaxed);
+            for (auto& started_worker : workers.span().trim(&worker - workers.data()))
+                pthread_join(started_worker.thread, nullptr);
+            return Error::from_errno(rc);
+        }
+    }
+
+    usleep(duration.to_microseconds());
+    should_stop.store(true, AK::memory_order_relaxed);
+
+    Vector<u64> latencies;
+    for (auto& worker : workers)
+        pthread_join(worker.thread, nullptr);
+    for (auto& worker : workers) {
+        if (worker.error != 0)
+            return Error::from_syscall("pread"sv, -worker.error);
+        TRY(latencies.try_extend(worker.latencies_in_microseconds));
+    }
+    auto elapsed_milliseconds = max(timer.elapsed_milliseconds(), 1);
+
+    if (latencies.is_empty()) {
+        outln("Finished: no reads completed");
+        return {};
+    }
+    quick_sort(latencies);
+    u64 total_latency = 0;
+    for (auto latency : latencies)
+        total_latency += latency;
+
+    auto iops = latencies.size() * 1000 / elapsed_milliseconds;
+    outln("Finished: reads={} time={}ms iops={} read_bps={} latency_avg={}us latency_p50={}us latency_p99={}us latency_max={}us",
+        latencies.size(), elapsed_milliseconds, iops, iops * block_size,
+        total_latency / latencies.size(), latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.last());
+    return {};
+}
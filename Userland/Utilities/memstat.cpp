@@ -45,6 +45,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     u64 physical_uncommitted = json.get_u64("physical_uncommitted"sv).value_or(0);
     u32 kmalloc_call_count = json.get_u32("kmalloc_call_count"sv).value_or(0);
     u32 kfree_call_count = json.get_u32("kfree_call_count"sv).value_or(0);
+    u64 huge_pages_mapped = json.get_u64("huge_pages_mapped"sv).value_or(0);
+    u64 huge_page_allocations = json.get_u64("huge_page_allocations"sv).value_or(0);
+    u64 huge_page_allocation_failures = json.get_u64("huge_page_allocation_failures"sv).value_or(0);
+    u64 huge_page_splits = json.get_u64("huge_page_splits"sv).value_or(0);
 
     u64 kmalloc_bytes_total = kmalloc_allocated + kmalloc_available;
     u64 physical_pages_total = physical_allocated + physical_available;
@@ -66,5 +70,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     outln("Kmalloc call count: {}", kmalloc_call_count);
     outln("Kfree call count: {}", kfree_call_count);
     outln("Kmalloc/Kfree delta: {}", TRY(String::formatted("{:+}", kmalloc_call_count - kfree_call_count)));
+    outln("Huge pages (mapped) count: {}", huge_pages_mapped);
+    outln("Huge page allocations: {} ({} failed)", huge_page_allocations, huge_page_allocation_failures);
+    outln("Huge page splits: {}", huge_page_splits);
+
+    if (auto per_processor_stats = json.get_array("kmalloc_per_processor"sv); per_processor_stats.has_value()) {
+        for (size_t processor_id = 0; processor_id < per_processor_stats->size(); ++processor_id) {
+            auto const& processor_stats = per_processor_stats->at(processor_id).as_object();
+            outln("CPU #{} kmalloc/kfree calls: {}/{}, magazine hits: {}, refills: {}, drains: {}, cached bytes: {}", processor_id,
+                processor_stats.get_u64("kmalloc_call_count"sv).value_or(0),
+                processor_stats.get_u64("kfree_call_count"sv).value_or(0),
+                processor_stats.get_u64("magazine_hits"sv).value_or(0),
+                processor_stats.get_u64("magazine_refills"sv).value_or(0),
+                processor_stats.get_u64("magazine_drains"sv).value_or(0),
+                processor_stats.get_u64("cached_bytes"sv).value_or(0));
+        }
+    }
     return 0;
 }